@@ -25,6 +25,7 @@
 #define COMMANDRECEIVER_H_
 
 #include "IAmCommand.h"
+#include <map>
 
 namespace am
 {
@@ -71,7 +72,7 @@ public:
     am_Error_e setMainSinkNotificationConfiguration(const am_sinkID_t sinkID, const am_NotificationConfiguration_s &mainNotificationConfiguration);
     am_Error_e setMainSourceNotificationConfiguration(const am_sourceID_t sourceID, const am_NotificationConfiguration_s &mainNotificationConfiguration);
 
-    uint16_t getStartupHandle(); //!< returns a startup handle
+    uint16_t getStartupHandle(const std::string &name); //!< returns a startup handle, the name is used by the startup profiler
     uint16_t getRundownHandle(); //!< returns a rundown handle
 
     void waitOnStartup(bool startup); //!< tells the ComandReceiver to start waiting for all handles to be confirmed
@@ -85,6 +86,8 @@ private:
 
     uint16_t              handleCount;         //!< counts all handles
     std::vector<uint16_t> mListStartupHandles; //!< list of handles that wait for a confirm
+    std::map<uint16_t, uint32_t> mStartupPhases; //!< the profiler phases of the handles that wait for a confirm
+    uint32_t              mReadyPhase;         //!< the profiler phase from the first startup handle to the last confirm
     std::vector<uint16_t> mListRundownHandles; //!< list of handles that wait for a confirm
     bool                  mWaitStartup;        //!< if true confirmation will be sent if list of handles = 0
     bool                  mWaitRundown;        //!< if true confirmation will be sent if list of handles = 0
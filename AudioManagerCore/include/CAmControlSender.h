@@ -105,6 +105,7 @@ public:
     am_Error_e hookUserSetMainSinkNotificationConfiguration(const am_sinkID_t sinkID, const am_NotificationConfiguration_s &notificationConfiguration);
     am_Error_e hookUserSetMainSourceNotificationConfiguration(const am_sourceID_t sourceID, const am_NotificationConfiguration_s &notificationConfiguration);
     void hookSystemSingleTimingInformationChanged(const am_connectionID_t connectionID, const am_timeSync_t time);
+    void cbHandleTimeout(const am_Handle_s handle);
 
     void receiverCallback(const pollfd pollfd, const sh_pollHandle_t handle, void *userData);
     bool checkerCallback(const sh_pollHandle_t handle, void *userData);
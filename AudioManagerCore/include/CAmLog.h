@@ -32,18 +32,34 @@
 #include <stdlib.h>
 #include <sstream>
 #include <assert.h>
+#include <stdint.h>
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
 
 /**
  * Implements a basic logging mechanism that can be used to print debug information into a file or to the console.
  * It can be used either as singleton through the appropriate method getDefaultLog() or as independent instantiated object.
  * The default initializer sets the console as output for newly created objects.
  * Example: CAmLogger << "Text"; //to print out through the singleton object directly to the console
+ *
+ * The text is not written by the caller. Each thread stages its text until a line is complete, the complete lines are
+ * appended to a shared buffer and a background thread writes the buffer when it reaches the flush size or when the
+ * flush interval elapsed. So a big dump does not make the caller wait for the console or the file.
+ * A flush size of 0 writes each line at once, like the stream did before. flush() writes everything that was
+ * logged so far, including the incomplete line of the calling thread.
  */
 
 #define DEFAULT_LOG_FOLDER     "/tmp/"
 #define DEFAULT_LOGFILE_PREFIX "am_dump_"
 #define DEFAULT_LOGFILE_EXT    ".log"
 
+#define DEFAULT_LOG_FLUSH_SIZE     4096
+#define DEFAULT_LOG_FLUSH_INTERVAL 100
+
 #define DEL(aPointer) delete aPointer, aPointer = NULL
 
 /* */
@@ -59,36 +75,89 @@ private:
     {
     protected:
         std::ostream *mOutputStream;
+
+        /**
+         * writes what is buffered, including the incomplete line of the calling thread, and stops the background
+         * thread. The derived classes call it before they close the stream.
+         */
+        void stop();
+
     public:
-        CAmLogger ()
-            : mOutputStream(NULL) {}
-        virtual ~CAmLogger () { }
-        virtual void log(const std::string &_s)
-        {
-            (*mOutputStream) << _s;
-            mOutputStream->flush();
-        }
+        CAmLogger();
+        virtual ~CAmLogger();
+
+        /**
+         * appends text that is complete, it is not staged
+         */
+        virtual void log(const std::string &_s);
+
+        /**
+         * @param flushSize the buffered bytes that wake up the background thread, 0 writes each line at once
+         * @param flushInterval the time in ms after which buffered text is written at the latest
+         */
+        void setFlushPolicy(const size_t flushSize, const unsigned flushInterval);
+        void flush();
 
         template <class T>
         CAmLogger &operator <<(const T &t)
         {
-            (*mOutputStream) << t;
+            std::ostringstream &formatter(getFormatter());
+            formatter.str(std::string());
+            formatter << t;
+            stage(formatter.str());
+            return (*this);
+        }
+
+        CAmLogger &operator <<(std::ostream &(*manipulator)(std::ostream &))
+        {
+            std::ostringstream &formatter(getFormatter());
+            formatter.str(std::string());
+            manipulator(formatter);
+            stage(formatter.str());
             return (*this);
         }
 
+    private:
+        struct staging_s //!< the incomplete line of a thread, it belongs to one logger at a time
+        {
+            uint64_t    logger;
+            std::string text;
+        };
+
+        static std::ostringstream &getFormatter();
+        static std::mutex &getLoggersMutex();
+        static std::map<uint64_t, CAmLogger *> &getLoggers();
+        static staging_s &getThreadStaging();
+        std::string &getStaging();
+        void stage(const std::string &text);
+        void commit(std::string &staging, const size_t length);
+        void writeBuffer();
+        void flushThread();
+
+        const uint64_t            mID;           //!< identifies the owner of the staging buffers in the threads
+        std::mutex                mMutex;        //!< protects the buffer and the policy
+        std::mutex                mWriteMutex;   //!< keeps the writes to the stream in order
+        std::condition_variable   mCondition;
+        std::string               mBuffer;       //!< the complete lines that are not written yet
+        std::thread               mThread;
+        bool                      mStop;
+        size_t                    mFlushSize;
+        std::chrono::milliseconds mFlushInterval;
     };
 
     class CAmFileLogger : public CAmLogger
     {
-        std::string mFilename;
+        std::string   mFilename;
+        std::ofstream mFile;
     public:
         static void generateLogFilename(std::string &result);
 
         explicit CAmFileLogger(const std::string &_s)
             : CAmLogger()
+            , mFilename(_s)
+            , mFile(_s.c_str())
         {
-            mFilename     = _s;
-            mOutputStream = new std::ofstream(mFilename.c_str());
+            mOutputStream = &mFile;
         }
 
         ~CAmFileLogger();
@@ -102,11 +171,14 @@ private:
             mOutputStream = &std::cout;
         }
 
+        ~CAmStdOutLogger();
     };
 
 private:
     eCAmLogType mLogType;
     CAmLogger  *mLogger;
+    size_t      mFlushSize;
+    unsigned    mFlushInterval;
 
 protected:
     void releaseLogger();
@@ -122,6 +194,16 @@ public:
     void setLogType(const eCAmLogType type);
     eCAmLogType getLogType() const;
 
+    /**
+     * sets when the buffered text is written, see CAmLogger::setFlushPolicy. The policy is kept when the type changes.
+     */
+    void setFlushPolicy(const size_t flushSize, const unsigned flushInterval);
+
+    /**
+     * writes all text that was logged so far and waits until it is written
+     */
+    void flush();
+
     template <class T>
     CAmLog &operator <<(const T &t)
     {
@@ -130,6 +212,13 @@ public:
         return (*this);
     }
 
+    CAmLog &operator <<(std::ostream &(*manipulator)(std::ostream &))
+    {
+        assert(mLogger != NULL);
+        (*mLogger) << manipulator;
+        return (*this);
+    }
+
 };
 
 #define CAmLogger (*CAmLog::getDefaultLog())
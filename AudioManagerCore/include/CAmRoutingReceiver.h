@@ -25,6 +25,8 @@
 #define ROUTINGRECEIVER_H_
 
 #include "IAmRouting.h"
+#include "CAmSocketHandler.h"
+#include <map>
 
 namespace am
 {
@@ -98,15 +100,33 @@ public:
     am_Error_e getDomainOfSource(const am_sourceID_t sourceID, am_domainID_t &domainID) const;
     am_Error_e getDomainOfCrossfader(const am_crossfaderID_t crossfader, am_domainID_t &domainID) const;
 
-    uint16_t getStartupHandle(); //!< returns a startup handle
+    uint16_t getStartupHandle(const std::string &name); //!< returns a startup handle, the name is used by the startup profiler
     uint16_t getRundownHandle(); //!< returns a rundown handle
 
     void waitOnStartup(bool startup); //!< tells the RoutingReceiver to start waiting for all handles to be confirmed
     void waitOnRundown(bool rundown); //!< tells the RoutingReceiver to start waiting for all handles to be confirmed
 
+    void handleTimeout(const am_Handle_s handle); //!< tells the controller that the handle was aborted because its timeout is over
+
+    /**
+     * With an interval, the volume ticks of a sink or source are forwarded to the controller at most once per interval,
+     * with the latest volume. The waiting tick of a ramp is forwarded before the acknowledge of the ramp.
+     * @param interval in ms, 0 forwards every tick when it comes (default)
+     */
+    void setVolumeTickInterval(const uint32_t interval);
+
 private:
+    struct volumeTick_s //!< the latest tick of a sink or source that waits to be forwarded
+    {
+        am_Handle_s handle; //!< the handle the controller knows
+        am_Handle_s part;   //!< the handle of the routing plugin, the part of a batch of volumes
+        am_volume_t volume;
+    };
 
     void handleCallback(const am_Handle_s handle, const am_Error_e error);
+    void startVolumeTickTimer();                                        //!< starts the timer when the first tick waits
+    void flushVolumeTicks(const am_Handle_s handle);                    //!< forwards the waiting ticks of the handle
+    void volumeTickTimer(const sh_timerHandle_t handle, void *userData); //!< forwards all waiting ticks
 
     IAmDatabaseHandler   *mpDatabaseHandler; //!< pointer to the databaseHandler
     CAmRoutingSender     *mpRoutingSender;   //!< pointer to the routingSender
@@ -115,6 +135,8 @@ private:
     CAmDbusWrapper       *mpDBusWrapper;     //!< pointer to dbuswrapper
 
     std::vector<uint16_t> mListStartupHandles; //!< list of handles that wait for a confirm
+    std::map<uint16_t, uint32_t> mStartupPhases; //!< the profiler phases of the handles that wait for a confirm
+    uint32_t              mReadyPhase;         //!< the profiler phase from the first startup handle to the last confirm
     std::vector<uint16_t> mListRundownHandles; //!< list of handles that wait for a confirm
     uint16_t              handleCount;         //!< counts all handles
     bool                  mWaitStartup;        //!< if true confirmation will be sent if list of handles = 0
@@ -123,6 +145,11 @@ private:
     am_Error_e            mLastStartupError;
     am_Error_e            mLastRundownError;
 
+    uint32_t                              mVolumeTickInterval; //!< in ms, 0 if the ticks are not throttled
+    sh_timerHandle_t                      mVolumeTickTimer;    //!< the one timer that forwards the ticks, 0 before it is created
+    std::map<am_sinkID_t, volumeTick_s>   mSinkVolumeTicks;    //!< the ticks that wait, by sink
+    std::map<am_sourceID_t, volumeTick_s> mSourceVolumeTicks;  //!< the ticks that wait, by source
+
 };
 
 }
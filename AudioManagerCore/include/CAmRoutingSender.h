@@ -25,6 +25,8 @@
 #define ROUTINGSENDER_H_
 
 #include "IAmRouting.h"
+#include "CAmSocketHandler.h"
+#include <array>
 #include <map>
 #include <memory>
 
@@ -82,6 +84,24 @@ public:
     am_Error_e asyncSetSourceNotificationConfiguration(am_Handle_s &handle, const am_sourceID_t sourceID, const am_NotificationConfiguration_s &notificationConfiguration);
     am_Error_e resyncConnectionState(const am_domainID_t domainID, std::vector<am_Connection_s> &listOfExistingConnections);
 
+    /**
+     * sets the time a routing plugin has to acknowledge the actions of a type. When it is over, the action is aborted,
+     * the handle is removed and the controller gets cbHandleTimeout.
+     * @param type the type of the handles
+     * @param timeout in ms, 0 switches the supervision off (default)
+     * @return E_OK or E_OUT_OF_RANGE if the type is not valid
+     */
+    am_Error_e setHandleTimeout(const am_Handle_e type, const uint32_t timeout);
+
+    /**
+     * With coalescing, a sink or source has at most one volume change at the routing plugin. A change that comes while
+     * one is running waits, a newer change replaces the waiting one and gets the same handle. The waiting change is sent
+     * when the running one is acknowledged or removed, its timeout starts then. Aborting the waiting change
+     * acknowledges it with E_ABORTED without involving the routing plugin.
+     * @param enable false by default
+     */
+    void setVolumeCoalescing(const bool enable);
+
     struct InterfaceNamePairs //!< is used to pair interfaces with busnames
     {
         IAmRoutingSend *routingInterface; //!< pointer to the routingInterface
@@ -97,6 +117,13 @@ public:
         virtual ~handleDataBase() {}
         virtual am_Error_e writeDataToDatabase() = 0;   //!< function to write the handle data to the database
 
+        /**
+         * the handle data of all types comes from a pool of equally sized blocks, an async operation does not
+         * allocate from the heap for it
+         */
+        static void *operator new(std::size_t size);
+        static void operator delete(void *pData, std::size_t size);
+
         IAmRoutingSend *returnInterface() {return mInterface;}
     private:
         IAmRoutingSend     *mInterface;
@@ -112,6 +139,7 @@ public:
             , mVolume(volume) {}
         virtual ~handleVolumeBase(){}
         am_volume_t returnVolume() { return mVolume; }
+        void setVolume(const am_volume_t volume) { mVolume = volume; }
     private:
         am_volume_t mVolume;
     };
@@ -199,6 +227,7 @@ public:
             , mSourceID(sourceID) {}
         ~handleSourceVolume() {}
         am_Error_e writeDataToDatabase();
+        am_sourceID_t returnSourceID() const { return mSourceID; }
 
     private:
         am_sourceID_t mSourceID;
@@ -212,6 +241,7 @@ public:
             , mSinkID(sinkID) {}
         ~handleSinkVolume() {}
         am_Error_e writeDataToDatabase();
+        am_sinkID_t returnSinkID() const { return mSinkID; }
 
     private:
         am_sinkID_t mSinkID;
@@ -262,17 +292,35 @@ public:
         CAmRoutingSender *mRoutingSender;
     };
 
+    /**
+     * The volumes of one interface, or a batch of volumes that belong to several interfaces. A batch has no interface,
+     * each interface gets a part with a handle of its own that refers to the batch.
+     */
     class handleSetVolumes : public handleDataBase
     {
     public:
-        handleSetVolumes(IAmRoutingSend *interface, const std::vector<am_Volumes_s> listVolumes, IAmDatabaseHandler *databaseHandler)
+        handleSetVolumes(IAmRoutingSend *interface, const std::vector<am_Volumes_s> listVolumes, IAmDatabaseHandler *databaseHandler, const am_Handle_s batch = am_Handle_s())
             : handleDataBase(interface, databaseHandler)
-            , mlistVolumes(listVolumes) {}
+            , mlistVolumes(listVolumes)
+            , mBatch(batch)
+            , mOpenParts(0)
+            , mError(E_OK)
+            , mlistAckedVolumes() {}
         ~handleSetVolumes() {}
         am_Error_e writeDataToDatabase();
 
+        am_Handle_s returnBatch() const { return mBatch; }
+        am_Error_e returnError() const { return mError; }
+        const std::vector<am_Volumes_s> &returnAckedVolumes() const { return mlistAckedVolumes; }
+        void expectParts(const uint16_t numberOfParts) { mOpenParts = numberOfParts; }
+        bool ackPart(const std::vector<am_Volumes_s> &listVolumes, const am_Error_e error); //!< returns true if it was the last part
+
     private:
         std::vector<am_Volumes_s> mlistVolumes;
+        am_Handle_s               mBatch;            //!< the batch of a part, handle 0 if the volumes are not a part
+        uint16_t                  mOpenParts;        //!< the parts of a batch that are not acknowledged
+        am_Error_e                mError;            //!< the first error a part of the batch reported
+        std::vector<am_Volumes_s> mlistAckedVolumes; //!< the volumes the parts of the batch acknowledged
     };
 
     class handleSetSinkNotificationConfiguration : public handleDataBase
@@ -306,45 +354,150 @@ public:
     };
 
     am_Error_e writeToDatabaseAndRemove(const am_Handle_s handle); //!< write data to Database and remove handle
+
+    /**
+     * removes the handle of acknowledged volumes and writes them to the database. If the volumes are a part of a batch,
+     * the acknowledge is collected in the batch.
+     * @param handle is replaced by the batch when its last part is acknowledged
+     * @param listVolumes is replaced by the volumes of all parts of the batch
+     * @param error is replaced by the first error of the parts
+     * @return true if the controller has to get the acknowledge, false if parts of the batch are still open
+     */
+    bool ackSetVolumes(am_Handle_s &handle, std::vector<am_Volumes_s> &listVolumes, am_Error_e &error);
+    am_Handle_s returnControllerHandle(const am_Handle_s handle) const; //!< returns the batch of a part of a batch, otherwise the handle itself
     void checkVolume(const am_Handle_s handle, const am_volume_t volume);
     bool handleExists(const am_Handle_s handle); //!< returns true if the handle exists
 
+    /**
+     * The number of a handle that timed out is kept off the free list for a while, so an acknowledge that the plugin
+     * sends late cannot be taken for a new handle. Such an acknowledge is dropped, it ends the quarantine.
+     * @return true if the acknowledge of the handle has to be dropped
+     */
+    bool dropLateAcknowledge(const am_Handle_s handle);
+
 #ifdef UNIT_TEST // this is needed to test RoutingSender
     friend class IAmRoutingBackdoor;
 #endif
 
 private:
-    struct comparator //!< is needed to sort the handles in the map
+    static const uint16_t MAX_HANDLES = 1024; //!< defined by the 10 bit of am_Handle_s::handle, 0 is no handle
+
+    /**
+     * a slot of the handle table, the index is the handle number. A number is only given to one handle at a time,
+     * so the type is stored in the slot and is compared on the lookup.
+     */
+    struct handleSlot_s
     {
-        bool operator()(const am_Handle_s &a, const am_Handle_s &b) const
+        std::unique_ptr<handleDataBase> data;       //!< NULL while the slot is free
+        am_Handle_e                     type;       //!< the type of the handle that uses the slot
+        uint16_t                        generation; //!< counts the handles that used the slot
+        uint16_t                        nextFree;   //!< the next slot in the free list, 0 at the end
+        bool                            quarantined; //!< the handle timed out, the number is not used until its late acknowledge or the quarantine is over
+    };
+
+    static const uint16_t HANDLE_WHEEL_SLOTS = 64;  //!< the slots of the timeout wheel
+    static const uint32_t HANDLE_WHEEL_TICK  = 100; //!< the time in ms one slot of the timeout wheel covers
+    static const uint32_t HANDLE_QUARANTINE  = 10000; //!< the time in ms the number of a handle that timed out is not used
+
+    /**
+     * maps the 16 bit IDs of one kind of element to the interface of their domain, the lookup is one indexed load.
+     * The table is split into pages of 256 IDs that are allocated when the first ID of the page is added, so an
+     * empty table does not cost the whole ID range.
+     */
+    class interfaceTable
+    {
+    public:
+        IAmRoutingSend *find(const uint16_t id) const //!< returns NULL if the ID is not in the table
+        {
+            const interfacePage_t *pPage(mPages[id >> PAGE_BITS].get());
+            return ((pPage != NULL) ? (*pPage)[id & PAGE_MASK] : NULL);
+        }
+
+        void insert(const uint16_t id, IAmRoutingSend *routingInterface)
         {
-            return (a.handle < b.handle || (a.handle == b.handle && a.handleType < b.handleType));
+            std::unique_ptr<interfacePage_t> &pPage(mPages[id >> PAGE_BITS]);
+            if (!pPage)
+            {
+                pPage.reset(new interfacePage_t());
+            }
+
+            (*pPage)[id & PAGE_MASK] = routingInterface;
         }
 
+        bool erase(const uint16_t id) //!< returns false if the ID was not in the table
+        {
+            interfacePage_t *pPage(mPages[id >> PAGE_BITS].get());
+            if ((pPage == NULL) || ((*pPage)[id & PAGE_MASK] == NULL))
+            {
+                return (false);
+            }
+
+            (*pPage)[id & PAGE_MASK] = NULL;
+            return (true);
+        }
+
+    private:
+        static const uint16_t PAGE_BITS = 8;
+        static const uint16_t PAGE_MASK = (1 << PAGE_BITS) - 1;
+        typedef std::array<IAmRoutingSend *, 1 << PAGE_BITS> interfacePage_t;
+
+        std::unique_ptr<interfacePage_t> mPages[1 << (16 - PAGE_BITS)]; //!< NULL until an ID of the page is added
+    };
+
+    struct handleTimeout_s //!< a supervised handle in the timeout wheel
+    {
+        uint16_t handle;     //!< the number of the handle
+        uint16_t generation; //!< the generation of the handle slot, the entry is stale if it changed
+        uint32_t rounds;     //!< the turns of the wheel that are left before the handle expires
+        bool     quarantine; //!< the entry ends the quarantine of the number instead of supervising a handle
+    };
+
+    struct volumeCoalescing_s //!< the volume changes of a sink or source
+    {
+        am_Handle_s         inFlight; //!< the change the routing plugin works on, handle 0 if there is none
+        am_Handle_s         pending;  //!< the change that waits, handle 0 if there is none
+        am_CustomRampType_t ramp;     //!< the ramp of the waiting change
+        am_time_t           time;     //!< the ramp time of the waiting change
     };
 
     void loadPlugins(const std::vector<std::string> &listOfPluginDirectories);
-    am_Handle_s createHandle(std::shared_ptr<handleDataBase> handleData, const am_Handle_e type); //!< creates a handle
-    void unloadLibraries(void);                                                                   //!< unloads all loaded plugins
-
-    typedef std::map<am_domainID_t, IAmRoutingSend *>                          DomainInterfaceMap;     //!< maps domains to interfaces
-    typedef std::map<am_sinkID_t, IAmRoutingSend *>                            SinkInterfaceMap;       //!< maps sinks to interfaces
-    typedef std::map<am_sourceID_t, IAmRoutingSend *>                          SourceInterfaceMap;     //!< maps sources to interfaces
-    typedef std::map<am_crossfaderID_t, IAmRoutingSend *>                      CrossfaderInterfaceMap; //!< maps crossfaders to interfaces
-    typedef std::map<am_connectionID_t, IAmRoutingSend *>                      ConnectionInterfaceMap; //!< maps connections to interfaces
-    typedef std::map<am_Handle_s, std::shared_ptr<handleDataBase>, comparator> HandlesMap;             //!< maps handleData to handles
-
-    int16_t                         mHandleCount;            //!< is used to create handles
-    HandlesMap                      mlistActiveHandles;      //!< list of all currently "running" handles.
+    bool isVolumeInFlight(const volumeCoalescing_s &coalescing) const;                //!< returns true if a change has to wait
+    am_Error_e queueVolume(volumeCoalescing_s &coalescing, handleVolumeBase *handleData, const am_Handle_e type, const am_CustomRampType_t ramp, const am_time_t time, am_Handle_s &handle);
+    void releaseVolume(const am_Handle_s handle, handleDataBase *handleData);       //!< sends the waiting change when the running one is done
+    volumeCoalescing_s *findCoalescing(const am_Handle_s handle, handleDataBase *handleData); //!< returns NULL if the handle is no volume change
+    bool abortWaitingVolume(const am_Handle_s handle);                              //!< acknowledges a waiting change as aborted
+    void superviseHandle(const am_Handle_s handle);                                 //!< puts the handle into the timeout wheel
+    void addWheelEntry(const uint16_t handle, const uint32_t timeout, const bool quarantine); //!< starts the timer with the first entry
+    void freeHandle(const am_Handle_s handle, const bool quarantine);              //!< destroys the data of an open handle
+    void appendFreeSlot(const uint16_t handle);                                    //!< puts the number at the end of the free list
+    void handleWheelTick(const sh_timerHandle_t handle, void *userData);            //!< aborts the handles of the next slot that expired
+    am_Handle_s createHandle(handleDataBase *handleData, const am_Handle_e type, const bool supervised = true); //!< creates a handle, takes the ownership of the data
+    handleDataBase *findHandle(const am_Handle_s handle) const;                   //!< returns NULL if the handle is not open
+    std::vector<am_Handle_s> getBatchParts(const am_Handle_s handle) const;       //!< returns the open parts if the handle is a batch of volumes
+    void unloadLibraries(void);                                                   //!< unloads all loaded plugins
+
+    handleSlot_s                    mHandleSlots[MAX_HANDLES]; //!< all currently "running" handles, indexed by the handle
+    uint16_t                        mFirstFreeHandle;          //!< the free slot that is used next, 0 if all are used
+    uint16_t                        mLastFreeHandle;           //!< released slots are appended here, so the numbers are used round robin
+    uint16_t                        mNumberOfHandles;          //!< the number of open handles
+    uint32_t                        mHandleTimeouts[H_MAX];    //!< the timeout in ms per handle type, 0 if not supervised
+    std::vector<handleTimeout_s>    mHandleWheel[HANDLE_WHEEL_SLOTS]; //!< the supervised handles by the slot they expire in
+    uint16_t                        mHandleWheelPosition;      //!< the slot of the wheel that expired last
+    uint32_t                        mNumberOfSupervisedHandles; //!< the entries of the wheel, the timer stops at 0
+    sh_timerHandle_t                mHandleWheelTimer;         //!< the one timer that turns the wheel, 0 before it is created
+    bool                            mVolumeCoalescing;         //!< true if volume changes are coalesced
+    std::map<am_sinkID_t, volumeCoalescing_s>   mMapSinkVolumes;   //!< the volume changes per sink
+    std::map<am_sourceID_t, volumeCoalescing_s> mMapSourceVolumes; //!< the volume changes per source
     std::vector<void *>             mListLibraryHandles;     //!< list of all loaded pluginInterfaces
     std::vector<InterfaceNamePairs> mListInterfaces;         //!< list of busname/interface relation
-    CrossfaderInterfaceMap          mMapCrossfaderInterface; //!< map of crossfaders to interface
-    ConnectionInterfaceMap          mMapConnectionInterface; //!< map of connection to interfaces
-    DomainInterfaceMap              mMapDomainInterface;     //!< map of domains to interfaces
-    SinkInterfaceMap                mMapSinkInterface;       //!< map of sinks to interfaces
-    SourceInterfaceMap              mMapSourceInterface;     //!< map of sources to interfaces
+    interfaceTable                  mCrossfaderInterfaces;   //!< the interfaces of the crossfaders
+    interfaceTable                  mConnectionInterfaces;   //!< the interfaces of the connections
+    interfaceTable                  mDomainInterfaces;       //!< the interfaces of the domains
+    interfaceTable                  mSinkInterfaces;         //!< the interfaces of the sinks
+    interfaceTable                  mSourceInterfaces;       //!< the interfaces of the sources
     CAmRoutingReceiver             *mpRoutingReceiver;       //!< pointer to routing receiver
     IAmDatabaseHandler             *mpDatabaseHandler;       //!< pointer to the databaseHandler
+    CAmSocketHandler               *mpSocketHandler;         //!< runs the timer of the timeout wheel, known after startupInterfaces
 };
 
 }
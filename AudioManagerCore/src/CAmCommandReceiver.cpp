@@ -28,6 +28,7 @@
 #include "CAmControlSender.h"
 #include "CAmDltWrapper.h"
 #include "CAmSocketHandler.h"
+#include "CAmStartupProfiler.h"
 
 #define __METHOD_NAME__ std::string(std::string("CAmCommandReceiver::") + __func__)
 
@@ -41,6 +42,8 @@ CAmCommandReceiver::CAmCommandReceiver(IAmDatabaseHandler *iDatabaseHandler, CAm
     , mSocketHandler(iSocketHandler)
     , handleCount(0)
     , mListStartupHandles()
+    , mStartupPhases()
+    , mReadyPhase(0)
     , mListRundownHandles()
     , mWaitStartup(false)
     , mWaitRundown(false)
@@ -59,6 +62,8 @@ CAmCommandReceiver::CAmCommandReceiver(IAmDatabaseHandler *iDatabaseHandler, CAm
     , mSocketHandler(iSocketHandler)
     , handleCount(0)
     , mListStartupHandles()
+    , mStartupPhases()
+    , mReadyPhase(0)
     , mListRundownHandles()
     , mWaitStartup(false)
     , mWaitRundown(false)
@@ -203,6 +208,17 @@ void CAmCommandReceiver::confirmCommandReady(const uint16_t handle, const am_Err
     }
 
     mListStartupHandles.erase(std::remove(mListStartupHandles.begin(), mListStartupHandles.end(), handle), mListStartupHandles.end());
+    std::map<uint16_t, uint32_t>::iterator phase(mStartupPhases.find(handle));
+    if (phase != mStartupPhases.end())
+    {
+        CAmStartupProfiler::instance()->end(phase->second);
+        mStartupPhases.erase(phase);
+        if (mStartupPhases.empty())
+        {
+            CAmStartupProfiler::instance()->end(mReadyPhase);
+        }
+    }
+
     if (mWaitStartup && mListStartupHandles.empty())
     {
         mControlSender->confirmCommandReady(mLastErrorStartup);
@@ -223,10 +239,16 @@ void CAmCommandReceiver::confirmCommandRundown(const uint16_t handle, const am_E
     }
 }
 
-uint16_t CAmCommandReceiver::getStartupHandle()
+uint16_t CAmCommandReceiver::getStartupHandle(const std::string &name)
 {
     uint16_t handle = ++handleCount; // todo: handle overflow
     mListStartupHandles.push_back(handle);
+    if (mStartupPhases.empty())
+    {
+        mReadyPhase = CAmStartupProfiler::instance()->begin("command ready");
+    }
+
+    mStartupPhases[handle] = CAmStartupProfiler::instance()->begin("command ready " + name);
     return (handle);
 }
 
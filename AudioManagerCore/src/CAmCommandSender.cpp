@@ -166,81 +166,22 @@ void CAmCommandSender::loadPlugins(const std::vector<std::string> &listOfPluginD
         logError(__METHOD_NAME__, "List of commandplugins is empty");
     }
 
-    std::vector<std::string>                 sharedLibraryNameList;
-    std::vector<std::string>::const_iterator dirIter    = listOfPluginDirectories.begin();
-    std::vector<std::string>::const_iterator dirIterEnd = listOfPluginDirectories.end();
-
-    // search communicator plugins in configured directories
-    for (; dirIter < dirIterEnd; ++dirIter)
-    {
-        const char *directoryName = dirIter->c_str();
-        logInfo(__METHOD_NAME__, "Searching for CommandPlugins in", *dirIter);
-        DIR *directory = opendir(directoryName);
-
-        if (!directory)
-        {
-            logError(__METHOD_NAME__, "Error opening directory ", *dirIter);
-            continue;
-        }
-
-        // iterate content of directory
-        struct dirent *itemInDirectory = 0;
-        while ((itemInDirectory = readdir(directory)))
-        {
-            unsigned char entryType = itemInDirectory->d_type;
-            std::string   entryName = itemInDirectory->d_name;
-            std::string   fullName  = *dirIter + "/" + entryName;
-
-            bool regularFile        = (entryType == DT_REG || entryType == DT_LNK);
-            bool sharedLibExtension = ("so" == entryName.substr(entryName.find_last_of(".") + 1));
-
-            // Handle cases where readdir() could not determine the file type
-            if (entryType == DT_UNKNOWN)
-            {
-                struct stat buf;
-
-                if (stat(fullName.c_str(), &buf))
-                {
-                    logInfo(__METHOD_NAME__, "Failed to stat file: ", entryName, errno);
-                    continue;
-                }
-
-                regularFile = S_ISREG(buf.st_mode);
-            }
-
-            if (regularFile && sharedLibExtension)
-            {
-                std::string name(directoryName);
-                sharedLibraryNameList.push_back(name + "/" + entryName);
-            }
-        }
-
-        closedir(directory);
-    }
-
-    // iterate all communicator plugins and start them
-    std::vector<std::string>::iterator iter    = sharedLibraryNameList.begin();
-    std::vector<std::string>::iterator iterEnd = sharedLibraryNameList.end();
-
-    for (; iter < iterEnd; ++iter)
+    // the libraries are read ahead in parallel, they are opened, created and registered in the order of the names
+    std::vector<pluginLibrary_s<IAmCommandSend> > listLibraries(openPluginLibraries<IAmCommandSend>(findPluginLibraries(listOfPluginDirectories)));
+    for (pluginLibrary_s<IAmCommandSend> &library : listLibraries)
     {
-        logInfo(__METHOD_NAME__, "Loading CommandSender plugin", *iter);
-        IAmCommandSend *(*createFunc)();
-        void           *tempLibHandle = NULL;
-        createFunc = getCreateFunction<IAmCommandSend *()>(*iter, tempLibHandle);
-
-        if (!createFunc)
+        if (!library.createFunction)
         {
-            logInfo(__METHOD_NAME__, "Entry point of CommandPlugin not found", *iter);
+            logInfo(__METHOD_NAME__, "Entry point of CommandPlugin not found", library.libname);
             continue;
         }
 
-        IAmCommandSend *commander = createFunc();
+        IAmCommandSend *commander = createPlugin(library);
 
         if (!commander)
         {
             logInfo(__METHOD_NAME__, "CommandPlugin initialization failed. Entry Function not callable");
-            dlclose(tempLibHandle);
+            dlclose(library.libraryHandle);
             continue;
         }
 
@@ -256,13 +197,14 @@ void CAmCommandSender::loadPlugins(const std::vector<std::string> &listOfPluginD
         if (majorVersion < cMajorVersion || ((majorVersion == cMajorVersion) && (minorVersion > cMinorVersion)))
         {
             logError(__METHOD_NAME__, "CommandInterface initialization failed. Version of Interface to old");
-            dlclose(tempLibHandle);
+            dlclose(library.libraryHandle);
             continue;
         }
 
         mListInterfaces.push_back(commander);
-        mListLibraryHandles.push_back(tempLibHandle);
-        mListLibraryNames.push_back(iter->c_str());
+        mListLibraryHandles.push_back(library.libraryHandle);
+        mListLibraryNames.push_back(library.libname);
+        logInfo(__METHOD_NAME__, "loaded", library.libname, "in", library.loadTime, "us");
     }
 }
 
@@ -383,7 +325,9 @@ void CAmCommandSender::setCommandReady()
     std::vector<uint16_t> listStartupHandles;
     for (size_t i = 0; i < mListInterfaces.size(); i++)
     {
-        listStartupHandles.push_back(mCommandReceiver->getStartupHandle());
+        // interfaces which were not loaded from a library have no name
+        const std::string name((i < mListLibraryNames.size()) ? mListLibraryNames[i] : std::string());
+        listStartupHandles.push_back(mCommandReceiver->getStartupHandle(name));
     }
 
     // set the receiver ready to wait for replies
@@ -59,51 +59,15 @@ CAmControlSender::CAmControlSender(std::string controlPluginFile, CAmSocketHandl
     stat(conFile, &buf);
     if (S_ISDIR(buf.st_mode))
     {
-        std::string directoryName(controlPluginFile);
-        logInfo("Searching for ControlPlugin in", directoryName);
-        DIR *directory = opendir(directoryName.c_str());
-
-        if (!directory)
+        std::vector<std::string> listLibraries(findPluginLibraries(std::vector<std::string>(1, controlPluginFile)));
+        if (listLibraries.empty())
         {
-            logError("Error opening directory ", directoryName);
-            throw std::runtime_error("Controller directory could not be openend");
+            logError("ControlSender::ControlSender: No ControlPlugin in", controlPluginFile);
+            throw std::runtime_error("Could not find controller plugin!");
         }
 
-        // iterate content of directory
-        struct dirent *itemInDirectory = 0;
-        while ((itemInDirectory = readdir(directory)))
-        {
-            unsigned char entryType = itemInDirectory->d_type;
-            std::string   entryName = itemInDirectory->d_name;
-            std::string   fullName  = directoryName + "/" + entryName;
-
-            bool regularFile        = (entryType == DT_REG || entryType == DT_LNK);
-            bool sharedLibExtension = ("so" == entryName.substr(entryName.find_last_of(".") + 1));
-
-            // Handle cases where readdir() could not determine the file type
-            if (entryType == DT_UNKNOWN)
-            {
-                struct stat buf;
-
-                if (stat(fullName.c_str(), &buf))
-                {
-                    logInfo(__PRETTY_FUNCTION__, "Failed to stat file: ", entryName, errno);
-                    continue;
-                }
-
-                regularFile = S_ISREG(buf.st_mode);
-            }
-
-            if (regularFile && sharedLibExtension)
-            {
-                controlPluginFile = directoryName + "/" + entryName;
-                logInfo("Found ControlPlugin:", controlPluginFile);
-                break;
-            }
-        }
-
-        closedir(directory);
-
+        controlPluginFile = listLibraries.front();
+        logInfo("Found ControlPlugin:", controlPluginFile);
     }
 
     std::ifstream isfile(controlPluginFile.c_str());
@@ -115,11 +79,13 @@ CAmControlSender::CAmControlSender(std::string controlPluginFile, CAmSocketHandl
     else if (!controlPluginFile.empty())
     {
         mInstance = this;
-        IAmControlSend *(*createFunc)();
-        createFunc = getCreateFunction<IAmControlSend *()>(controlPluginFile, mlibHandle);
-        assert(createFunc != NULL);
-        mController        = createFunc();
+        std::vector<pluginLibrary_s<IAmControlSend> > listLibraries(openPluginLibraries<IAmControlSend>(std::vector<std::string>(1, controlPluginFile)));
+        pluginLibrary_s<IAmControlSend>              &library(listLibraries.front());
+        assert(library.createFunction != NULL);
+        mlibHandle         = library.libraryHandle;
+        mController        = createPlugin(library);
         mControlPluginFile = controlPluginFile;
+        logInfo("ControlSender::ControlSender: loaded", controlPluginFile, "in", library.loadTime, "us");
         // check libversion
         std::string version, cVersion(ControlVersion);
         mController->getInterfaceVersion(version);
@@ -562,6 +528,12 @@ void CAmControlSender::hookSystemSingleTimingInformationChanged(const am_connect
     mController->hookSystemSingleTimingInformationChanged(connectionID, time);
 }
 
+void CAmControlSender::cbHandleTimeout(const am_Handle_s handle)
+{
+    assert(mController);
+    mController->cbHandleTimeout(handle);
+}
+
 /**for testing only contructor - do not use !
  *
  */
@@ -799,19 +799,19 @@ am_Error_e CAmDatabaseHandlerMap::enterCrossfaderDB(const am_Crossfader_s &cross
 
     if (!existSink(crossfaderData.sinkID_A))
     {
-        logError(__METHOD_NAME__, "sinkID_A must exist");
+        AM_LOG_ERROR(__METHOD_NAME__, "sinkID_A must exist");
         return (E_NOT_POSSIBLE);
     }
 
     if (!existSink(crossfaderData.sinkID_B))
     {
-        logError(__METHOD_NAME__, "sinkID_B must exist");
+        AM_LOG_ERROR(__METHOD_NAME__, "sinkID_B must exist");
         return (E_NOT_POSSIBLE);
     }
 
     if (!existSource(crossfaderData.sourceID))
     {
-        logError(__METHOD_NAME__, "sourceID must exist");
+        AM_LOG_ERROR(__METHOD_NAME__, "sourceID must exist");
         return (E_NOT_POSSIBLE);
     }
 
@@ -960,19 +960,19 @@ am_Error_e CAmDatabaseHandlerMap::enterConverterDB(const am_Converter_s &convert
 
     if (!existSink(converterData.sinkID))
     {
-        logError(__METHOD_NAME__, "sinkID must exists");
+        AM_LOG_ERROR(__METHOD_NAME__, "sinkID must exists");
         return (E_NOT_POSSIBLE);
     }
 
     if (!existSource(converterData.sourceID))
     {
-        logError(__METHOD_NAME__, "sourceID must exists");
+        AM_LOG_ERROR(__METHOD_NAME__, "sourceID must exists");
         return (E_NOT_POSSIBLE);
     }
 
     if (!existDomain(converterData.domainID))
     {
-        logError(__METHOD_NAME__, "domainID must exists");
+        AM_LOG_ERROR(__METHOD_NAME__, "domainID must exists");
         return (E_NOT_POSSIBLE);
     }
 
@@ -1158,13 +1158,13 @@ am_Error_e CAmDatabaseHandlerMap::enterConnectionDB(const am_Connection_s &conne
 
     if (!existSink(connection.sinkID))
     {
-        logError(__METHOD_NAME__, "sinkID must exist!");
+        AM_LOG_ERROR(__METHOD_NAME__, "sinkID must exist!");
         return (E_NOT_POSSIBLE);
     }
 
     if (!existSource(connection.sourceID))
     {
-        logError(__METHOD_NAME__, "sourceID must exist!");
+        AM_LOG_ERROR(__METHOD_NAME__, "sourceID must exist!");
         return (E_NOT_POSSIBLE);
     }
 
@@ -1351,7 +1351,7 @@ am_Error_e CAmDatabaseHandlerMap::changeMainConnectionRouteDB(const am_mainConne
 
     if (!existMainConnection(mainconnectionID))
     {
-        logError(__METHOD_NAME__, "existMainConnection must exist");
+        AM_LOG_ERROR(__METHOD_NAME__, "existMainConnection must exist");
         return (E_NON_EXISTENT);
     }
 
@@ -1385,7 +1385,7 @@ am_Error_e CAmDatabaseHandlerMap::changeMainConnectionStateDB(const am_mainConne
 
     if (!existMainConnection(mainconnectionID))
     {
-        logError(__METHOD_NAME__, "existMainConnection must exist");
+        AM_LOG_ERROR(__METHOD_NAME__, "existMainConnection must exist");
         return (E_NON_EXISTENT);
     }
 
@@ -1400,7 +1400,7 @@ am_Error_e CAmDatabaseHandlerMap::changeSinkMainVolumeDB(const am_mainVolume_t m
 {
     if (!existSink(sinkID))
     {
-        logError(__METHOD_NAME__, "sinkID must exist");
+        AM_LOG_ERROR(__METHOD_NAME__, "sinkID must exist");
         return (E_NON_EXISTENT);
     }
 
@@ -1423,7 +1423,7 @@ am_Error_e CAmDatabaseHandlerMap::changeSinkAvailabilityDB(const am_Availability
 
     if (!existSink(sinkID))
     {
-        logError(__METHOD_NAME__, "sinkID must exist");
+        AM_LOG_ERROR(__METHOD_NAME__, "sinkID must exist");
         return (E_NON_EXISTENT);
     }
 
@@ -1450,7 +1450,7 @@ am_Error_e CAmDatabaseHandlerMap::changeDomainStateDB(const am_DomainState_e dom
 
     if (!existDomain(domainID))
     {
-        logError(__METHOD_NAME__, "domainID must exist");
+        AM_LOG_ERROR(__METHOD_NAME__, "domainID must exist");
         return (E_NON_EXISTENT);
     }
 
@@ -1471,7 +1471,7 @@ am_Error_e CAmDatabaseHandlerMap::changeSinkMuteStateDB(const am_MuteState_e mut
 
     if (!existSink(sinkID))
     {
-        logError(__METHOD_NAME__, "sinkID must exist");
+        AM_LOG_ERROR(__METHOD_NAME__, "sinkID must exist");
         return (E_NON_EXISTENT);
     }
 
@@ -1489,7 +1489,7 @@ am_Error_e CAmDatabaseHandlerMap::changeMainSinkSoundPropertyDB(const am_MainSou
 
     if (!existSink(sinkID))
     {
-        logError(__METHOD_NAME__, "sinkID must exist");
+        AM_LOG_ERROR(__METHOD_NAME__, "sinkID must exist");
         return (E_NON_EXISTENT);
     }
 
@@ -1519,7 +1519,7 @@ am_Error_e CAmDatabaseHandlerMap::changeMainSourceSoundPropertyDB(const am_MainS
 
     if (!existSource(sourceID))
     {
-        logError(__METHOD_NAME__, "sourceID must exist");
+        AM_LOG_ERROR(__METHOD_NAME__, "sourceID must exist");
         return (E_NON_EXISTENT);
     }
 
@@ -1555,7 +1555,7 @@ am_Error_e CAmDatabaseHandlerMap::changeSourceAvailabilityDB(const am_Availabili
 
     if (!existSource(sourceID))
     {
-        logError(__METHOD_NAME__, "sourceID must exist");
+        AM_LOG_ERROR(__METHOD_NAME__, "sourceID must exist");
         return (E_NON_EXISTENT);
     }
 
@@ -1594,7 +1594,7 @@ am_Error_e CAmDatabaseHandlerMap::removeMainConnectionDB(const am_mainConnection
 
     if (!existMainConnection(mainConnectionID))
     {
-        logError(__METHOD_NAME__, "mainConnectionID must exist");
+        AM_LOG_ERROR(__METHOD_NAME__, "mainConnectionID must exist");
         return (E_NON_EXISTENT);
     }
 
@@ -1618,7 +1618,7 @@ am_Error_e CAmDatabaseHandlerMap::removeSinkDB(const am_sinkID_t sinkID)
 
     if (!existSink(sinkID))
     {
-        logError(__METHOD_NAME__, "sinkID must exist");
+        AM_LOG_ERROR(__METHOD_NAME__, "sinkID must exist");
         return (E_NON_EXISTENT);
     }
 
@@ -1639,7 +1639,7 @@ am_Error_e CAmDatabaseHandlerMap::removeSourceDB(const am_sourceID_t sourceID)
 
     if (!existSource(sourceID))
     {
-        logError(__METHOD_NAME__, "sourceID must exist");
+        AM_LOG_ERROR(__METHOD_NAME__, "sourceID must exist");
         return (E_NON_EXISTENT);
     }
 
@@ -1660,7 +1660,7 @@ am_Error_e CAmDatabaseHandlerMap::removeGatewayDB(const am_gatewayID_t gatewayID
 
     if (!existGateway(gatewayID))
     {
-        logError(__METHOD_NAME__, "gatewayID must exist");
+        AM_LOG_ERROR(__METHOD_NAME__, "gatewayID must exist");
         return (E_NON_EXISTENT);
     }
 
@@ -1676,7 +1676,7 @@ am_Error_e CAmDatabaseHandlerMap::removeConverterDB(const am_converterID_t conve
 
     if (!existConverter(converterID))
     {
-        logError(__METHOD_NAME__, "converterID must exist");
+        AM_LOG_ERROR(__METHOD_NAME__, "converterID must exist");
         return (E_NON_EXISTENT);
     }
 
@@ -1692,7 +1692,7 @@ am_Error_e CAmDatabaseHandlerMap::removeCrossfaderDB(const am_crossfaderID_t cro
 
     if (!existCrossFader(crossfaderID))
     {
-        logError(__METHOD_NAME__, "crossfaderID must exist");
+        AM_LOG_ERROR(__METHOD_NAME__, "crossfaderID must exist");
         return (E_NON_EXISTENT);
     }
 
@@ -1709,7 +1709,7 @@ am_Error_e CAmDatabaseHandlerMap::removeDomainDB(const am_domainID_t domainID)
 
     if (!existDomain(domainID))
     {
-        logError(__METHOD_NAME__, "domainID must exist");
+        AM_LOG_ERROR(__METHOD_NAME__, "domainID must exist");
         return (E_NON_EXISTENT);
     }
 
@@ -1726,7 +1726,7 @@ am_Error_e CAmDatabaseHandlerMap::removeSinkClassDB(const am_sinkClass_t sinkCla
 
     if (!existSinkClass(sinkClassID))
     {
-        logError(__METHOD_NAME__, "sinkClassID must exist");
+        AM_LOG_ERROR(__METHOD_NAME__, "sinkClassID must exist");
         return (E_NON_EXISTENT);
     }
 
@@ -1742,7 +1742,7 @@ am_Error_e CAmDatabaseHandlerMap::removeSourceClassDB(const am_sourceClass_t sou
 
     if (!existSourceClass(sourceClassID))
     {
-        logError(__METHOD_NAME__, "sourceClassID must exist");
+        AM_LOG_ERROR(__METHOD_NAME__, "sourceClassID must exist");
         return (E_NON_EXISTENT);
     }
 
@@ -1756,7 +1756,7 @@ am_Error_e CAmDatabaseHandlerMap::removeConnection(const am_connectionID_t conne
 {
     if (!existConnectionID(connectionID))
     {
-        logError(__METHOD_NAME__, "connectionID must exist", connectionID);
+        AM_LOG_ERROR(__METHOD_NAME__, "connectionID must exist", connectionID);
         return (E_NON_EXISTENT);
     }
 
@@ -1771,7 +1771,7 @@ am_Error_e CAmDatabaseHandlerMap::getSourceClassInfoDB(const am_sourceID_t sourc
 
     if (!existSource(sourceID))
     {
-        logWarning(__METHOD_NAME__, "sourceID must exist");
+        AM_LOG_WARNING(__METHOD_NAME__, "sourceID must exist");
         return (E_NON_EXISTENT);
     }
 
@@ -1833,7 +1833,7 @@ am_Error_e am::CAmDatabaseHandlerMap::getMainConnectionInfoDB(const am_mainConne
 {
     if (!existMainConnection(mainConnectionID))
     {
-        logError(__METHOD_NAME__, "mainConnectionID must exist");
+        AM_LOG_ERROR(__METHOD_NAME__, "mainConnectionID must exist");
         return (E_NON_EXISTENT);
     }
 
@@ -1854,7 +1854,7 @@ am_Error_e CAmDatabaseHandlerMap::changeSinkClassInfoDB(const am_SinkClass_s &si
     // check if the ID already exists
     if (!existSinkClass(sinkClass.sinkClassID))
     {
-        logError(__METHOD_NAME__, "sinkClassID must exist");
+        AM_LOG_ERROR(__METHOD_NAME__, "sinkClassID must exist");
         return (E_NON_EXISTENT);
     }
 
@@ -1875,7 +1875,7 @@ am_Error_e CAmDatabaseHandlerMap::changeSourceClassInfoDB(const am_SourceClass_s
     // check if the ID already exists
     if (!existSourceClass(sourceClass.sourceClassID))
     {
-        logError(__METHOD_NAME__, "sourceClassID must exist");
+        AM_LOG_ERROR(__METHOD_NAME__, "sourceClassID must exist");
         return (E_NON_EXISTENT);
     }
 
@@ -1890,7 +1890,7 @@ am_Error_e CAmDatabaseHandlerMap::getSinkClassInfoDB(const am_sinkID_t sinkID, a
 
     if (!existSink(sinkID))
     {
-        logWarning(__METHOD_NAME__, "sinkID must exist");
+        AM_LOG_WARNING(__METHOD_NAME__, "sinkID must exist");
         return (E_NON_EXISTENT);
     }
 
@@ -1899,7 +1899,7 @@ am_Error_e CAmDatabaseHandlerMap::getSinkClassInfoDB(const am_sinkID_t sinkID, a
 
     if (!existSinkClass(sinkClass.sinkClassID))
     {
-        logWarning(__METHOD_NAME__, "sinkClassID must exist");
+        AM_LOG_WARNING(__METHOD_NAME__, "sinkClassID must exist");
         return (E_NON_EXISTENT);
     }
 
@@ -1913,7 +1913,7 @@ am_Error_e CAmDatabaseHandlerMap::getGatewayInfoDB(const am_gatewayID_t gatewayI
 {
     if (!existGateway(gatewayID))
     {
-        logWarning(__METHOD_NAME__, "gatewayID must exist");
+        AM_LOG_WARNING(__METHOD_NAME__, "gatewayID must exist");
         return (E_NON_EXISTENT);
     }
 
@@ -1927,7 +1927,7 @@ am_Error_e CAmDatabaseHandlerMap::getConverterInfoDB(const am_converterID_t conv
 {
     if (!existConverter(converterID))
     {
-        logWarning(__METHOD_NAME__, "converterID must exist");
+        AM_LOG_WARNING(__METHOD_NAME__, "converterID must exist");
         return (E_NON_EXISTENT);
     }
 
@@ -1941,7 +1941,7 @@ am_Error_e CAmDatabaseHandlerMap::getCrossfaderInfoDB(const am_crossfaderID_t cr
 {
     if (!existCrossFader(crossfaderID))
     {
-        logWarning(__METHOD_NAME__, "crossfaderID must exist");
+        AM_LOG_WARNING(__METHOD_NAME__, "crossfaderID must exist");
         return (E_NON_EXISTENT);
     }
 
@@ -1955,7 +1955,7 @@ am_Error_e CAmDatabaseHandlerMap::getListSinksOfDomain(const am_domainID_t domai
     listSinkID.clear();
     if (!existDomain(domainID))
     {
-        logWarning(__METHOD_NAME__, "domainID must exist");
+        AM_LOG_WARNING(__METHOD_NAME__, "domainID must exist");
         return (E_NON_EXISTENT);
     }
 
@@ -1976,7 +1976,7 @@ am_Error_e CAmDatabaseHandlerMap::getListSourcesOfDomain(const am_domainID_t dom
     listSourceID.clear();
     if (!existDomain(domainID))
     {
-        logWarning(__METHOD_NAME__, "domainID must exist");
+        AM_LOG_WARNING(__METHOD_NAME__, "domainID must exist");
         return (E_NON_EXISTENT);
     }
 
@@ -1997,7 +1997,7 @@ am_Error_e CAmDatabaseHandlerMap::getListCrossfadersOfDomain(const am_domainID_t
     listCrossfader.clear();
     if (!existDomain(domainID))
     {
-        logWarning(__METHOD_NAME__, "domainID must exist");
+        AM_LOG_WARNING(__METHOD_NAME__, "domainID must exist");
         return (E_NON_EXISTENT);
     }
 
@@ -2026,7 +2026,7 @@ am_Error_e CAmDatabaseHandlerMap::getListGatewaysOfDomain(const am_domainID_t do
     listGatewaysID.clear();
     if (!existDomain(domainID))
     {
-        logWarning(__METHOD_NAME__, "domainID must exist");
+        AM_LOG_WARNING(__METHOD_NAME__, "domainID must exist");
         return (E_NON_EXISTENT);
     }
 
@@ -2047,7 +2047,7 @@ am_Error_e CAmDatabaseHandlerMap::getListConvertersOfDomain(const am_domainID_t
     listConvertersID.clear();
     if (!existDomain(domainID))
     {
-        logWarning(__METHOD_NAME__, "domainID must exist");
+        AM_LOG_WARNING(__METHOD_NAME__, "domainID must exist");
         return (E_NON_EXISTENT);
     }
 
@@ -2249,7 +2249,7 @@ am_Error_e CAmDatabaseHandlerMap::getListMainSinkSoundProperties(const am_sinkID
 {
     if (!existSink(sinkID))
     {
-        logWarning(__METHOD_NAME__, "sinkID must exist");
+        AM_LOG_WARNING(__METHOD_NAME__, "sinkID must exist");
         return E_NON_EXISTENT;
     }
 
@@ -2263,7 +2263,7 @@ am_Error_e CAmDatabaseHandlerMap::getListMainSourceSoundProperties(const am_sour
 {
     if (!existSource(sourceID))
     {
-        logWarning(__METHOD_NAME__, "sourceID must exist");
+        AM_LOG_WARNING(__METHOD_NAME__, "sourceID must exist");
         return E_NON_EXISTENT;
     }
 
@@ -2277,7 +2277,7 @@ am_Error_e CAmDatabaseHandlerMap::getListSinkSoundProperties(const am_sinkID_t s
 {
     if (!existSink(sinkID))
     {
-        logWarning(__METHOD_NAME__, "sinkID must exist");
+        AM_LOG_WARNING(__METHOD_NAME__, "sinkID must exist");
         return E_NON_EXISTENT;
     }
 
@@ -2291,7 +2291,7 @@ am_Error_e CAmDatabaseHandlerMap::getListSourceSoundProperties(const am_sourceID
 {
     if (!existSource(sourceID))
     {
-        logWarning(__METHOD_NAME__, "sourceID must exist");
+        AM_LOG_WARNING(__METHOD_NAME__, "sourceID must exist");
         return E_NON_EXISTENT;
     }
 
@@ -2311,7 +2311,7 @@ am_Error_e am::CAmDatabaseHandlerMap::getListSinkConnectionFormats(const am_sink
 {
     if (!existSink(sinkID))
     {
-        logWarning(__METHOD_NAME__, "sinkID must exist");
+        AM_LOG_WARNING(__METHOD_NAME__, "sinkID must exist");
         return E_NON_EXISTENT;
     }
 
@@ -2325,7 +2325,7 @@ am_Error_e am::CAmDatabaseHandlerMap::getListSourceConnectionFormats(const am_so
 {
     if (!existSource(sourceID))
     {
-        logWarning(__METHOD_NAME__, "sourceID must exist");
+        AM_LOG_WARNING(__METHOD_NAME__, "sourceID must exist");
         return E_NON_EXISTENT;
     }
 
@@ -2339,7 +2339,7 @@ am_Error_e am::CAmDatabaseHandlerMap::getListGatewayConnectionFormats(const am_g
 {
     if (!existGateway(gatewayID))
     {
-        logWarning(__METHOD_NAME__, "gatewayID must exist");
+        AM_LOG_WARNING(__METHOD_NAME__, "gatewayID must exist");
         return E_NON_EXISTENT;
     }
 
@@ -2361,7 +2361,7 @@ am_Error_e CAmDatabaseHandlerMap::getTimingInformation(const am_mainConnectionID
 {
     if (!existMainConnection(mainConnectionID))
     {
-        logWarning(__METHOD_NAME__, "mainConnectionID must exist");
+        AM_LOG_WARNING(__METHOD_NAME__, "mainConnectionID must exist");
         return E_NON_EXISTENT;
     }
 
@@ -2382,7 +2382,7 @@ am_Error_e CAmDatabaseHandlerMap::changeDelayMainConnection(const am_timeSync_t
 {
     if (!existMainConnection(connectionID))
     {
-        logError(__METHOD_NAME__, "connectionID must exist");
+        AM_LOG_ERROR(__METHOD_NAME__, "connectionID must exist");
         return E_NON_EXISTENT;
     }
 
@@ -2608,7 +2608,7 @@ am_Error_e CAmDatabaseHandlerMap::changeConnectionTimingInformation(const am_con
 {
     if (!existConnectionID(connectionID))
     {
-        logError(__METHOD_NAME__, "connectionID must exist");
+        AM_LOG_ERROR(__METHOD_NAME__, "connectionID must exist");
         return (E_NON_EXISTENT);
     }
 
@@ -2641,7 +2641,7 @@ am_Error_e CAmDatabaseHandlerMap::changeConnectionFinal(const am_connectionID_t
         return E_OK;
     }
 
-    logError(__METHOD_NAME__, "connectionID must exist");
+    AM_LOG_ERROR(__METHOD_NAME__, "connectionID must exist");
     return (E_NON_EXISTENT);
 }
 
@@ -2681,7 +2681,7 @@ bool CAmDatabaseHandlerMap::sourceVisible(const am_sourceID_t sourceID) const
 {
     if (!existSource(sourceID))
     {
-        logError(__METHOD_NAME__, "sourceID must exist");
+        AM_LOG_ERROR(__METHOD_NAME__, "sourceID must exist");
         return false;
     }
 
@@ -2780,7 +2780,7 @@ am_Error_e CAmDatabaseHandlerMap::changeSourceState(const am_sourceID_t sourceID
         return (E_OK);
     }
 
-    logError(__METHOD_NAME__, "sourceID must exist");
+    AM_LOG_ERROR(__METHOD_NAME__, "sourceID must exist");
     return (E_NON_EXISTENT);
 }
 
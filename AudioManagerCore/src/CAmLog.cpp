@@ -22,6 +22,228 @@
  */
 
 #include "CAmLog.h"
+#include <atomic>
+
+// the macro of the default log would hide the nested class
+#undef CAmLogger
+
+namespace
+{
+std::atomic<uint64_t> nextLoggerID(1);
+}
+
+CAmLog::CAmLogger::CAmLogger()
+    : mOutputStream(NULL)
+    , mID(nextLoggerID++)
+    , mMutex()
+    , mWriteMutex()
+    , mCondition()
+    , mBuffer()
+    , mThread()
+    , mStop(false)
+    , mFlushSize(DEFAULT_LOG_FLUSH_SIZE)
+    , mFlushInterval(DEFAULT_LOG_FLUSH_INTERVAL)
+{
+    std::lock_guard<std::mutex> lock(getLoggersMutex());
+    getLoggers()[mID] = this;
+}
+
+CAmLog::CAmLogger::~CAmLogger()
+{
+    stop();
+}
+
+void CAmLog::CAmLogger::stop()
+{
+    // no thread can hand text over while the stream is closed
+    {
+        std::lock_guard<std::mutex> lock(getLoggersMutex());
+        getLoggers().erase(mID);
+    }
+
+    // the incomplete line of the destroying thread is written as well
+    staging_s &staging(getThreadStaging());
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        if (staging.logger == mID)
+        {
+            mBuffer.append(staging.text);
+            staging.text.clear();
+            staging.logger = 0;
+        }
+
+        mStop = true;
+    }
+    mCondition.notify_one();
+    if (mThread.joinable())
+    {
+        mThread.join();
+    }
+
+    writeBuffer();
+}
+
+void CAmLog::CAmLogger::log(const std::string &_s)
+{
+    std::string text(_s);
+    commit(text, text.size());
+}
+
+void CAmLog::CAmLogger::setFlushPolicy(const size_t flushSize, const unsigned flushInterval)
+{
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mFlushSize     = flushSize;
+        mFlushInterval = std::chrono::milliseconds(flushInterval);
+    }
+    mCondition.notify_one();
+    if (flushSize == 0)
+    {
+        writeBuffer();
+    }
+}
+
+void CAmLog::CAmLogger::flush()
+{
+    std::string &staging(getStaging());
+    if (!staging.empty())
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mBuffer.append(staging);
+        staging.clear();
+    }
+
+    writeBuffer();
+}
+
+std::ostringstream &CAmLog::CAmLogger::getFormatter()
+{
+    static thread_local std::ostringstream formatter;
+    return (formatter);
+}
+
+std::mutex &CAmLog::CAmLogger::getLoggersMutex()
+{
+    static std::mutex loggersMutex;
+    return (loggersMutex);
+}
+
+std::map<uint64_t, CAmLog::CAmLogger *> &CAmLog::CAmLogger::getLoggers()
+{
+    static std::map<uint64_t, CAmLogger *> loggers;
+    return (loggers);
+}
+
+CAmLog::CAmLogger::staging_s &CAmLog::CAmLogger::getThreadStaging()
+{
+    static thread_local staging_s staging = { 0, std::string() };
+    return (staging);
+}
+
+std::string &CAmLog::CAmLogger::getStaging()
+{
+    // one slot per thread, so deleted loggers leave nothing behind. The owner is kept by the id and not by the
+    // address, a new logger must not find the text of a deleted one. A thread which changes the logger in the
+    // middle of a line hands the incomplete line over to the previous logger, if it still exists.
+    staging_s &staging(getThreadStaging());
+    if (staging.logger != mID)
+    {
+        if (!staging.text.empty())
+        {
+            std::lock_guard<std::mutex> lock(getLoggersMutex());
+            std::map<uint64_t, CAmLogger *>::iterator it = getLoggers().find(staging.logger);
+            if (it != getLoggers().end())
+            {
+                it->second->commit(staging.text, staging.text.size());
+            }
+
+            staging.text.clear();
+        }
+
+        staging.logger = mID;
+    }
+
+    return (staging.text);
+}
+
+void CAmLog::CAmLogger::stage(const std::string &text)
+{
+    std::string &staging(getStaging());
+    staging.append(text);
+    if (text.find('\n') != std::string::npos)
+    {
+        commit(staging, staging.rfind('\n') + 1);
+    }
+}
+
+void CAmLog::CAmLogger::commit(std::string &staging, const size_t length)
+{
+    bool writeNow = false;
+    bool wakeUp   = false;
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        const bool wasEmpty = mBuffer.empty();
+        mBuffer.append(staging, 0, length);
+        writeNow = mStop || (mFlushSize == 0);
+        wakeUp   = !writeNow && (wasEmpty || (mBuffer.size() >= mFlushSize));
+        if (!writeNow && !mThread.joinable())
+        {
+            mThread = std::thread(&CAmLogger::flushThread, this);
+        }
+    }
+
+    staging.erase(0, length);
+    if (writeNow)
+    {
+        writeBuffer();
+    }
+    else if (wakeUp)
+    {
+        mCondition.notify_one();
+    }
+}
+
+void CAmLog::CAmLogger::writeBuffer()
+{
+    // the buffer is taken under the write lock, so the texts reach the stream in the order they were committed
+    std::lock_guard<std::mutex> writeLock(mWriteMutex);
+    std::string text;
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        text.swap(mBuffer);
+    }
+
+    if (!text.empty() && (mOutputStream != NULL))
+    {
+        (*mOutputStream) << text;
+        mOutputStream->flush();
+    }
+}
+
+void CAmLog::CAmLogger::flushThread()
+{
+    std::unique_lock<std::mutex> lock(mMutex);
+    while (!mStop)
+    {
+        // nothing is buffered, so the interval does not run until the next text comes
+        if (mBuffer.empty())
+        {
+            mCondition.wait(lock, [this]
+                {
+                    return (mStop || !mBuffer.empty());
+                });
+            continue;
+        }
+
+        mCondition.wait_for(lock, mFlushInterval, [this]
+            {
+                return (mStop || ((mFlushSize != 0) && (mBuffer.size() >= mFlushSize)));
+            });
+        lock.unlock();
+        writeBuffer();
+        lock.lock();
+    }
+}
 
 void CAmLog::CAmFileLogger::generateLogFilename(std::string &result)
 {
@@ -37,22 +259,29 @@ void CAmLog::CAmFileLogger::generateLogFilename(std::string &result)
 
 CAmLog::CAmFileLogger::~CAmFileLogger()
 {
-    if (mOutputStream)
-    {
-        std::ofstream *of = static_cast<std::ofstream *>(mOutputStream);
-        of->close();
-        DEL(mOutputStream);
-    }
+    stop();
+    mFile.close();
+}
+
+CAmLog::CAmStdOutLogger::~CAmStdOutLogger()
+{
+    stop();
 }
 
 CAmLog::CAmLog(const eCAmLogType type)
     : mLogType(type)
+    , mLogger(NULL)
+    , mFlushSize(DEFAULT_LOG_FLUSH_SIZE)
+    , mFlushInterval(DEFAULT_LOG_FLUSH_INTERVAL)
 {
     instantiateLogger(type);
 }
 
 CAmLog::CAmLog()
     : mLogType(eCAmLogStdout)
+    , mLogger(NULL)
+    , mFlushSize(DEFAULT_LOG_FLUSH_SIZE)
+    , mFlushInterval(DEFAULT_LOG_FLUSH_INTERVAL)
 {
     instantiateLogger((const eCAmLogType)eCAmLogStdout);
 }
@@ -82,6 +311,11 @@ void CAmLog::instantiateLogger(const eCAmLogType type)
         CAmLog::CAmFileLogger::generateLogFilename(filename);
         mLogger = new CAmFileLogger(filename);
     }
+
+    if (mLogger)
+    {
+        mLogger->setFlushPolicy(mFlushSize, mFlushInterval);
+    }
 }
 
 CAmLog *CAmLog::getDefaultLog()
@@ -104,3 +338,21 @@ eCAmLogType CAmLog::getLogType() const
 {
     return mLogType;
 }
+
+void CAmLog::setFlushPolicy(const size_t flushSize, const unsigned flushInterval)
+{
+    mFlushSize     = flushSize;
+    mFlushInterval = flushInterval;
+    if (mLogger)
+    {
+        mLogger->setFlushPolicy(flushSize, flushInterval);
+    }
+}
+
+void CAmLog::flush()
+{
+    if (mLogger)
+    {
+        mLogger->flush();
+    }
+}
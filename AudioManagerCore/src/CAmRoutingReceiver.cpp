@@ -29,6 +29,7 @@
 #include "CAmControlSender.h"
 #include "CAmDltWrapper.h"
 #include "CAmSocketHandler.h"
+#include "CAmStartupProfiler.h"
 
 #define __METHOD_NAME__ std::string(std::string("CAmRoutingReceiver::") + __func__)
 
@@ -42,12 +43,18 @@ CAmRoutingReceiver::CAmRoutingReceiver(IAmDatabaseHandler *iDatabaseHandler, CAm
     , mpSocketHandler(iSocketHandler)
     , mpDBusWrapper(NULL)
     , mListStartupHandles()
+    , mStartupPhases()
+    , mReadyPhase(0)
     , mListRundownHandles()
     , handleCount(0)
     , mWaitStartup(false)
     , mWaitRundown(false)
     , mLastStartupError(E_OK)
     , mLastRundownError(E_OK)
+    , mVolumeTickInterval(0)
+    , mVolumeTickTimer(0)
+    , mSinkVolumeTicks()
+    , mSourceVolumeTicks()
 {
     assert(mpDatabaseHandler != NULL);
     assert(mpRoutingSender != NULL);
@@ -62,12 +69,18 @@ CAmRoutingReceiver::CAmRoutingReceiver(IAmDatabaseHandler *iDatabaseHandler, CAm
     , mpSocketHandler(iSocketHandler)
     , mpDBusWrapper(iDBusWrapper)
     , mListStartupHandles()
+    , mStartupPhases()
+    , mReadyPhase(0)
     , mListRundownHandles()
     , handleCount(0)
     , mWaitStartup(false)
     , mWaitRundown(false)
     , mLastStartupError(E_OK)
     , mLastRundownError(E_OK)
+    , mVolumeTickInterval(0)
+    , mVolumeTickTimer(0)
+    , mSinkVolumeTicks()
+    , mSourceVolumeTicks()
 {
     assert(mpDatabaseHandler != NULL);
     assert(mpRoutingSender != NULL);
@@ -78,6 +91,10 @@ CAmRoutingReceiver::CAmRoutingReceiver(IAmDatabaseHandler *iDatabaseHandler, CAm
 
 CAmRoutingReceiver::~CAmRoutingReceiver()
 {
+    if (mVolumeTickTimer != 0)
+    {
+        mpSocketHandler->removeTimer(mVolumeTickTimer);
+    }
 }
 
 void CAmRoutingReceiver::handleCallback(const am_Handle_s handle, const am_Error_e error)
@@ -94,7 +111,12 @@ void CAmRoutingReceiver::handleCallback(const am_Handle_s handle, const am_Error
 
 void CAmRoutingReceiver::ackConnect(const am_Handle_s handle, const am_connectionID_t connectionID, const am_Error_e error)
 {
-    logInfo(__METHOD_NAME__, "handle=", handle, "connectionID=", connectionID, "error=", error);
+    AM_LOG_INFO(__METHOD_NAME__, "handle=", handle, "connectionID=", connectionID, "error=", error);
+    if (mpRoutingSender->dropLateAcknowledge(handle))
+    {
+        return;
+    }
+
     if (error == am_Error_e::E_OK)
     {
         mpRoutingSender->writeToDatabaseAndRemove(handle);
@@ -114,7 +136,12 @@ void CAmRoutingReceiver::ackConnect(const am_Handle_s handle, const am_connectio
 
 void CAmRoutingReceiver::ackDisconnect(const am_Handle_s handle, const am_connectionID_t connectionID, const am_Error_e error)
 {
-    logInfo(__METHOD_NAME__, "handle=", handle, "connectionID=", connectionID, "error=", error);
+    AM_LOG_INFO(__METHOD_NAME__, "handle=", handle, "connectionID=", connectionID, "error=", error);
+    if (mpRoutingSender->dropLateAcknowledge(handle))
+    {
+        return;
+    }
+
     // only remove connection of handle was found
     if (mpRoutingSender->removeHandle(handle) == 0)
     {
@@ -126,7 +153,13 @@ void CAmRoutingReceiver::ackDisconnect(const am_Handle_s handle, const am_connec
 
 void CAmRoutingReceiver::ackSetSinkVolumeChange(const am_Handle_s handle, const am_volume_t volume, const am_Error_e error)
 {
-    logInfo(__METHOD_NAME__, "handle=", handle, "volume=", volume, "error=", error);
+    AM_LOG_INFO(__METHOD_NAME__, "handle=", handle, "volume=", volume, "error=", error);
+    if (mpRoutingSender->dropLateAcknowledge(handle))
+    {
+        return;
+    }
+
+    flushVolumeTicks(handle);
     if (error == E_OK)
     {
         mpRoutingSender->checkVolume(handle, volume);
@@ -146,7 +179,13 @@ void CAmRoutingReceiver::ackSetSinkVolumeChange(const am_Handle_s handle, const
 
 void CAmRoutingReceiver::ackSetSourceVolumeChange(const am_Handle_s handle, const am_volume_t volume, const am_Error_e error)
 {
-    logInfo(__METHOD_NAME__, "handle=", handle, "volume=", volume, "error=", error);
+    AM_LOG_INFO(__METHOD_NAME__, "handle=", handle, "volume=", volume, "error=", error);
+    if (mpRoutingSender->dropLateAcknowledge(handle))
+    {
+        return;
+    }
+
+    flushVolumeTicks(handle);
     if (error == E_OK)
     {
         mpRoutingSender->checkVolume(handle, volume);
@@ -166,56 +205,120 @@ void CAmRoutingReceiver::ackSetSourceVolumeChange(const am_Handle_s handle, cons
 
 void CAmRoutingReceiver::ackSetSourceState(const am_Handle_s handle, const am_Error_e error)
 {
-    logInfo(__METHOD_NAME__, "handle=", handle, "error=", error);
+    AM_LOG_INFO(__METHOD_NAME__, "handle=", handle, "error=", error);
+    if (mpRoutingSender->dropLateAcknowledge(handle))
+    {
+        return;
+    }
+
     handleCallback(handle, error);
     mpControlSender->cbAckSetSourceState(handle, error);
 }
 
 void CAmRoutingReceiver::ackSetSinkSoundProperty(const am_Handle_s handle, const am_Error_e error)
 {
-    logInfo(__METHOD_NAME__, "handle=", handle, "error=", error);
+    AM_LOG_INFO(__METHOD_NAME__, "handle=", handle, "error=", error);
+    if (mpRoutingSender->dropLateAcknowledge(handle))
+    {
+        return;
+    }
+
     handleCallback(handle, error);
     mpControlSender->cbAckSetSinkSoundProperty(handle, error);
 }
 
 void am::CAmRoutingReceiver::ackSetSinkSoundProperties(const am_Handle_s handle, const am_Error_e error)
 {
-    logInfo(__METHOD_NAME__, "handle=", handle, "error=", error);
+    AM_LOG_INFO(__METHOD_NAME__, "handle=", handle, "error=", error);
+    if (mpRoutingSender->dropLateAcknowledge(handle))
+    {
+        return;
+    }
+
     handleCallback(handle, error);
     mpControlSender->cbAckSetSinkSoundProperties(handle, error);
 }
 
 void CAmRoutingReceiver::ackSetSourceSoundProperty(const am_Handle_s handle, const am_Error_e error)
 {
-    logInfo(__METHOD_NAME__, "handle=", handle, "error=", error);
+    AM_LOG_INFO(__METHOD_NAME__, "handle=", handle, "error=", error);
+    if (mpRoutingSender->dropLateAcknowledge(handle))
+    {
+        return;
+    }
+
     handleCallback(handle, error);
     mpControlSender->cbAckSetSourceSoundProperty(handle, error);
 }
 
 void am::CAmRoutingReceiver::ackSetSourceSoundProperties(const am_Handle_s handle, const am_Error_e error)
 {
-    logInfo(__METHOD_NAME__, "handle=", handle, "error=", error);
+    AM_LOG_INFO(__METHOD_NAME__, "handle=", handle, "error=", error);
+    if (mpRoutingSender->dropLateAcknowledge(handle))
+    {
+        return;
+    }
+
     handleCallback(handle, error);
     mpControlSender->cbAckSetSourceSoundProperties(handle, error);
 }
 
 void CAmRoutingReceiver::ackCrossFading(const am_Handle_s handle, const am_HotSink_e hotSink, const am_Error_e error)
 {
-    logInfo(__METHOD_NAME__, "handle=", handle, "hotsink=", hotSink, "error=", error);
+    AM_LOG_INFO(__METHOD_NAME__, "handle=", handle, "hotsink=", hotSink, "error=", error);
+    if (mpRoutingSender->dropLateAcknowledge(handle))
+    {
+        return;
+    }
+
     handleCallback(handle, error);
     mpControlSender->cbAckCrossFade(handle, hotSink, error);
 }
 
 void CAmRoutingReceiver::ackSourceVolumeTick(const am_Handle_s handle, const am_sourceID_t sourceID, const am_volume_t volume)
 {
-    logInfo(__METHOD_NAME__, "handle=", handle, "sourceID=", sourceID, "volume=", volume);
-    mpControlSender->hookSystemSourceVolumeTick(handle, sourceID, volume);
+    AM_LOG_VERBOSE(__METHOD_NAME__, "handle=", handle, "sourceID=", sourceID, "volume=", volume);
+    // the ticks of a part of a batch of volumes belong to the batch for the controller
+    const am_Handle_s controllerHandle(mpRoutingSender->returnControllerHandle(handle));
+    if (mVolumeTickInterval == 0)
+    {
+        mpControlSender->hookSystemSourceVolumeTick(controllerHandle, sourceID, volume);
+        return;
+    }
+
+    // the timer runs while ticks wait, a tick that comes meanwhile just replaces the waiting one
+    const bool waiting(!mSinkVolumeTicks.empty() || !mSourceVolumeTicks.empty());
+    volumeTick_s &tick(mSourceVolumeTicks[sourceID]);
+    tick.handle = controllerHandle;
+    tick.part   = handle;
+    tick.volume = volume;
+    if (!waiting)
+    {
+        startVolumeTickTimer();
+    }
 }
 
 void CAmRoutingReceiver::ackSinkVolumeTick(const am_Handle_s handle, const am_sinkID_t sinkID, const am_volume_t volume)
 {
-    logInfo(__METHOD_NAME__, "handle=", handle, "sinkID=", sinkID, "volume=", volume);
-    mpControlSender->hookSystemSinkVolumeTick(handle, sinkID, volume);
+    AM_LOG_VERBOSE(__METHOD_NAME__, "handle=", handle, "sinkID=", sinkID, "volume=", volume);
+    // the ticks of a part of a batch of volumes belong to the batch for the controller
+    const am_Handle_s controllerHandle(mpRoutingSender->returnControllerHandle(handle));
+    if (mVolumeTickInterval == 0)
+    {
+        mpControlSender->hookSystemSinkVolumeTick(controllerHandle, sinkID, volume);
+        return;
+    }
+
+    // the timer runs while ticks wait, a tick that comes meanwhile just replaces the waiting one
+    const bool waiting(!mSinkVolumeTicks.empty() || !mSourceVolumeTicks.empty());
+    volumeTick_s &tick(mSinkVolumeTicks[sinkID]);
+    tick.handle = controllerHandle;
+    tick.part   = handle;
+    tick.volume = volume;
+    if (!waiting)
+    {
+        startVolumeTickTimer();
+    }
 }
 
 am_Error_e CAmRoutingReceiver::peekDomain(const std::string &name, am_domainID_t &domainID)
@@ -375,6 +478,17 @@ void CAmRoutingReceiver::confirmRoutingReady(const uint16_t handle, const am_Err
     }
 
     mListStartupHandles.erase(std::remove(mListStartupHandles.begin(), mListStartupHandles.end(), handle), mListStartupHandles.end());
+    std::map<uint16_t, uint32_t>::iterator phase(mStartupPhases.find(handle));
+    if (phase != mStartupPhases.end())
+    {
+        CAmStartupProfiler::instance()->end(phase->second);
+        mStartupPhases.erase(phase);
+        if (mStartupPhases.empty())
+        {
+            CAmStartupProfiler::instance()->end(mReadyPhase);
+        }
+    }
+
     if (mWaitStartup && mListStartupHandles.empty())
     {
         mpControlSender->confirmRoutingReady(mLastStartupError);
@@ -395,10 +509,16 @@ void CAmRoutingReceiver::confirmRoutingRundown(const uint16_t handle, const am_E
     }
 }
 
-uint16_t am::CAmRoutingReceiver::getStartupHandle()
+uint16_t am::CAmRoutingReceiver::getStartupHandle(const std::string &name)
 {
     uint16_t handle = ++handleCount; // todo: handle overflow
     mListStartupHandles.push_back(handle);
+    if (mStartupPhases.empty())
+    {
+        mReadyPhase = CAmStartupProfiler::instance()->begin("routing ready");
+    }
+
+    mStartupPhases[handle] = CAmStartupProfiler::instance()->begin("routing ready " + name);
     return (handle);
 }
 
@@ -417,14 +537,24 @@ void am::CAmRoutingReceiver::waitOnStartup(bool startup)
 
 void CAmRoutingReceiver::ackSinkNotificationConfiguration(const am_Handle_s handle, const am_Error_e error)
 {
-    logInfo(__METHOD_NAME__, "handle=", handle, "error=", error);
+    AM_LOG_INFO(__METHOD_NAME__, "handle=", handle, "error=", error);
+    if (mpRoutingSender->dropLateAcknowledge(handle))
+    {
+        return;
+    }
+
     handleCallback(handle, error);
     mpControlSender->cbAckSetSinkNotificationConfiguration(handle, error);
 }
 
 void CAmRoutingReceiver::ackSourceNotificationConfiguration(const am_Handle_s handle, const am_Error_e error)
 {
-    logInfo(__METHOD_NAME__, "handle=", handle, "error=", error);
+    AM_LOG_INFO(__METHOD_NAME__, "handle=", handle, "error=", error);
+    if (mpRoutingSender->dropLateAcknowledge(handle))
+    {
+        return;
+    }
+
     handleCallback(handle, error);
     mpControlSender->cbAckSetSourceNotificationConfiguration(handle, error);
 }
@@ -451,20 +581,31 @@ am_Error_e CAmRoutingReceiver::updateSource(const am_sourceID_t sourceID, const
 
 void CAmRoutingReceiver::ackSetVolumes(const am_Handle_s handle, const std::vector<am_Volumes_s> &listvolumes, const am_Error_e error)
 {
-    logInfo(__METHOD_NAME__, "handle=", handle, "error=", error);
-    handleCallback(handle, error);
-    mpControlSender->cbAckSetVolume(handle, listvolumes, error);
+    AM_LOG_INFO(__METHOD_NAME__, "handle=", handle, "error=", error);
+    if (mpRoutingSender->dropLateAcknowledge(handle))
+    {
+        return;
+    }
+
+    flushVolumeTicks(handle);
+    am_Handle_s               ackHandle(handle);
+    std::vector<am_Volumes_s> listAckVolumes(listvolumes);
+    am_Error_e                ackError(error);
+    if (mpRoutingSender->ackSetVolumes(ackHandle, listAckVolumes, ackError))
+    {
+        mpControlSender->cbAckSetVolume(ackHandle, listAckVolumes, ackError);
+    }
 }
 
 void CAmRoutingReceiver::hookSinkNotificationDataChange(const am_sinkID_t sinkID, const am_NotificationPayload_s &payload)
 {
-    logInfo(__METHOD_NAME__, "sinkID=", sinkID, "type=", payload.type, "notificationValue=", payload.value);
+    AM_LOG_INFO(__METHOD_NAME__, "sinkID=", sinkID, "type=", payload.type, "notificationValue=", payload.value);
     mpControlSender->hookSinkNotificationDataChanged(sinkID, payload);
 }
 
 void CAmRoutingReceiver::hookSourceNotificationDataChange(const am_sourceID_t sourceID, const am_NotificationPayload_s &payload)
 {
-    logInfo(__METHOD_NAME__, "sinkID=", sourceID, "type=", payload.type, "notificationValue=", payload.value);
+    AM_LOG_INFO(__METHOD_NAME__, "sinkID=", sourceID, "type=", payload.type, "notificationValue=", payload.value);
     mpControlSender->hookSourceNotificationDataChanged(sourceID, payload);
 }
 
@@ -489,4 +630,104 @@ void CAmRoutingReceiver::waitOnRundown(bool rundown)
     mLastRundownError = E_OK;
 }
 
+void CAmRoutingReceiver::handleTimeout(const am_Handle_s handle)
+{
+    logWarning(__METHOD_NAME__, "handle=", handle);
+    mpControlSender->cbHandleTimeout(handle);
+}
+
+void CAmRoutingReceiver::setVolumeTickInterval(const uint32_t interval)
+{
+    mVolumeTickInterval = interval;
+    if (mVolumeTickTimer == 0)
+    {
+        return;
+    }
+
+    if (interval == 0)
+    {
+        // the ticks that wait are not held back any longer
+        mpSocketHandler->stopTimer(mVolumeTickTimer);
+        volumeTickTimer(mVolumeTickTimer, NULL);
+    }
+    else
+    {
+        timespec timeout;
+        timeout.tv_sec  = interval / 1000;
+        timeout.tv_nsec = (interval % 1000) * 1000000;
+        mpSocketHandler->updateTimer(mVolumeTickTimer, timeout);
+    }
+}
+
+void CAmRoutingReceiver::startVolumeTickTimer()
+{
+    if (mVolumeTickTimer == 0)
+    {
+        timespec timeout;
+        timeout.tv_sec  = mVolumeTickInterval / 1000;
+        timeout.tv_nsec = (mVolumeTickInterval % 1000) * 1000000;
+        if (mpSocketHandler->addTimer(timeout, std::bind(&CAmRoutingReceiver::volumeTickTimer, this, std::placeholders::_1, std::placeholders::_2), mVolumeTickTimer, NULL) != E_OK)
+        {
+            logError(__METHOD_NAME__, "could not create the timer, the ticks are forwarded when they come");
+            mVolumeTickTimer    = 0;
+            mVolumeTickInterval = 0;
+            volumeTickTimer(0, NULL);
+        }
+    }
+    else
+    {
+        mpSocketHandler->restartTimer(mVolumeTickTimer);
+    }
+}
+
+void CAmRoutingReceiver::flushVolumeTicks(const am_Handle_s handle)
+{
+    for (auto iter = mSinkVolumeTicks.begin(); iter != mSinkVolumeTicks.end();)
+    {
+        if ((iter->second.part.handle == handle.handle) && (iter->second.part.handleType == handle.handleType))
+        {
+            mpControlSender->hookSystemSinkVolumeTick(iter->second.handle, iter->first, iter->second.volume);
+            iter = mSinkVolumeTicks.erase(iter);
+        }
+        else
+        {
+            ++iter;
+        }
+    }
+
+    for (auto iter = mSourceVolumeTicks.begin(); iter != mSourceVolumeTicks.end();)
+    {
+        if ((iter->second.part.handle == handle.handle) && (iter->second.part.handleType == handle.handleType))
+        {
+            mpControlSender->hookSystemSourceVolumeTick(iter->second.handle, iter->first, iter->second.volume);
+            iter = mSourceVolumeTicks.erase(iter);
+        }
+        else
+        {
+            ++iter;
+        }
+    }
+}
+
+void CAmRoutingReceiver::volumeTickTimer(const sh_timerHandle_t handle, void *userData)
+{
+    (void)handle;
+    (void)userData;
+
+    // the maps are swapped out first, the controller may cause new ticks
+    std::map<am_sinkID_t, volumeTick_s>   sinkTicks;
+    std::map<am_sourceID_t, volumeTick_s> sourceTicks;
+    sinkTicks.swap(mSinkVolumeTicks);
+    sourceTicks.swap(mSourceVolumeTicks);
+    for (const auto &tick : sinkTicks)
+    {
+        mpControlSender->hookSystemSinkVolumeTick(tick.second.handle, tick.first, tick.second.volume);
+    }
+
+    for (const auto &tick : sourceTicks)
+    {
+        mpControlSender->hookSystemSourceVolumeTick(tick.second.handle, tick.first, tick.second.volume);
+    }
+}
+
 }
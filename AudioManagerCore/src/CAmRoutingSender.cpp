@@ -23,6 +23,8 @@
 
 #include "CAmRoutingSender.h"
 #include <utility>
+#include <algorithm>
+#include <functional>
 #include <dirent.h>
 #include <errno.h>
 #include <sys/stat.h>
@@ -32,6 +34,7 @@
 #include <iostream>
 #include <sstream>
 #include <stdexcept>
+#include <mutex>
 #include "CAmRoutingReceiver.h"
 #include "TAmPluginTemplate.h"
 #include "CAmDltWrapper.h"
@@ -45,20 +48,94 @@ namespace am
 
 #define __METHOD_NAME__ std::string(std::string("CAmRoutingSender::") + __func__)
 
+namespace
+{
+
+/**
+ * the blocks of the handle data pool, a bigger handle data class would come from the heap
+ */
+const std::size_t HANDLE_DATA_BLOCK_SIZE = 128;
+
+struct handleDataPool_s
+{
+    std::mutex          mutex;
+    std::vector<void *> freeBlocks; //!< the blocks are kept when they are released, the pool grows to the peak number of handles
+};
+
+handleDataPool_s &getHandleDataPool()
+{
+    // never destroyed, a handle might be released after the static objects are gone
+    static handleDataPool_s *pPool = new handleDataPool_s;
+    return (*pPool);
+}
+
+}
+
+void *CAmRoutingSender::handleDataBase::operator new(std::size_t size)
+{
+    if (size > HANDLE_DATA_BLOCK_SIZE)
+    {
+        return (::operator new(size));
+    }
+
+    handleDataPool_s           &pool(getHandleDataPool());
+    std::lock_guard<std::mutex> lock(pool.mutex);
+    if (pool.freeBlocks.empty())
+    {
+        return (::operator new(HANDLE_DATA_BLOCK_SIZE));
+    }
+
+    void *pBlock = pool.freeBlocks.back();
+    pool.freeBlocks.pop_back();
+    return (pBlock);
+}
+
+void CAmRoutingSender::handleDataBase::operator delete(void *pData, std::size_t size)
+{
+    if ((pData == NULL) || (size > HANDLE_DATA_BLOCK_SIZE))
+    {
+        ::operator delete(pData);
+        return;
+    }
+
+    handleDataPool_s           &pool(getHandleDataPool());
+    std::lock_guard<std::mutex> lock(pool.mutex);
+    pool.freeBlocks.push_back(pData);
+}
+
 CAmRoutingSender::CAmRoutingSender(
     const std::vector<std::string> &listOfPluginDirectories,
     IAmDatabaseHandler *databaseHandler)
-    : mHandleCount(0)
-    , mlistActiveHandles()
+    : mFirstFreeHandle(1)
+    , mLastFreeHandle(MAX_HANDLES - 1)
+    , mNumberOfHandles(0)
+    , mHandleWheel()
+    , mHandleWheelPosition(0)
+    , mNumberOfSupervisedHandles(0)
+    , mHandleWheelTimer(0)
+    , mVolumeCoalescing(false)
+    , mMapSinkVolumes()
+    , mMapSourceVolumes()
     , mListInterfaces()
-    , mMapConnectionInterface()
-    , mMapCrossfaderInterface()
-    , mMapDomainInterface()
-    , mMapSinkInterface()
-    , mMapSourceInterface()
+    , mCrossfaderInterfaces()
+    , mConnectionInterfaces()
+    , mDomainInterfaces()
+    , mSinkInterfaces()
+    , mSourceInterfaces()
     , mpRoutingReceiver()
     , mpDatabaseHandler(databaseHandler)
+    , mpSocketHandler(NULL)
 {
+    std::fill(mHandleTimeouts, mHandleTimeouts + H_MAX, 0);
+
+    // all slots but 0 are free, they are used in the order of the numbers
+    for (uint16_t i = 0; i < MAX_HANDLES; i++)
+    {
+        mHandleSlots[i].type       = H_UNKNOWN;
+        mHandleSlots[i].generation = 0;
+        mHandleSlots[i].nextFree   = ((i == 0) || (i == MAX_HANDLES - 1)) ? 0 : i + 1;
+        mHandleSlots[i].quarantined = false;
+    }
 
     loadPlugins(listOfPluginDirectories);
 
@@ -99,87 +176,22 @@ void CAmRoutingSender::loadPlugins(const std::vector<std::string> &listOfPluginD
         logError(__METHOD_NAME__, "List of routingplugins is empty");
     }
 
-    std::vector<std::string>                 sharedLibraryNameList;
-    std::vector<std::string>::const_iterator dirIter    = listOfPluginDirectories.begin();
-    std::vector<std::string>::const_iterator dirIterEnd = listOfPluginDirectories.end();
-
-    // search communicator plugins in configured directories
-    for (; dirIter < dirIterEnd; ++dirIter)
+    // the libraries are read ahead in parallel, they are opened, created and registered in the order of the names
+    std::vector<pluginLibrary_s<IAmRoutingSend> > listLibraries(openPluginLibraries<IAmRoutingSend>(findPluginLibraries(listOfPluginDirectories)));
+    for (pluginLibrary_s<IAmRoutingSend> &library : listLibraries)
     {
-        const char *directoryName = dirIter->c_str();
-        logInfo(__METHOD_NAME__, "Searching for HookPlugins in", directoryName);
-        DIR *directory = opendir(directoryName);
-
-        if (!directory)
+        if (!library.createFunction)
         {
-            logError(__METHOD_NAME__, "Error opening directory: ", directoryName);
+            logError(__METHOD_NAME__, "Entry point of RoutingPlugin not found", library.libname);
             continue;
         }
 
-        // iterate content of directory
-        struct dirent *itemInDirectory = 0;
-        while ((itemInDirectory = readdir(directory)))
-        {
-            unsigned char entryType = itemInDirectory->d_type;
-            std::string   entryName = itemInDirectory->d_name;
-            std::string   fullName  = *dirIter + "/" + entryName;
-
-            bool regularFile        = (entryType == DT_REG || entryType == DT_LNK);
-            bool sharedLibExtension = ("so" == entryName.substr(entryName.find_last_of(".") + 1));
-
-            // Handle cases where readdir() could not determine the file type
-            if (entryType == DT_UNKNOWN)
-            {
-                struct stat buf;
-
-                if (stat(fullName.c_str(), &buf))
-                {
-                    logInfo(__METHOD_NAME__, "Failed to stat file: ", entryName, errno);
-                    continue;
-                }
-
-                regularFile = S_ISREG(buf.st_mode);
-            }
-
-            if (regularFile && sharedLibExtension)
-            {
-                logInfo(__METHOD_NAME__, "adding file: ", entryName);
-                std::string name(directoryName);
-                sharedLibraryNameList.push_back(name + "/" + entryName);
-            }
-            else
-            {
-                logInfo(__METHOD_NAME__, "plugin search ignoring file :", entryName);
-            }
-        }
-
-        closedir(directory);
-    }
-
-    // iterate all communicator plugins and start them
-    std::vector<std::string>::iterator iter    = sharedLibraryNameList.begin();
-    std::vector<std::string>::iterator iterEnd = sharedLibraryNameList.end();
-
-    for (; iter != iterEnd; ++iter)
-    {
-        logInfo(__METHOD_NAME__, "try loading: ", *iter);
-
-        IAmRoutingSend *(*createFunc)();
-        void           *tempLibHandle = NULL;
-        createFunc = getCreateFunction<IAmRoutingSend *()>(*iter, tempLibHandle);
-
-        if (!createFunc)
-        {
-            logError(__METHOD_NAME__, "Entry point of RoutingPlugin not found");
-            continue;
-        }
-
-        IAmRoutingSend *router = createFunc();
+        IAmRoutingSend *router = createPlugin(library);
 
         if (!router)
         {
-            logError(__METHOD_NAME__, "initialization of plugin ", *iter, "failed. Entry Function not callable");
-            dlclose(tempLibHandle);
+            logError(__METHOD_NAME__, "initialization of plugin ", library.libname, "failed. Entry Function not callable");
+            dlclose(library.libraryHandle);
             continue;
         }
 
@@ -198,7 +210,7 @@ void CAmRoutingSender::loadPlugins(const std::vector<std::string> &listOfPluginD
         if (majorVersion < cMajorVersion || ((majorVersion == cMajorVersion) && (minorVersion > cMinorVersion)))
         {
             logError(__METHOD_NAME__, "Routing initialization failed. Version of Interface to old");
-            dlclose(tempLibHandle);
+            dlclose(library.libraryHandle);
             continue;
         }
 
@@ -206,25 +218,33 @@ void CAmRoutingSender::loadPlugins(const std::vector<std::string> &listOfPluginD
         router->returnBusName(routerInterface.busName);
         assert(!routerInterface.busName.empty());
         mListInterfaces.push_back(routerInterface);
-        mListLibraryHandles.push_back(tempLibHandle);
+        mListLibraryHandles.push_back(library.libraryHandle);
+        AM_LOG_INFO(__METHOD_NAME__, "loaded", library.libname, "in", library.loadTime, "us");
     }
 }
 
 CAmRoutingSender::~CAmRoutingSender()
 {
     // unloadLibraries();
-    HandlesMap::iterator it = mlistActiveHandles.begin();
+    std::vector<am_Handle_s> listHandles;
+    getListHandles(listHandles);
 
     // every open handle is assumed to be an error...
-    for (; it != mlistActiveHandles.end(); ++it)
+    for (const am_Handle_s &handle : listHandles)
     {
-        logError(__METHOD_NAME__, "The action for the handle", it->first, "is still open");
+        logError(__METHOD_NAME__, "The action for the handle", handle, "is still open");
+    }
+
+    if ((mpSocketHandler != NULL) && (mHandleWheelTimer != 0))
+    {
+        mpSocketHandler->removeTimer(mHandleWheelTimer);
     }
 }
 
 am_Error_e CAmRoutingSender::startupInterfaces(CAmRoutingReceiver *iRoutingReceiver)
 {
     mpRoutingReceiver = iRoutingReceiver;
+    mpRoutingReceiver->getSocketHandler(mpSocketHandler);
     am_Error_e returnError = E_OK;
 
     std::vector<InterfaceNamePairs>::iterator iter    = mListInterfaces.begin();
@@ -243,21 +263,39 @@ am_Error_e CAmRoutingSender::startupInterfaces(CAmRoutingReceiver *iRoutingRecei
 
 am_Error_e CAmRoutingSender::asyncAbort(const am_Handle_s &handle)
 {
-    auto iter(mlistActiveHandles.find(handle));
-    if (iter == mlistActiveHandles.end())
+    handleDataBase *pHandleData = findHandle(handle);
+    if (pHandleData == NULL)
     {
         logError(__METHOD_NAME__, "Could not find handle", handle);
         return (E_NON_EXISTENT);
     }
 
-    logInfo(__METHOD_NAME__, " handle", handle);
-    return (iter->second->returnInterface()->asyncAbort(handle));
+    AM_LOG_INFO(__METHOD_NAME__, " handle", handle);
+    if (abortWaitingVolume(handle))
+    {
+        return (E_OK);
+    }
+
+    if (pHandleData->returnInterface() == NULL)
+    {
+        // a batch of volumes is aborted by its parts
+        am_Error_e error(E_OK);
+        for (const am_Handle_s &part : getBatchParts(handle))
+        {
+            am_Error_e partError(findHandle(part)->returnInterface()->asyncAbort(part));
+            error = (error == E_OK) ? partError : error;
+        }
+
+        return (error);
+    }
+
+    return (pHandleData->returnInterface()->asyncAbort(handle));
 }
 
 am_Error_e CAmRoutingSender::asyncConnect(am_Handle_s &handle, am_connectionID_t &connectionID, const am_sourceID_t sourceID, const am_sinkID_t sinkID, const am_CustomConnectionFormat_t connectionFormat)
 {
-    auto iter(mMapSinkInterface.find(sinkID));
-    if (iter == mMapSinkInterface.end())
+    IAmRoutingSend *pRoutingInterface(mSinkInterfaces.find(sinkID));
+    if (pRoutingInterface == NULL)
     {
         logError(__METHOD_NAME__, "Could not find sink", sinkID);
         return (E_NON_EXISTENT);
@@ -267,7 +305,7 @@ am_Error_e CAmRoutingSender::asyncConnect(am_Handle_s &handle, am_connectionID_t
     {
         if (handle.handleType == am_Handle_e::H_CONNECT)
         {
-            logInfo(__METHOD_NAME__, "Resending for handle", handle);
+            AM_LOG_INFO(__METHOD_NAME__, "Resending for handle", handle);
         }
         else
         {
@@ -291,13 +329,12 @@ am_Error_e CAmRoutingSender::asyncConnect(am_Handle_s &handle, am_connectionID_t
             return(connError);
         }
 
-        mMapConnectionInterface.insert(std::make_pair(connectionID, iter->second));
-        auto handleData = std::make_shared<handleConnect>(iter->second, connectionID, mpDatabaseHandler);
-        handle = createHandle(handleData, am_Handle_e::H_CONNECT);
+        mConnectionInterfaces.insert(connectionID, pRoutingInterface);
+        handle = createHandle(new handleConnect(pRoutingInterface, connectionID, mpDatabaseHandler), am_Handle_e::H_CONNECT);
     }
 
-    logInfo(__METHOD_NAME__, "connectionID=", connectionID, "connectionFormat=", connectionFormat, "sourceID=", sourceID, "sinkID=", sinkID, "handle=", handle);
-    am_Error_e syncError(iter->second->asyncConnect(handle, connectionID, sourceID, sinkID, connectionFormat));
+    AM_LOG_INFO(__METHOD_NAME__, "connectionID=", connectionID, "connectionFormat=", connectionFormat, "sourceID=", sourceID, "sinkID=", sinkID, "handle=", handle);
+    am_Error_e syncError(pRoutingInterface->asyncConnect(handle, connectionID, sourceID, sinkID, connectionFormat));
     if (syncError)
     {
         removeHandle(handle);
@@ -310,8 +347,8 @@ am_Error_e CAmRoutingSender::asyncConnect(am_Handle_s &handle, am_connectionID_t
 
 am_Error_e CAmRoutingSender::asyncDisconnect(am_Handle_s &handle, const am_connectionID_t connectionID)
 {
-    auto iter(mMapConnectionInterface.find(connectionID));
-    if (iter == mMapConnectionInterface.end())
+    IAmRoutingSend *pRoutingInterface(mConnectionInterfaces.find(connectionID));
+    if (pRoutingInterface == NULL)
     {
         logError(__METHOD_NAME__, "Could not find connection", connectionID);
         return (E_NON_EXISTENT);
@@ -321,7 +358,7 @@ am_Error_e CAmRoutingSender::asyncDisconnect(am_Handle_s &handle, const am_conne
     {
         if (handle.handleType == am_Handle_e::H_DISCONNECT)
         {
-            logInfo(__METHOD_NAME__, "Resending for handle", handle);
+            AM_LOG_INFO(__METHOD_NAME__, "Resending for handle", handle);
         }
         else
         {
@@ -331,12 +368,11 @@ am_Error_e CAmRoutingSender::asyncDisconnect(am_Handle_s &handle, const am_conne
     }
     else
     {
-        auto handleData = std::make_shared<handleDisconnect>(iter->second, connectionID, mpDatabaseHandler, this);
-        handle = createHandle(handleData, am_Handle_e::H_DISCONNECT);
+        handle = createHandle(new handleDisconnect(pRoutingInterface, connectionID, mpDatabaseHandler, this), am_Handle_e::H_DISCONNECT);
     }
 
-    logInfo(__METHOD_NAME__, "connectionID=", connectionID, "handle=", handle);
-    am_Error_e syncError(iter->second->asyncDisconnect(handle, connectionID));
+    AM_LOG_INFO(__METHOD_NAME__, "connectionID=", connectionID, "handle=", handle);
+    am_Error_e syncError(pRoutingInterface->asyncDisconnect(handle, connectionID));
     if (syncError)
     {
         removeHandle(handle);
@@ -348,8 +384,8 @@ am_Error_e CAmRoutingSender::asyncDisconnect(am_Handle_s &handle, const am_conne
 
 am_Error_e CAmRoutingSender::asyncSetSinkVolume(am_Handle_s &handle, const am_sinkID_t sinkID, const am_volume_t volume, const am_CustomRampType_t ramp, const am_time_t time)
 {
-    auto iter(mMapSinkInterface.find(sinkID));
-    if (iter == mMapSinkInterface.end())
+    IAmRoutingSend *pRoutingInterface(mSinkInterfaces.find(sinkID));
+    if (pRoutingInterface == NULL)
     {
         logError(__METHOD_NAME__, "Could not find sink", sinkID);
         return (E_NON_EXISTENT);
@@ -359,7 +395,7 @@ am_Error_e CAmRoutingSender::asyncSetSinkVolume(am_Handle_s &handle, const am_si
     {
         if (handle.handleType == am_Handle_e::H_SETSINKVOLUME)
         {
-            logInfo(__METHOD_NAME__, "Resending for handle", handle);
+            AM_LOG_INFO(__METHOD_NAME__, "Resending for handle", handle);
         }
         else
         {
@@ -369,12 +405,21 @@ am_Error_e CAmRoutingSender::asyncSetSinkVolume(am_Handle_s &handle, const am_si
     }
     else
     {
-        auto handleData = std::make_shared<handleSinkVolume>(iter->second, sinkID, mpDatabaseHandler, volume);
-        handle = createHandle(handleData, H_SETSINKVOLUME);
+        if (mVolumeCoalescing && isVolumeInFlight(mMapSinkVolumes[sinkID]))
+        {
+            AM_LOG_INFO(__METHOD_NAME__, "sinkID=", sinkID, "volume=", volume, "waits for", mMapSinkVolumes[sinkID].inFlight);
+            return (queueVolume(mMapSinkVolumes[sinkID], new handleSinkVolume(pRoutingInterface, sinkID, mpDatabaseHandler, volume), H_SETSINKVOLUME, ramp, time, handle));
+        }
+
+        handle = createHandle(new handleSinkVolume(pRoutingInterface, sinkID, mpDatabaseHandler, volume), H_SETSINKVOLUME);
+        if (mVolumeCoalescing)
+        {
+            mMapSinkVolumes[sinkID].inFlight = handle;
+        }
     }
 
-    logInfo(__METHOD_NAME__, "sinkID=", sinkID, "volume=", volume, "ramp=", ramp, "time=", time, "handle=", handle);
-    am_Error_e syncError(iter->second->asyncSetSinkVolume(handle, sinkID, volume, ramp, time));
+    AM_LOG_INFO(__METHOD_NAME__, "sinkID=", sinkID, "volume=", volume, "ramp=", ramp, "time=", time, "handle=", handle);
+    am_Error_e syncError(pRoutingInterface->asyncSetSinkVolume(handle, sinkID, volume, ramp, time));
     if (syncError)
     {
         removeHandle(handle);
@@ -386,8 +431,8 @@ am_Error_e CAmRoutingSender::asyncSetSinkVolume(am_Handle_s &handle, const am_si
 
 am_Error_e CAmRoutingSender::asyncSetSourceVolume(am_Handle_s &handle, const am_sourceID_t sourceID, const am_volume_t volume, const am_CustomRampType_t ramp, const am_time_t time)
 {
-    auto iter(mMapSourceInterface.find(sourceID));
-    if (iter == mMapSourceInterface.end())
+    IAmRoutingSend *pRoutingInterface(mSourceInterfaces.find(sourceID));
+    if (pRoutingInterface == NULL)
     {
         logError(__METHOD_NAME__, "Could not find sourceID", sourceID);
         return (E_NON_EXISTENT);
@@ -397,7 +442,7 @@ am_Error_e CAmRoutingSender::asyncSetSourceVolume(am_Handle_s &handle, const am_
     {
         if (handle.handleType == am_Handle_e::H_SETSOURCEVOLUME)
         {
-            logInfo(__METHOD_NAME__, "Resending for handle", handle);
+            AM_LOG_INFO(__METHOD_NAME__, "Resending for handle", handle);
         }
         else
         {
@@ -407,12 +452,21 @@ am_Error_e CAmRoutingSender::asyncSetSourceVolume(am_Handle_s &handle, const am_
     }
     else
     {
-        auto handleData = std::make_shared<handleSourceVolume>(iter->second, sourceID, mpDatabaseHandler, volume);
-        handle = createHandle(handleData, H_SETSOURCEVOLUME);
+        if (mVolumeCoalescing && isVolumeInFlight(mMapSourceVolumes[sourceID]))
+        {
+            AM_LOG_INFO(__METHOD_NAME__, "sourceID=", sourceID, "volume=", volume, "waits for", mMapSourceVolumes[sourceID].inFlight);
+            return (queueVolume(mMapSourceVolumes[sourceID], new handleSourceVolume(pRoutingInterface, sourceID, mpDatabaseHandler, volume), H_SETSOURCEVOLUME, ramp, time, handle));
+        }
+
+        handle = createHandle(new handleSourceVolume(pRoutingInterface, sourceID, mpDatabaseHandler, volume), H_SETSOURCEVOLUME);
+        if (mVolumeCoalescing)
+        {
+            mMapSourceVolumes[sourceID].inFlight = handle;
+        }
     }
 
-    logInfo(__METHOD_NAME__, "sourceID=", sourceID, "volume=", volume, "ramp=", ramp, "time=", time, "handle=", handle);
-    am_Error_e syncError(iter->second->asyncSetSourceVolume(handle, sourceID, volume, ramp, time));
+    AM_LOG_INFO(__METHOD_NAME__, "sourceID=", sourceID, "volume=", volume, "ramp=", ramp, "time=", time, "handle=", handle);
+    am_Error_e syncError(pRoutingInterface->asyncSetSourceVolume(handle, sourceID, volume, ramp, time));
     if (syncError)
     {
         removeHandle(handle);
@@ -424,8 +478,8 @@ am_Error_e CAmRoutingSender::asyncSetSourceVolume(am_Handle_s &handle, const am_
 
 am_Error_e CAmRoutingSender::asyncSetSourceState(am_Handle_s &handle, const am_sourceID_t sourceID, const am_SourceState_e state)
 {
-    auto iter(mMapSourceInterface.find(sourceID));
-    if (iter == mMapSourceInterface.end())
+    IAmRoutingSend *pRoutingInterface(mSourceInterfaces.find(sourceID));
+    if (pRoutingInterface == NULL)
     {
         logError(__METHOD_NAME__, "Could not find sourceID", sourceID);
         return (E_NON_EXISTENT);
@@ -435,7 +489,7 @@ am_Error_e CAmRoutingSender::asyncSetSourceState(am_Handle_s &handle, const am_s
     {
         if (handle.handleType == am_Handle_e::H_SETSOURCESTATE)
         {
-            logInfo(__METHOD_NAME__, "Resending for handle", handle);
+            AM_LOG_INFO(__METHOD_NAME__, "Resending for handle", handle);
         }
         else
         {
@@ -445,12 +499,11 @@ am_Error_e CAmRoutingSender::asyncSetSourceState(am_Handle_s &handle, const am_s
     }
     else
     {
-        auto handleData = std::make_shared<handleSourceState>(iter->second, sourceID, state, mpDatabaseHandler);
-        handle = createHandle(handleData, H_SETSOURCESTATE);
+        handle = createHandle(new handleSourceState(pRoutingInterface, sourceID, state, mpDatabaseHandler), H_SETSOURCESTATE);
     }
 
-    logInfo(__METHOD_NAME__, "sourceID=", sourceID, "state=", state, "handle=", handle);
-    am_Error_e syncError(iter->second->asyncSetSourceState(handle, sourceID, state));
+    AM_LOG_INFO(__METHOD_NAME__, "sourceID=", sourceID, "state=", state, "handle=", handle);
+    am_Error_e syncError(pRoutingInterface->asyncSetSourceState(handle, sourceID, state));
     if (syncError)
     {
         removeHandle(handle);
@@ -462,8 +515,8 @@ am_Error_e CAmRoutingSender::asyncSetSourceState(am_Handle_s &handle, const am_s
 
 am_Error_e CAmRoutingSender::asyncSetSinkSoundProperty(am_Handle_s &handle, const am_sinkID_t sinkID, const am_SoundProperty_s &soundProperty)
 {
-    auto iter(mMapSinkInterface.find(sinkID));
-    if (iter == mMapSinkInterface.end())
+    IAmRoutingSend *pRoutingInterface(mSinkInterfaces.find(sinkID));
+    if (pRoutingInterface == NULL)
     {
         logError(__METHOD_NAME__, "Could not find sink", sinkID);
         return (E_NON_EXISTENT);
@@ -473,7 +526,7 @@ am_Error_e CAmRoutingSender::asyncSetSinkSoundProperty(am_Handle_s &handle, cons
     {
         if (handle.handleType == am_Handle_e::H_SETSINKSOUNDPROPERTY)
         {
-            logInfo(__METHOD_NAME__, "Resending for handle", handle);
+            AM_LOG_INFO(__METHOD_NAME__, "Resending for handle", handle);
         }
         else
         {
@@ -483,12 +536,11 @@ am_Error_e CAmRoutingSender::asyncSetSinkSoundProperty(am_Handle_s &handle, cons
     }
     else
     {
-        auto handleData = std::make_shared<handleSinkSoundProperty>(iter->second, sinkID, soundProperty, mpDatabaseHandler);
-        handle = createHandle(handleData, H_SETSINKSOUNDPROPERTY);
+        handle = createHandle(new handleSinkSoundProperty(pRoutingInterface, sinkID, soundProperty, mpDatabaseHandler), H_SETSINKSOUNDPROPERTY);
     }
 
-    logInfo(__METHOD_NAME__, "sinkID=", sinkID, "soundProperty.Type=", soundProperty.type, "soundProperty.value=", soundProperty.value, "handle=", handle);
-    am_Error_e syncError(iter->second->asyncSetSinkSoundProperty(handle, sinkID, soundProperty));
+    AM_LOG_INFO(__METHOD_NAME__, "sinkID=", sinkID, "soundProperty.Type=", soundProperty.type, "soundProperty.value=", soundProperty.value, "handle=", handle);
+    am_Error_e syncError(pRoutingInterface->asyncSetSinkSoundProperty(handle, sinkID, soundProperty));
     if (syncError)
     {
         removeHandle(handle);
@@ -500,8 +552,8 @@ am_Error_e CAmRoutingSender::asyncSetSinkSoundProperty(am_Handle_s &handle, cons
 
 am_Error_e CAmRoutingSender::asyncSetSourceSoundProperty(am_Handle_s &handle, const am_sourceID_t sourceID, const am_SoundProperty_s &soundProperty)
 {
-    auto iter(mMapSourceInterface.find(sourceID));
-    if (iter == mMapSourceInterface.end())
+    IAmRoutingSend *pRoutingInterface(mSourceInterfaces.find(sourceID));
+    if (pRoutingInterface == NULL)
     {
         logError(__METHOD_NAME__, "Could not find sourceID", sourceID);
         return (E_NON_EXISTENT);
@@ -511,7 +563,7 @@ am_Error_e CAmRoutingSender::asyncSetSourceSoundProperty(am_Handle_s &handle, co
     {
         if (handle.handleType == am_Handle_e::H_SETSOURCESOUNDPROPERTY)
         {
-            logInfo(__METHOD_NAME__, "Resending for handle", handle);
+            AM_LOG_INFO(__METHOD_NAME__, "Resending for handle", handle);
         }
         else
         {
@@ -521,12 +573,11 @@ am_Error_e CAmRoutingSender::asyncSetSourceSoundProperty(am_Handle_s &handle, co
     }
     else
     {
-        auto handleData = std::make_shared<handleSourceSoundProperty>(iter->second, sourceID, soundProperty, mpDatabaseHandler);
-        handle = createHandle(handleData, H_SETSOURCESOUNDPROPERTY);
+        handle = createHandle(new handleSourceSoundProperty(pRoutingInterface, sourceID, soundProperty, mpDatabaseHandler), H_SETSOURCESOUNDPROPERTY);
     }
 
-    logInfo(__METHOD_NAME__, "sourceID=", sourceID, "soundProperty.Type=", soundProperty.type, "soundProperty.value=", soundProperty.value, "handle=", handle);
-    am_Error_e syncError(iter->second->asyncSetSourceSoundProperty(handle, sourceID, soundProperty));
+    AM_LOG_INFO(__METHOD_NAME__, "sourceID=", sourceID, "soundProperty.Type=", soundProperty.type, "soundProperty.value=", soundProperty.value, "handle=", handle);
+    am_Error_e syncError(pRoutingInterface->asyncSetSourceSoundProperty(handle, sourceID, soundProperty));
     if (syncError)
     {
         removeHandle(handle);
@@ -538,8 +589,8 @@ am_Error_e CAmRoutingSender::asyncSetSourceSoundProperty(am_Handle_s &handle, co
 
 am_Error_e CAmRoutingSender::asyncSetSourceSoundProperties(am_Handle_s &handle, const std::vector<am_SoundProperty_s> &listSoundProperties, const am_sourceID_t sourceID)
 {
-    auto iter(mMapSourceInterface.find(sourceID));
-    if (iter == mMapSourceInterface.end())
+    IAmRoutingSend *pRoutingInterface(mSourceInterfaces.find(sourceID));
+    if (pRoutingInterface == NULL)
     {
         logError(__METHOD_NAME__, "Could not find sourceID", sourceID);
         return (E_NON_EXISTENT);
@@ -549,7 +600,7 @@ am_Error_e CAmRoutingSender::asyncSetSourceSoundProperties(am_Handle_s &handle,
     {
         if (handle.handleType == am_Handle_e::H_SETSOURCESOUNDPROPERTIES)
         {
-            logInfo(__METHOD_NAME__, "Resending for handle", handle);
+            AM_LOG_INFO(__METHOD_NAME__, "Resending for handle", handle);
         }
         else
         {
@@ -559,12 +610,11 @@ am_Error_e CAmRoutingSender::asyncSetSourceSoundProperties(am_Handle_s &handle,
     }
     else
     {
-        auto handleData = std::make_shared<handleSourceSoundProperties>(iter->second, sourceID, listSoundProperties, mpDatabaseHandler);
-        handle = createHandle(handleData, H_SETSOURCESOUNDPROPERTIES);
+        handle = createHandle(new handleSourceSoundProperties(pRoutingInterface, sourceID, listSoundProperties, mpDatabaseHandler), H_SETSOURCESOUNDPROPERTIES);
     }
 
-    logInfo(__METHOD_NAME__, "sourceID=", sourceID);
-    am_Error_e syncError(iter->second->asyncSetSourceSoundProperties(handle, sourceID, listSoundProperties));
+    AM_LOG_INFO(__METHOD_NAME__, "sourceID=", sourceID);
+    am_Error_e syncError(pRoutingInterface->asyncSetSourceSoundProperties(handle, sourceID, listSoundProperties));
     if (syncError)
     {
         removeHandle(handle);
@@ -576,8 +626,8 @@ am_Error_e CAmRoutingSender::asyncSetSourceSoundProperties(am_Handle_s &handle,
 
 am_Error_e CAmRoutingSender::asyncSetSinkSoundProperties(am_Handle_s &handle, const std::vector<am_SoundProperty_s> &listSoundProperties, const am_sinkID_t sinkID)
 {
-    auto iter(mMapSinkInterface.find(sinkID));
-    if (iter == mMapSinkInterface.end())
+    IAmRoutingSend *pRoutingInterface(mSinkInterfaces.find(sinkID));
+    if (pRoutingInterface == NULL)
     {
         logError(__METHOD_NAME__, "Could not find sink", sinkID);
         return (E_NON_EXISTENT);
@@ -587,7 +637,7 @@ am_Error_e CAmRoutingSender::asyncSetSinkSoundProperties(am_Handle_s &handle, co
     {
         if (handle.handleType == am_Handle_e::H_SETSINKSOUNDPROPERTIES)
         {
-            logInfo(__METHOD_NAME__, "Resending for handle", handle);
+            AM_LOG_INFO(__METHOD_NAME__, "Resending for handle", handle);
         }
         else
         {
@@ -597,12 +647,11 @@ am_Error_e CAmRoutingSender::asyncSetSinkSoundProperties(am_Handle_s &handle, co
     }
     else
     {
-        auto handleData = std::make_shared<handleSinkSoundProperties>(iter->second, sinkID, listSoundProperties, mpDatabaseHandler);
-        handle = createHandle(handleData, H_SETSINKSOUNDPROPERTIES);
+        handle = createHandle(new handleSinkSoundProperties(pRoutingInterface, sinkID, listSoundProperties, mpDatabaseHandler), H_SETSINKSOUNDPROPERTIES);
     }
 
-    logInfo(__METHOD_NAME__, "sinkID=", sinkID, "handle=", handle);
-    am_Error_e syncError(iter->second->asyncSetSinkSoundProperties(handle, sinkID, listSoundProperties));
+    AM_LOG_INFO(__METHOD_NAME__, "sinkID=", sinkID, "handle=", handle);
+    am_Error_e syncError(pRoutingInterface->asyncSetSinkSoundProperties(handle, sinkID, listSoundProperties));
     if (syncError)
     {
         removeHandle(handle);
@@ -614,8 +663,8 @@ am_Error_e CAmRoutingSender::asyncSetSinkSoundProperties(am_Handle_s &handle, co
 
 am_Error_e CAmRoutingSender::asyncCrossFade(am_Handle_s &handle, const am_crossfaderID_t crossfaderID, const am_HotSink_e hotSink, const am_CustomRampType_t rampType, const am_time_t time)
 {
-    auto iter(mMapCrossfaderInterface.find(crossfaderID));
-    if (iter == mMapCrossfaderInterface.end())
+    IAmRoutingSend *pRoutingInterface(mCrossfaderInterfaces.find(crossfaderID));
+    if (pRoutingInterface == NULL)
     {
         logError(__METHOD_NAME__, "Could not find crossfaderID", crossfaderID);
         return (E_NON_EXISTENT);
@@ -625,7 +674,7 @@ am_Error_e CAmRoutingSender::asyncCrossFade(am_Handle_s &handle, const am_crossf
     {
         if (handle.handleType == am_Handle_e::H_CROSSFADE)
         {
-            logInfo(__METHOD_NAME__, "Resending for handle", handle);
+            AM_LOG_INFO(__METHOD_NAME__, "Resending for handle", handle);
         }
         else
         {
@@ -635,12 +684,11 @@ am_Error_e CAmRoutingSender::asyncCrossFade(am_Handle_s &handle, const am_crossf
     }
     else
     {
-        auto handleData = std::make_shared<handleCrossFader>(iter->second, crossfaderID, hotSink, mpDatabaseHandler);
-        handle = createHandle(handleData, H_CROSSFADE);
+        handle = createHandle(new handleCrossFader(pRoutingInterface, crossfaderID, hotSink, mpDatabaseHandler), H_CROSSFADE);
     }
 
-    logInfo(__METHOD_NAME__, "hotSource=", hotSink, "crossfaderID=", crossfaderID, "rampType=", rampType, "rampTime=", time, "handle=", handle);
-    am_Error_e syncError(iter->second->asyncCrossFade(handle, crossfaderID, hotSink, rampType, time));
+    AM_LOG_INFO(__METHOD_NAME__, "hotSource=", hotSink, "crossfaderID=", crossfaderID, "rampType=", rampType, "rampTime=", time, "handle=", handle);
+    am_Error_e syncError(pRoutingInterface->asyncCrossFade(handle, crossfaderID, hotSink, rampType, time));
     if (syncError)
     {
         removeHandle(handle);
@@ -651,12 +699,11 @@ am_Error_e CAmRoutingSender::asyncCrossFade(am_Handle_s &handle, const am_crossf
 
 am_Error_e CAmRoutingSender::setDomainState(const am_domainID_t domainID, const am_DomainState_e domainState)
 {
-    logInfo(__METHOD_NAME__, "domainID=", domainID, "domainState=", domainState);
-    DomainInterfaceMap::iterator iter = mMapDomainInterface.begin();
-    iter = mMapDomainInterface.find(domainID);
-    if (iter != mMapDomainInterface.end())
+    AM_LOG_INFO(__METHOD_NAME__, "domainID=", domainID, "domainState=", domainState);
+    IAmRoutingSend *pRoutingInterface(mDomainInterfaces.find(domainID));
+    if (pRoutingInterface != NULL)
     {
-        return (iter->second->setDomainState(domainID, domainState));
+        return (pRoutingInterface->setDomainState(domainID, domainState));
     }
 
     return (E_NON_EXISTENT);
@@ -675,7 +722,7 @@ am_Error_e CAmRoutingSender::addDomainLookup(const am_Domain_s &domainData)
     {
         if ((*iter).busName.compare(domainData.busname) == 0)
         {
-            mMapDomainInterface.insert(std::make_pair(domainData.domainID, (*iter).routingInterface));
+            mDomainInterfaces.insert(domainData.domainID, (*iter).routingInterface);
             return (E_OK);
         }
     }
@@ -691,11 +738,10 @@ am_Error_e CAmRoutingSender::addDomainLookup(const am_Domain_s &domainData)
  */
 am_Error_e CAmRoutingSender::addSourceLookup(const am_Source_s &sourceData)
 {
-    DomainInterfaceMap::iterator iter = mMapDomainInterface.begin();
-    iter = mMapDomainInterface.find(sourceData.domainID);
-    if (iter != mMapDomainInterface.end())
+    IAmRoutingSend *pRoutingInterface(mDomainInterfaces.find(sourceData.domainID));
+    if (pRoutingInterface != NULL)
     {
-        mMapSourceInterface.insert(std::make_pair(sourceData.sourceID, iter->second));
+        mSourceInterfaces.insert(sourceData.sourceID, pRoutingInterface);
         return (E_OK);
     }
 
@@ -710,11 +756,10 @@ am_Error_e CAmRoutingSender::addSourceLookup(const am_Source_s &sourceData)
  */
 am_Error_e CAmRoutingSender::addSinkLookup(const am_Sink_s &sinkData)
 {
-    DomainInterfaceMap::iterator iter = mMapDomainInterface.begin();
-    iter = mMapDomainInterface.find(sinkData.domainID);
-    if (iter != mMapDomainInterface.end())
+    IAmRoutingSend *pRoutingInterface(mDomainInterfaces.find(sinkData.domainID));
+    if (pRoutingInterface != NULL)
     {
-        mMapSinkInterface.insert(std::make_pair(sinkData.sinkID, iter->second));
+        mSinkInterfaces.insert(sinkData.sinkID, pRoutingInterface);
         return (E_OK);
     }
 
@@ -729,11 +774,10 @@ am_Error_e CAmRoutingSender::addSinkLookup(const am_Sink_s &sinkData)
  */
 am_Error_e CAmRoutingSender::addCrossfaderLookup(const am_Crossfader_s &crossfaderData)
 {
-    DomainInterfaceMap::iterator iter = mMapSourceInterface.begin();
-    iter = mMapSourceInterface.find(crossfaderData.sourceID);
-    if (iter != mMapSourceInterface.end())
+    IAmRoutingSend *pRoutingInterface(mSourceInterfaces.find(crossfaderData.sourceID));
+    if (pRoutingInterface != NULL)
     {
-        mMapSourceInterface.insert(std::make_pair(crossfaderData.crossfaderID, iter->second));
+        mCrossfaderInterfaces.insert(crossfaderData.crossfaderID, pRoutingInterface);
         return (E_OK);
     }
 
@@ -747,11 +791,8 @@ am_Error_e CAmRoutingSender::addCrossfaderLookup(const am_Crossfader_s &crossfad
  */
 am_Error_e CAmRoutingSender::removeDomainLookup(const am_domainID_t domainID)
 {
-    DomainInterfaceMap::iterator iter = mMapDomainInterface.begin();
-    iter = mMapDomainInterface.find(domainID);
-    if (iter != mMapDomainInterface.end())
+    if (mDomainInterfaces.erase(domainID))
     {
-        mMapDomainInterface.erase(iter);
         return (E_OK);
     }
 
@@ -764,11 +805,8 @@ am_Error_e CAmRoutingSender::removeDomainLookup(const am_domainID_t domainID)
  */
 am_Error_e CAmRoutingSender::removeSourceLookup(const am_sourceID_t sourceID)
 {
-    SourceInterfaceMap::iterator iter = mMapSourceInterface.begin();
-    iter = mMapSourceInterface.find(sourceID);
-    if (iter != mMapSourceInterface.end())
+    if (mSourceInterfaces.erase(sourceID))
     {
-        mMapSourceInterface.erase(iter);
         return (E_OK);
     }
 
@@ -781,11 +819,8 @@ am_Error_e CAmRoutingSender::removeSourceLookup(const am_sourceID_t sourceID)
  */
 am_Error_e CAmRoutingSender::removeSinkLookup(const am_sinkID_t sinkID)
 {
-    SinkInterfaceMap::iterator iter = mMapSinkInterface.begin();
-    iter = mMapSinkInterface.find(sinkID);
-    if (iter != mMapSinkInterface.end())
+    if (mSinkInterfaces.erase(sinkID))
     {
-        mMapSinkInterface.erase(iter);
         return (E_OK);
     }
 
@@ -798,11 +833,8 @@ am_Error_e CAmRoutingSender::removeSinkLookup(const am_sinkID_t sinkID)
  */
 am_Error_e CAmRoutingSender::removeCrossfaderLookup(const am_crossfaderID_t crossfaderID)
 {
-    CrossfaderInterfaceMap::iterator iter = mMapCrossfaderInterface.begin();
-    iter = mMapCrossfaderInterface.find(crossfaderID);
-    if (iter != mMapCrossfaderInterface.end())
+    if (mCrossfaderInterfaces.erase(crossfaderID))
     {
-        mMapCrossfaderInterface.erase(iter);
         return (E_OK);
     }
 
@@ -816,8 +848,9 @@ am_Error_e CAmRoutingSender::removeCrossfaderLookup(const am_crossfaderID_t cros
  */
 am_Error_e CAmRoutingSender::removeHandle(const am_Handle_s &handle)
 {
-    if (mlistActiveHandles.erase(handle))
+    if (findHandle(handle) != NULL)
     {
+        freeHandle(handle, false);
         return (E_OK);
     }
 
@@ -825,13 +858,76 @@ am_Error_e CAmRoutingSender::removeHandle(const am_Handle_s &handle)
     return (E_NON_EXISTENT);
 }
 
+/**
+ * @param handle must be open
+ * @param quarantine true if the number must not be used again until the quarantine is over
+ */
+void CAmRoutingSender::freeHandle(const am_Handle_s handle, const bool quarantine)
+{
+    // the data is destroyed when the table is consistent again, its destructor may change the database
+    handleSlot_s                   &slot(mHandleSlots[handle.handle]);
+    std::unique_ptr<handleDataBase> pHandleData(std::move(slot.data));
+    mNumberOfHandles--;
+    if (quarantine)
+    {
+        slot.quarantined = true;
+        addWheelEntry(handle.handle, HANDLE_QUARANTINE, true);
+    }
+    else
+    {
+        slot.type = H_UNKNOWN;
+        appendFreeSlot(handle.handle);
+    }
+
+    if (!mMapSinkVolumes.empty() || !mMapSourceVolumes.empty())
+    {
+        releaseVolume(handle, pHandleData.get());
+    }
+}
+
+void CAmRoutingSender::appendFreeSlot(const uint16_t handle)
+{
+    mHandleSlots[handle].nextFree = 0;
+    if (mFirstFreeHandle == 0)
+    {
+        mFirstFreeHandle = handle;
+    }
+    else
+    {
+        mHandleSlots[mLastFreeHandle].nextFree = handle;
+    }
+
+    mLastFreeHandle = handle;
+}
+
+bool CAmRoutingSender::dropLateAcknowledge(const am_Handle_s handle)
+{
+    handleSlot_s &slot(mHandleSlots[handle.handle]);
+    if ((handle.handle == 0) || !slot.quarantined || (slot.type != handle.handleType))
+    {
+        return (false);
+    }
+
+    logWarning(__METHOD_NAME__, "dropping the late acknowledge of handle", handle);
+    slot.quarantined = false;
+    slot.type        = H_UNKNOWN;
+    appendFreeSlot(handle.handle);
+    return (true);
+}
+
 am_Error_e CAmRoutingSender::getListHandles(std::vector<am_Handle_s> &listHandles) const
 {
     listHandles.clear();
-    HandlesMap::const_iterator it = mlistActiveHandles.begin();
-    for (; it != mlistActiveHandles.end(); ++it)
+    listHandles.reserve(mNumberOfHandles);
+    for (uint16_t i = 1; (i < MAX_HANDLES) && (listHandles.size() < mNumberOfHandles); i++)
     {
-        listHandles.push_back(it->first);
+        if (mHandleSlots[i].data)
+        {
+            am_Handle_s handle;
+            handle.handleType = mHandleSlots[i].type;
+            handle.handle     = i;
+            listHandles.push_back(handle);
+        }
     }
 
     return (E_OK);
@@ -843,37 +939,401 @@ am_Error_e CAmRoutingSender::getListHandles(std::vector<am_Handle_s> &listHandle
  * @param type the type of handle to be created
  * @return the handle
  */
-am_Handle_s CAmRoutingSender::createHandle(std::shared_ptr<handleDataBase> handleData, const am_Handle_e type)
+am_Handle_s CAmRoutingSender::createHandle(handleDataBase *handleData, const am_Handle_e type, const bool supervised)
 {
     am_Handle_s handle;
     handle.handleType = type;
+    handle.handle     = mFirstFreeHandle;
+    if (handle.handle == 0)
+    {
+        logError(__METHOD_NAME__, "could not create new handle, all handles in use!");
+        delete handleData;
+        return (handle);
+    }
+
+    handleSlot_s &slot(mHandleSlots[handle.handle]);
+    mFirstFreeHandle = slot.nextFree;
+    slot.data.reset(handleData);
+    slot.type = type;
+    slot.generation++;
+    if (++mNumberOfHandles > 100)
+    {
+        AM_LOG_WARNING(__METHOD_NAME__, "too many open handles, number of handles: ", mNumberOfHandles);
+    }
+
+    AM_LOG_INFO(__METHOD_NAME__, handle.handle, handle.handleType);
+    if (supervised)
+    {
+        superviseHandle(handle);
+    }
+
+    return (handle);
+}
+
+/**
+ * looks up the data of a handle
+ * @param handle the number and the type have to match
+ * @return the data or NULL if the handle is not open
+ */
+CAmRoutingSender::handleDataBase *CAmRoutingSender::findHandle(const am_Handle_s handle) const
+{
+    const handleSlot_s &slot(mHandleSlots[handle.handle]);
+    if ((handle.handle == 0) || (slot.type != handle.handleType))
+    {
+        return (NULL);
+    }
+
+    return (slot.data.get());
+}
+
+void CAmRoutingSender::setVolumeCoalescing(const bool enable)
+{
+    // when it is switched off, the changes that wait are still sent
+    mVolumeCoalescing = enable;
+}
+
+bool CAmRoutingSender::isVolumeInFlight(const volumeCoalescing_s &coalescing) const
+{
+    return ((coalescing.inFlight.handle != 0) && (findHandle(coalescing.inFlight) != NULL));
+}
+
+/**
+ * lets a volume change wait for the one that runs
+ * @param coalescing the changes of the sink or source
+ * @param handleData the data of the new change, the ownership is taken
+ * @param type H_SETSINKVOLUME or H_SETSOURCEVOLUME
+ * @param ramp
+ * @param time
+ * @param handle the handle of the waiting change
+ * @return E_OK or E_NOT_POSSIBLE if there is no handle left
+ */
+am_Error_e CAmRoutingSender::queueVolume(volumeCoalescing_s &coalescing, handleVolumeBase *handleData, const am_Handle_e type, const am_CustomRampType_t ramp, const am_time_t time, am_Handle_s &handle)
+{
+    handleVolumeBase *pPending = (coalescing.pending.handle != 0) ? static_cast<handleVolumeBase *>(findHandle(coalescing.pending)) : NULL;
+    if (pPending != NULL)
+    {
+        // only the newest target is sent, the controller gets the handle of the waiting change again
+        pPending->setVolume(handleData->returnVolume());
+        delete handleData;
+        handle = coalescing.pending;
+    }
+    else
+    {
+        // the timeout starts when the change is sent
+        handle             = createHandle(handleData, type, false);
+        coalescing.pending = handle;
+    }
+
+    coalescing.ramp = ramp;
+    coalescing.time = time;
+    return ((handle.handle != 0) ? E_OK : E_NOT_POSSIBLE);
+}
+
+/**
+ * is called when a volume handle was removed. If it was the running change of its sink or source, the waiting change
+ * is sent. A sync error of it is reported to the controller like an acknowledge.
+ */
+void CAmRoutingSender::releaseVolume(const am_Handle_s handle, handleDataBase *handleData)
+{
+    volumeCoalescing_s *pCoalescing = findCoalescing(handle, handleData);
+    if (pCoalescing == NULL)
+    {
+        return;
+    }
+
+    if (pCoalescing->pending.handle == handle.handle)
+    {
+        pCoalescing->pending = am_Handle_s();
+        return;
+    }
+
+    if (pCoalescing->inFlight.handle != handle.handle)
+    {
+        return;
+    }
+
+    const am_Handle_s pending(pCoalescing->pending);
+    pCoalescing->inFlight = pending;
+    pCoalescing->pending  = am_Handle_s();
+    handleVolumeBase *pPending = (pending.handle != 0) ? static_cast<handleVolumeBase *>(findHandle(pending)) : NULL;
+    if (pPending == NULL)
+    {
+        return;
+    }
+
+    const am_volume_t volume(pPending->returnVolume());
+    am_Error_e        syncError(E_NOT_POSSIBLE);
+    if (pending.handleType == H_SETSINKVOLUME)
+    {
+        const am_sinkID_t sinkID(static_cast<handleSinkVolume *>(pPending)->returnSinkID());
+        AM_LOG_INFO(__METHOD_NAME__, "sinkID=", sinkID, "volume=", volume, "handle=", pending);
+        syncError = pPending->returnInterface()->asyncSetSinkVolume(pending, sinkID, volume, pCoalescing->ramp, pCoalescing->time);
+    }
+    else
+    {
+        const am_sourceID_t sourceID(static_cast<handleSourceVolume *>(pPending)->returnSourceID());
+        AM_LOG_INFO(__METHOD_NAME__, "sourceID=", sourceID, "volume=", volume, "handle=", pending);
+        syncError = pPending->returnInterface()->asyncSetSourceVolume(pending, sourceID, volume, pCoalescing->ramp, pCoalescing->time);
+    }
+
+    if (syncError == E_OK)
+    {
+        superviseHandle(pending);
+    }
+    else if (mpRoutingReceiver != NULL)
+    {
+        logError(__METHOD_NAME__, "Error while sending the waiting volume of handle", pending, "error", syncError);
+        if (pending.handleType == H_SETSINKVOLUME)
+        {
+            mpRoutingReceiver->ackSetSinkVolumeChange(pending, volume, syncError);
+        }
+        else
+        {
+            mpRoutingReceiver->ackSetSourceVolumeChange(pending, volume, syncError);
+        }
+    }
+}
+
+/**
+ * @return the changes of the sink or source of the volume handle, NULL if there are none
+ */
+CAmRoutingSender::volumeCoalescing_s *CAmRoutingSender::findCoalescing(const am_Handle_s handle, handleDataBase *handleData)
+{
+    if (handle.handleType == H_SETSINKVOLUME)
+    {
+        auto iter(mMapSinkVolumes.find(static_cast<handleSinkVolume *>(handleData)->returnSinkID()));
+        return ((iter != mMapSinkVolumes.end()) ? &iter->second : NULL);
+    }
+
+    if (handle.handleType == H_SETSOURCEVOLUME)
+    {
+        auto iter(mMapSourceVolumes.find(static_cast<handleSourceVolume *>(handleData)->returnSourceID()));
+        return ((iter != mMapSourceVolumes.end()) ? &iter->second : NULL);
+    }
+
+    return (NULL);
+}
+
+/**
+ * A waiting change was never sent to the routing plugin, so it is aborted here. The controller gets the acknowledge
+ * with E_ABORTED and the handle is removed.
+ * @return false if the handle is no waiting volume change
+ */
+bool CAmRoutingSender::abortWaitingVolume(const am_Handle_s handle)
+{
+    handleDataBase     *pHandleData = findHandle(handle);
+    volumeCoalescing_s *pCoalescing = (pHandleData != NULL) ? findCoalescing(handle, pHandleData) : NULL;
+    if ((pCoalescing == NULL) || (pCoalescing->pending.handle != handle.handle))
+    {
+        return (false);
+    }
 
-    for (int checkOverflow = 0; checkOverflow < 1024; checkOverflow++)
+    const am_volume_t volume(static_cast<handleVolumeBase *>(pHandleData)->returnVolume());
+    AM_LOG_INFO(__METHOD_NAME__, "handle=", handle, "volume=", volume);
+    if (mpRoutingReceiver == NULL)
+    {
+        removeHandle(handle);
+    }
+    else if (handle.handleType == H_SETSINKVOLUME)
+    {
+        mpRoutingReceiver->ackSetSinkVolumeChange(handle, volume, E_ABORTED);
+    }
+    else
     {
-        if (++mHandleCount >= 1024) // defined by 10 bit (out if structure!)
+        mpRoutingReceiver->ackSetSourceVolumeChange(handle, volume, E_ABORTED);
+    }
+
+    return (true);
+}
+
+am_Error_e CAmRoutingSender::setHandleTimeout(const am_Handle_e type, const uint32_t timeout)
+{
+    if ((type <= H_UNKNOWN) || (type >= H_MAX))
+    {
+        logError(__METHOD_NAME__, "invalid handle type", type);
+        return (E_OUT_OF_RANGE);
+    }
+
+    mHandleTimeouts[type] = timeout;
+    return (E_OK);
+}
+
+/**
+ * One timer turns the wheel, a handle only costs an entry in the slot it expires in. The entries are not removed when
+ * the handle is acknowledged, the generation tells when the slot was given to a new handle in the meantime.
+ * @param handle the handle that was just created
+ */
+void CAmRoutingSender::superviseHandle(const am_Handle_s handle)
+{
+    const uint32_t timeout = mHandleTimeouts[handle.handleType];
+    if ((timeout == 0) || (mpSocketHandler == NULL))
+    {
+        return;
+    }
+
+    // the parts of a batch of volumes are supervised by the batch
+    if ((handle.handleType == H_SETVOLUMES) && (static_cast<handleSetVolumes *>(mHandleSlots[handle.handle].data.get())->returnBatch().handle != 0))
+    {
+        return;
+    }
+
+    addWheelEntry(handle.handle, timeout, false);
+}
+
+/**
+ * @param handle the number of the handle
+ * @param timeout in ms
+ * @param quarantine true if the entry ends the quarantine of the number
+ */
+void CAmRoutingSender::addWheelEntry(const uint16_t handle, const uint32_t timeout, const bool quarantine)
+{
+    if (mpSocketHandler == NULL)
+    {
+        return;
+    }
+
+    const uint32_t  ticks = std::max((timeout + HANDLE_WHEEL_TICK - 1) / HANDLE_WHEEL_TICK, 1u);
+    handleTimeout_s entry;
+    entry.handle     = handle;
+    entry.generation = mHandleSlots[handle].generation;
+    entry.rounds     = (ticks - 1) / HANDLE_WHEEL_SLOTS;
+    entry.quarantine = quarantine;
+    mHandleWheel[(mHandleWheelPosition + ticks) % HANDLE_WHEEL_SLOTS].push_back(entry);
+
+    // the timer only runs while there are entries
+    if (mNumberOfSupervisedHandles++ > 0)
+    {
+        return;
+    }
+
+    if (mHandleWheelTimer == 0)
+    {
+        timespec tick;
+        tick.tv_sec  = HANDLE_WHEEL_TICK / 1000;
+        tick.tv_nsec = (HANDLE_WHEEL_TICK % 1000) * 1000000;
+        if (mpSocketHandler->addTimer(tick, std::bind(&CAmRoutingSender::handleWheelTick, this, std::placeholders::_1, std::placeholders::_2), mHandleWheelTimer, NULL) != E_OK)
+        {
+            logError(__METHOD_NAME__, "could not create the timer, the handles are not supervised");
+            mHandleWheelTimer = 0;
+        }
+    }
+    else
+    {
+        mpSocketHandler->restartTimer(mHandleWheelTimer);
+    }
+}
+
+void CAmRoutingSender::handleWheelTick(const sh_timerHandle_t handle, void *userData)
+{
+    (void)handle;
+    (void)userData;
+    mHandleWheelPosition = (mHandleWheelPosition + 1) % HANDLE_WHEEL_SLOTS;
+    std::vector<handleTimeout_s> &wheelSlot(mHandleWheel[mHandleWheelPosition]);
+    std::vector<am_Handle_s>      listExpired;
+    for (size_t i = 0; i < wheelSlot.size();)
+    {
+        handleTimeout_s    &entry(wheelSlot[i]);
+        handleSlot_s       &slot(mHandleSlots[entry.handle]);
+        const bool          stale = (entry.quarantine ? !slot.quarantined : !slot.data) || (slot.generation != entry.generation);
+        if (!stale && (entry.rounds > 0))
+        {
+            entry.rounds--;
+            i++;
+            continue;
+        }
+
+        if (!stale && entry.quarantine)
         {
-            mHandleCount = 1;
+            // no late acknowledge came, the number can be used again
+            slot.quarantined = false;
+            slot.type        = H_UNKNOWN;
+            appendFreeSlot(entry.handle);
+        }
+        else if (!stale)
+        {
+            am_Handle_s expired;
+            expired.handleType = slot.type;
+            expired.handle     = entry.handle;
+            listExpired.push_back(expired);
+        }
+
+        entry = wheelSlot.back();
+        wheelSlot.pop_back();
+        mNumberOfSupervisedHandles--;
+    }
+
+    // the callbacks may create handles, so the wheel is not touched anymore
+    for (const am_Handle_s &expired : listExpired)
+    {
+        handleDataBase *pHandleData = findHandle(expired);
+        if (pHandleData == NULL)
+        {
+            continue;
         }
 
-        handle.handle = mHandleCount;
+        logError(__METHOD_NAME__, "no acknowledge in time for handle", expired, "aborting it");
+        const uint16_t generation(mHandleSlots[expired.handle].generation);
+        std::vector<am_Handle_s> listParts(getBatchParts(expired));
+        std::vector<uint16_t>    listPartGenerations;
+        for (const am_Handle_s &part : listParts)
+        {
+            listPartGenerations.push_back(mHandleSlots[part.handle].generation);
+        }
 
-        if ( mlistActiveHandles.find(handle) == mlistActiveHandles.end())
+        // the plugin may acknowledge the abort right away, such handles are closed already
+        asyncAbort(expired);
+        for (size_t i = 0; i < listParts.size(); i++)
         {
-            mlistActiveHandles.insert(std::make_pair(handle, handleData));
-            if (mlistActiveHandles.size() > 100)
+            if ((findHandle(listParts[i]) != NULL) && (mHandleSlots[listParts[i].handle].generation == listPartGenerations[i]))
             {
-                logWarning(__METHOD_NAME__, "too many open handles, number of handles: ", mlistActiveHandles.size());
+                freeHandle(listParts[i], true);
             }
+        }
 
-            logInfo(__METHOD_NAME__, handle.handle, handle.handleType);
-            return (handle);
+        if ((findHandle(expired) == NULL) || (mHandleSlots[expired.handle].generation != generation))
+        {
+            continue;
+        }
+
+        freeHandle(expired, true);
+        if (mpRoutingReceiver != NULL)
+        {
+            mpRoutingReceiver->handleTimeout(expired);
         }
     }
 
-    logError(__METHOD_NAME__, "could not create new handle, all handles in use!");
-    handle.handle = 0;
+    if (mNumberOfSupervisedHandles > 0)
+    {
+        mpSocketHandler->restartTimer(mHandleWheelTimer);
+    }
+}
 
-    return(handle);
+/**
+ * @param handle the handle of a batch of volumes
+ * @return the open parts of the batch, empty if the handle is no batch
+ */
+std::vector<am_Handle_s> CAmRoutingSender::getBatchParts(const am_Handle_s handle) const
+{
+    std::vector<am_Handle_s> listParts;
+    handleDataBase          *pHandleData = findHandle(handle);
+    if ((handle.handleType != H_SETVOLUMES) || (pHandleData == NULL) || (pHandleData->returnInterface() != NULL))
+    {
+        return (listParts);
+    }
+
+    for (uint16_t i = 1; i < MAX_HANDLES; i++)
+    {
+        const handleSlot_s &slot(mHandleSlots[i]);
+        if (slot.data && (slot.type == H_SETVOLUMES) && (static_cast<handleSetVolumes *>(slot.data.get())->returnBatch().handle == handle.handle))
+        {
+            am_Handle_s part;
+            part.handleType = H_SETVOLUMES;
+            part.handle     = i;
+            listParts.push_back(part);
+        }
+    }
+
+    return (listParts);
 }
 
 void CAmRoutingSender::setRoutingReady()
@@ -884,7 +1344,7 @@ void CAmRoutingSender::setRoutingReady()
     std::vector<uint16_t> listStartupHandles;
     for (size_t i = 0; i < mListInterfaces.size(); i++)
     {
-        listStartupHandles.push_back(mpRoutingReceiver->getStartupHandle());
+        listStartupHandles.push_back(mpRoutingReceiver->getStartupHandle(mListInterfaces[i].busName));
     }
 
     // set the receiver ready to wait for replies
@@ -921,66 +1381,123 @@ void CAmRoutingSender::setRoutingRundown()
     }
 }
 
+/**
+ * The volumes are split by the interface that owns the sink or source. If all belong to one interface, the list is sent
+ * as it is. Otherwise every interface gets its part with a handle of its own, the controller only sees the handle of
+ * the batch and gets one acknowledge when all parts are acknowledged.
+ */
 am_Error_e CAmRoutingSender::asyncSetVolumes(am_Handle_s &handle, const std::vector<am_Volumes_s> &listVolumes)
 {
-    IAmRoutingSend *pRoutingInterface(NULL);
     if (listVolumes.empty())
     {
         return (E_NOT_POSSIBLE);
     }
 
-    // we need an interface so lets get either the sink or source ID from the first entry in the listVolumes
-    if (listVolumes[0].volumeType == VT_SINK)
+    std::vector<std::pair<IAmRoutingSend *, std::vector<am_Volumes_s> > > listParts;
+    for (const am_Volumes_s &volume : listVolumes)
     {
-        am_sinkID_t                sinkID = listVolumes[0].volumeID.sink;
-        SinkInterfaceMap::iterator iter   = mMapSinkInterface.begin();
-        iter = mMapSinkInterface.find(sinkID);
-        if (iter != mMapSinkInterface.end())
+        IAmRoutingSend *pRoutingInterface(NULL);
+        if (volume.volumeType == VT_SINK)
         {
-            pRoutingInterface = iter->second;
+            pRoutingInterface = mSinkInterfaces.find(volume.volumeID.sink);
         }
-        else
+        else if (volume.volumeType == VT_SOURCE)
         {
-            return(E_NON_EXISTENT);
+            pRoutingInterface = mSourceInterfaces.find(volume.volumeID.source);
         }
-    }
-    else if (listVolumes[0].volumeType == VT_SOURCE)
-    {
-        am_sourceID_t                sourceID = listVolumes[0].volumeID.source;
-        SourceInterfaceMap::iterator iter     = mMapSourceInterface.begin();
-        iter = mMapSourceInterface.find(sourceID);
-        if (iter != mMapSourceInterface.end())
+
+        if (pRoutingInterface == NULL)
         {
-            pRoutingInterface = iter->second;
+            logError(__METHOD_NAME__, "Could not find the interface of volume type", volume.volumeType);
+            return (E_NON_EXISTENT);
         }
-        else
+
+        auto part(std::find_if(listParts.begin(), listParts.end(), [pRoutingInterface](const std::pair<IAmRoutingSend *, std::vector<am_Volumes_s> > &candidate)
+            {
+                return (candidate.first == pRoutingInterface);
+            }));
+        if (part == listParts.end())
         {
-            return(E_NON_EXISTENT);
+            listParts.push_back(std::make_pair(pRoutingInterface, std::vector<am_Volumes_s>()));
+            part = listParts.end() - 1;
         }
+
+        part->second.push_back(volume);
     }
-    else
+
+    if (listParts.size() == 1)
     {
-        return (E_NON_EXISTENT);
-    }
+        IAmRoutingSend *pRoutingInterface(listParts[0].first);
+        handle = createHandle(new handleSetVolumes(pRoutingInterface, listVolumes, mpDatabaseHandler), H_SETVOLUMES);
+
+        AM_LOG_INFO(__METHOD_NAME__, "handle=", handle);
+        am_Error_e syncError(pRoutingInterface->asyncSetVolumes(handle, listVolumes));
+        if (syncError)
+        {
+            removeHandle(handle);
+        }
 
-    auto handleData = std::make_shared<handleSetVolumes>(pRoutingInterface, listVolumes, mpDatabaseHandler);
-    handle = createHandle(handleData, H_SETVOLUMES);
+        return (syncError);
+    }
 
-    logInfo(__METHOD_NAME__, "handle=", handle);
-    am_Error_e syncError(pRoutingInterface->asyncSetVolumes(handle, listVolumes));
-    if (syncError)
+    handle = createHandle(new handleSetVolumes(NULL, listVolumes, mpDatabaseHandler), H_SETVOLUMES);
+    handleSetVolumes *pBatch = static_cast<handleSetVolumes *>(findHandle(handle));
+    if (pBatch == NULL)
     {
-        removeHandle(handle);
+        return (E_NOT_POSSIBLE);
     }
 
-    return(syncError);
+    // all parts are expected before the first is sent, so the batch cannot complete in between
+    AM_LOG_INFO(__METHOD_NAME__, "handle=", handle, "parts=", listParts.size());
+    pBatch->expectParts(listParts.size());
+    bool partSent(false);
+    for (const std::pair<IAmRoutingSend *, std::vector<am_Volumes_s> > &part : listParts)
+    {
+        am_Handle_s partHandle = createHandle(new handleSetVolumes(part.first, part.second, mpDatabaseHandler, handle), H_SETVOLUMES);
+        am_Error_e  syncError  = (partHandle.handle != 0) ? part.first->asyncSetVolumes(partHandle, part.second) : E_NOT_POSSIBLE;
+        if (syncError == E_OK)
+        {
+            AM_LOG_INFO(__METHOD_NAME__, "handle=", handle, "part=", partHandle);
+            partSent = true;
+            continue;
+        }
+
+        logError(__METHOD_NAME__, "part", partHandle, "of handle", handle, "failed with", syncError);
+        if (partHandle.handle != 0)
+        {
+            removeHandle(partHandle);
+        }
+
+        if (!pBatch->ackPart(std::vector<am_Volumes_s>(), syncError))
+        {
+            continue;
+        }
+
+        if (!partSent)
+        {
+            removeHandle(handle);
+            return (syncError);
+        }
+
+        // the parts that were sent are acknowledged already, the controller gets the batch like from the last acknowledge
+        if (mpRoutingReceiver != NULL)
+        {
+            const std::vector<am_Volumes_s> listAckedVolumes(pBatch->returnAckedVolumes());
+            mpRoutingReceiver->ackSetVolumes(handle, listAckedVolumes, pBatch->returnError());
+        }
+        else
+        {
+            removeHandle(handle);
+        }
+    }
 
+    return (E_OK);
 }
 
 am_Error_e CAmRoutingSender::asyncSetSinkNotificationConfiguration(am_Handle_s &handle, const am_sinkID_t sinkID, const am_NotificationConfiguration_s &notificationConfiguration)
 {
-    auto iter(mMapSinkInterface.find(sinkID));
-    if (iter == mMapSinkInterface.end())
+    IAmRoutingSend *pRoutingInterface(mSinkInterfaces.find(sinkID));
+    if (pRoutingInterface == NULL)
     {
         logError(__METHOD_NAME__, "Could not find sink", sinkID);
         return (E_NON_EXISTENT);
@@ -990,7 +1507,7 @@ am_Error_e CAmRoutingSender::asyncSetSinkNotificationConfiguration(am_Handle_s &
     {
         if (handle.handleType == am_Handle_e::H_SETSINKNOTIFICATION)
         {
-            logInfo(__METHOD_NAME__, "Resending for handle", handle);
+            AM_LOG_INFO(__METHOD_NAME__, "Resending for handle", handle);
         }
         else
         {
@@ -1000,12 +1517,11 @@ am_Error_e CAmRoutingSender::asyncSetSinkNotificationConfiguration(am_Handle_s &
     }
     else
     {
-        auto handleData = std::make_shared<handleSetSinkNotificationConfiguration>(iter->second, sinkID, notificationConfiguration, mpDatabaseHandler);
-        handle = createHandle(handleData, H_SETSINKNOTIFICATION);
+        handle = createHandle(new handleSetSinkNotificationConfiguration(pRoutingInterface, sinkID, notificationConfiguration, mpDatabaseHandler), H_SETSINKNOTIFICATION);
     }
 
-    logInfo(__METHOD_NAME__, "sinkID=", sinkID, "notificationConfiguration.type=", notificationConfiguration.type, "notificationConfiguration.status", notificationConfiguration.status, "notificationConfiguration.parameter", notificationConfiguration.parameter);
-    am_Error_e syncError(iter->second->asyncSetSinkNotificationConfiguration(handle, sinkID, notificationConfiguration));
+    AM_LOG_INFO(__METHOD_NAME__, "sinkID=", sinkID, "notificationConfiguration.type=", notificationConfiguration.type, "notificationConfiguration.status", notificationConfiguration.status, "notificationConfiguration.parameter", notificationConfiguration.parameter);
+    am_Error_e syncError(pRoutingInterface->asyncSetSinkNotificationConfiguration(handle, sinkID, notificationConfiguration));
     if (syncError)
     {
         removeHandle(handle);
@@ -1017,8 +1533,8 @@ am_Error_e CAmRoutingSender::asyncSetSinkNotificationConfiguration(am_Handle_s &
 
 am_Error_e CAmRoutingSender::asyncSetSourceNotificationConfiguration(am_Handle_s &handle, const am_sourceID_t sourceID, const am_NotificationConfiguration_s &notificationConfiguration)
 {
-    auto iter(mMapSourceInterface.find(sourceID));
-    if (iter == mMapSourceInterface.end())
+    IAmRoutingSend *pRoutingInterface(mSourceInterfaces.find(sourceID));
+    if (pRoutingInterface == NULL)
     {
         logError(__METHOD_NAME__, "Could not find sourceID", sourceID);
         return (E_NON_EXISTENT);
@@ -1028,7 +1544,7 @@ am_Error_e CAmRoutingSender::asyncSetSourceNotificationConfiguration(am_Handle_s
     {
         if (handle.handleType == am_Handle_e::H_SETSOURCENOTIFICATION)
         {
-            logInfo(__METHOD_NAME__, "Resending for handle", handle);
+            AM_LOG_INFO(__METHOD_NAME__, "Resending for handle", handle);
         }
         else
         {
@@ -1038,12 +1554,11 @@ am_Error_e CAmRoutingSender::asyncSetSourceNotificationConfiguration(am_Handle_s
     }
     else
     {
-        auto handleData = std::make_shared<handleSetSourceNotificationConfiguration>(iter->second, sourceID, notificationConfiguration, mpDatabaseHandler);
-        handle = createHandle(handleData, H_SETSOURCENOTIFICATION);
+        handle = createHandle(new handleSetSourceNotificationConfiguration(pRoutingInterface, sourceID, notificationConfiguration, mpDatabaseHandler), H_SETSOURCENOTIFICATION);
     }
 
-    logInfo(__METHOD_NAME__, "sourceID=", sourceID, "notificationConfiguration.type=", notificationConfiguration.type, "notificationConfiguration.status", notificationConfiguration.status, "notificationConfiguration.parameter", notificationConfiguration.parameter);
-    am_Error_e syncError(iter->second->asyncSetSourceNotificationConfiguration(handle, sourceID, notificationConfiguration));
+    AM_LOG_INFO(__METHOD_NAME__, "sourceID=", sourceID, "notificationConfiguration.type=", notificationConfiguration.type, "notificationConfiguration.status", notificationConfiguration.status, "notificationConfiguration.parameter", notificationConfiguration.parameter);
+    am_Error_e syncError(pRoutingInterface->asyncSetSourceNotificationConfiguration(handle, sourceID, notificationConfiguration));
     if (syncError)
     {
         removeHandle(handle);
@@ -1082,11 +1597,10 @@ void CAmRoutingSender::getInterfaceVersion(std::string &version) const
 
 am_Error_e CAmRoutingSender::resyncConnectionState(const am_domainID_t domainID, std::vector<am_Connection_s> &listOfExistingConnections)
 {
-    DomainInterfaceMap::iterator iter = mMapDomainInterface.begin();
-    iter = mMapDomainInterface.find(domainID);
-    if (iter != mMapDomainInterface.end())
+    IAmRoutingSend *pRoutingInterface(mDomainInterfaces.find(domainID));
+    if (pRoutingInterface != NULL)
     {
-        return (iter->second->resyncConnectionState(domainID, listOfExistingConnections));
+        return (pRoutingInterface->resyncConnectionState(domainID, listOfExistingConnections));
     }
 
     return (E_NON_EXISTENT);
@@ -1094,11 +1608,11 @@ am_Error_e CAmRoutingSender::resyncConnectionState(const am_domainID_t domainID,
 
 am_Error_e CAmRoutingSender::writeToDatabaseAndRemove(const am_Handle_s handle)
 {
-    auto it(mlistActiveHandles.find(handle));
-    if (it != mlistActiveHandles.end())
+    handleDataBase *pHandleData = findHandle(handle);
+    if (pHandleData != NULL)
     {
-        am_Error_e error(it->second->writeDataToDatabase());
-        mlistActiveHandles.erase(handle);
+        am_Error_e error(pHandleData->writeDataToDatabase());
+        removeHandle(handle);
         return (error);
     }
 
@@ -1106,12 +1620,59 @@ am_Error_e CAmRoutingSender::writeToDatabaseAndRemove(const am_Handle_s handle)
     return (am_Error_e::E_NON_EXISTENT);
 }
 
+bool CAmRoutingSender::ackSetVolumes(am_Handle_s &handle, std::vector<am_Volumes_s> &listVolumes, am_Error_e &error)
+{
+    handleSetVolumes *pHandleData = (handle.handleType == H_SETVOLUMES) ? static_cast<handleSetVolumes *>(findHandle(handle)) : NULL;
+    const am_Handle_s batch((pHandleData != NULL) ? pHandleData->returnBatch() : am_Handle_s());
+    if (error == E_OK)
+    {
+        writeToDatabaseAndRemove(handle);
+    }
+    else
+    {
+        removeHandle(handle);
+    }
+
+    if (batch.handle == 0)
+    {
+        return (true);
+    }
+
+    handleSetVolumes *pBatch = static_cast<handleSetVolumes *>(findHandle(batch));
+    if ((pBatch == NULL) || !pBatch->ackPart(listVolumes, error))
+    {
+        return (false);
+    }
+
+    handle      = batch;
+    listVolumes = pBatch->returnAckedVolumes();
+    error       = pBatch->returnError();
+    removeHandle(batch);
+    return (true);
+}
+
+/**
+ * the controller only knows the batch of a batch of volumes that was split over several domains
+ * @param handle the handle the routing plugin used
+ * @return the handle the controller knows
+ */
+am_Handle_s CAmRoutingSender::returnControllerHandle(const am_Handle_s handle) const
+{
+    const handleSetVolumes *pHandleData = (handle.handleType == H_SETVOLUMES) ? static_cast<handleSetVolumes *>(findHandle(handle)) : NULL;
+    if ((pHandleData == NULL) || (pHandleData->returnBatch().handle == 0))
+    {
+        return (handle);
+    }
+
+    return (pHandleData->returnBatch());
+}
+
 void CAmRoutingSender::checkVolume(const am_Handle_s handle, const am_volume_t volume)
 {
-    auto it(mlistActiveHandles.find(handle));
-    if (it != mlistActiveHandles.end())
+    handleDataBase *pHandleData = findHandle(handle);
+    if (pHandleData != NULL)
     {
-        handleVolumeBase *basePtr = static_cast<handleVolumeBase *>(it->second.get());
+        handleVolumeBase *basePtr = static_cast<handleVolumeBase *>(pHandleData);
         if (basePtr->returnVolume() != volume)
         {
             logError(__METHOD_NAME__, "volume returned for handle does not match: ", volume, "expected:", basePtr->returnVolume());
@@ -1125,13 +1686,7 @@ void CAmRoutingSender::checkVolume(const am_Handle_s handle, const am_volume_t v
 
 bool CAmRoutingSender::handleExists(const am_Handle_s handle)
 {
-    auto iter(mlistActiveHandles.find(handle));
-    if (iter != mlistActiveHandles.end())
-    {
-        return (true);
-    }
-
-    return (false);
+    return (findHandle(handle) != NULL);
 }
 
 am_Error_e CAmRoutingSender::handleSinkSoundProperty::writeDataToDatabase()
@@ -1199,21 +1754,37 @@ am_Error_e CAmRoutingSender::handleDisconnect::writeDataToDatabase()
 
 am_Error_e CAmRoutingSender::handleSetVolumes::writeDataToDatabase()
 {
-    std::vector<am_Volumes_s>::const_iterator iterator(mlistVolumes.begin());
-
-    for (; iterator != mlistVolumes.end(); ++iterator)
+    am_Error_e error(mlistVolumes.empty() ? E_WRONG_FORMAT : E_OK);
+    for (const am_Volumes_s &volume : mlistVolumes)
     {
-        if (iterator->volumeType == VT_SINK)
+        am_Error_e volumeError(E_WRONG_FORMAT);
+        if (volume.volumeType == VT_SINK)
+        {
+            volumeError = mpDatabaseHandler->changeSinkVolume(volume.volumeID.sink, volume.volume);
+        }
+        else if (volume.volumeType == VT_SOURCE)
         {
-            return (mpDatabaseHandler->changeSinkVolume(iterator->volumeID.sink, iterator->volume));
+            volumeError = mpDatabaseHandler->changeSourceVolume(volume.volumeID.source, volume.volume);
         }
-        else if (iterator->volumeType == VT_SOURCE)
+
+        if (error == E_OK)
         {
-            return (mpDatabaseHandler->changeSourceVolume(iterator->volumeID.source, iterator->volume));
+            error = volumeError;
         }
     }
 
-    return (am_Error_e::E_WRONG_FORMAT);
+    return (error);
+}
+
+bool CAmRoutingSender::handleSetVolumes::ackPart(const std::vector<am_Volumes_s> &listVolumes, const am_Error_e error)
+{
+    if (mError == E_OK)
+    {
+        mError = error;
+    }
+
+    mlistAckedVolumes.insert(mlistAckedVolumes.end(), listVolumes.begin(), listVolumes.end());
+    return ((mOpenParts > 0) && (--mOpenParts == 0));
 }
 
 am_Error_e CAmRoutingSender::handleSetSinkNotificationConfiguration::writeDataToDatabase()
@@ -1228,11 +1799,8 @@ am_Error_e CAmRoutingSender::handleSetSourceNotificationConfiguration::writeData
 
 am_Error_e CAmRoutingSender::removeConnectionLookup(const am_connectionID_t connectionID)
 {
-    ConnectionInterfaceMap::iterator iter = mMapConnectionInterface.begin();
-    iter = mMapConnectionInterface.find(connectionID);
-    if (iter != mMapConnectionInterface.end())
+    if (mConnectionInterfaces.erase(connectionID))
     {
-        mMapConnectionInterface.erase(iter);
         return (E_OK);
     }
 
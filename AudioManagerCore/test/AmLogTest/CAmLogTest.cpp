@@ -0,0 +1,232 @@
+/**
+ * SPDX license identifier: MPL-2.0
+ *
+ * Copyright (C) 2012, BMW AG
+ *
+ * This file is part of GENIVI Project AudioManager.
+ *
+ * Contributions are licensed to the GENIVI Alliance under one or more
+ * Contribution License Agreements.
+ *
+ * \copyright
+ * This Source Code Form is subject to the terms of the
+ * Mozilla Public License, v. 2.0. If a  copy of the MPL was not distributed with
+ * this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ *
+ * For further information see http://www.genivi.org/.
+ *
+ */
+
+#include "CAmLogTest.h"
+#include <stdio.h>
+#include <unistd.h>
+#include <sstream>
+#include <thread>
+#include <vector>
+#include "CAmLog.h"
+
+using namespace am;
+using namespace testing;
+
+CAmCaptureBuffer::int_type CAmCaptureBuffer::overflow(int_type c)
+{
+    if (c != traits_type::eof())
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mText += traits_type::to_char_type(c);
+    }
+    return (c);
+}
+
+std::streamsize CAmCaptureBuffer::xsputn(const char *s, std::streamsize n)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    mText.append(s, n);
+    return (n);
+}
+
+std::string CAmCaptureBuffer::text()
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    return (mText);
+}
+
+bool CAmCaptureBuffer::waitFor(const std::string &text, const unsigned timeoutMs)
+{
+    for (unsigned waited = 0; waited < timeoutMs; waited += 5)
+    {
+        if (this->text().find(text) != std::string::npos)
+        {
+            return (true);
+        }
+        usleep(5000);
+    }
+    return (false);
+}
+
+CAmLogTest::CAmLogTest() :
+        mCapture(), mpCoutBuffer(NULL)
+{
+}
+
+CAmLogTest::~CAmLogTest()
+{
+}
+
+void CAmLogTest::SetUp()
+{
+    mpCoutBuffer = std::cout.rdbuf(&mCapture);
+}
+
+void CAmLogTest::TearDown()
+{
+    std::cout.rdbuf(mpCoutBuffer);
+}
+
+TEST_F(CAmLogTest, writeThroughWithoutFlushSize)
+{
+    CAmLog log(eCAmLogStdout);
+    log.setFlushPolicy(0, 3600000);
+
+    log << "first " << 1 << "\n";
+    EXPECT_EQ(mCapture.text(), "first 1\n");
+
+    // an incomplete line is staged until it is complete
+    log << "second";
+    EXPECT_EQ(mCapture.text(), "first 1\n");
+    log << std::endl;
+    EXPECT_EQ(mCapture.text(), "first 1\nsecond\n");
+}
+
+TEST_F(CAmLogTest, flushOnSize)
+{
+    CAmLog log(eCAmLogStdout);
+    log.setFlushPolicy(32, 3600000);
+
+    log << "short line\n";
+    usleep(50000);
+    EXPECT_EQ(mCapture.text(), "");
+
+    log << "a line which fills up the buffer\n";
+    EXPECT_TRUE(mCapture.waitFor("short line\na line which fills up the buffer\n"));
+}
+
+TEST_F(CAmLogTest, flushOnInterval)
+{
+    CAmLog log(eCAmLogStdout);
+    log.setFlushPolicy(1 << 20, 200);
+
+    log << "line\n";
+    EXPECT_EQ(mCapture.text(), "");
+    EXPECT_TRUE(mCapture.waitFor("line\n"));
+}
+
+TEST_F(CAmLogTest, flushOnIntervalAfterIdle)
+{
+    CAmLog log(eCAmLogStdout);
+    log.setFlushPolicy(1 << 20, 100);
+
+    // the background thread sleeps while nothing is buffered, the next line starts the interval again
+    log << "first\n";
+    EXPECT_TRUE(mCapture.waitFor("first\n"));
+    usleep(300000);
+    log << "second\n";
+    EXPECT_EQ(mCapture.text(), "first\n");
+    EXPECT_TRUE(mCapture.waitFor("first\nsecond\n"));
+}
+
+TEST_F(CAmLogTest, flushWritesEverything)
+{
+    CAmLog log(eCAmLogStdout);
+    log.setFlushPolicy(1 << 20, 3600000);
+
+    log << "complete\n" << "incomplete";
+    usleep(50000);
+    EXPECT_EQ(mCapture.text(), "");
+
+    log.flush();
+    EXPECT_EQ(mCapture.text(), "complete\nincomplete");
+}
+
+TEST_F(CAmLogTest, orderAcrossThreads)
+{
+    const unsigned numThreads = 4;
+    const unsigned numLines = 500;
+
+    CAmLog log(eCAmLogStdout);
+    log.setFlushPolicy(64, 10);
+
+    std::vector<std::thread> threads;
+    for (unsigned t = 0; t < numThreads; t++)
+    {
+        threads.push_back(std::thread([&log, t]()
+        {
+            for (unsigned i = 0; i < numLines; i++)
+            {
+                log << "thread " << t << " line " << i << std::endl;
+            }
+        }));
+    }
+
+    for (std::thread &thread : threads)
+    {
+        thread.join();
+    }
+    log.flush();
+
+    // the lines are never torn apart and the lines of one thread keep their order
+    std::istringstream text(mCapture.text());
+    std::string line;
+    std::vector<unsigned> nextLine(numThreads, 0);
+    unsigned lines = 0;
+    while (std::getline(text, line))
+    {
+        unsigned t = numThreads;
+        unsigned i = numLines;
+        char rest;
+        ASSERT_EQ(sscanf(line.c_str(), "thread %u line %u%c", &t, &i, &rest), 2) << line;
+        ASSERT_LT(t, numThreads);
+        EXPECT_EQ(i, nextLine[t]);
+        nextLine[t] = i + 1;
+        lines++;
+    }
+    EXPECT_EQ(lines, numThreads * numLines);
+}
+
+TEST_F(CAmLogTest, stagingOfDeletedLogger)
+{
+    {
+        CAmLog first(eCAmLogStdout);
+        first.setFlushPolicy(0, 3600000);
+        first << "lost";
+    }
+
+    // the deleted logger wrote the incomplete line, a new logger does not find it again
+    EXPECT_EQ(mCapture.text(), "lost");
+    CAmLog second(eCAmLogStdout);
+    second.setFlushPolicy(0, 3600000);
+    second << "line\n";
+    EXPECT_EQ(mCapture.text(), "lostline\n");
+}
+
+TEST_F(CAmLogTest, changeLoggerInLine)
+{
+    CAmLog first(eCAmLogStdout);
+    CAmLog second(eCAmLogStdout);
+    first.setFlushPolicy(0, 3600000);
+    second.setFlushPolicy(0, 3600000);
+
+    // the incomplete line goes to its logger before the thread stages for the other one
+    first << "first ";
+    second << "second\n";
+    EXPECT_EQ(mCapture.text(), "first second\n");
+    first << "third\n";
+    EXPECT_EQ(mCapture.text(), "first second\nthird\n");
+}
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,65 @@
+/**
+ * SPDX license identifier: MPL-2.0
+ *
+ * Copyright (C) 2012, BMW AG
+ *
+ * This file is part of GENIVI Project AudioManager.
+ *
+ * Contributions are licensed to the GENIVI Alliance under one or more
+ * Contribution License Agreements.
+ *
+ * \copyright
+ * This Source Code Form is subject to the terms of the
+ * Mozilla Public License, v. 2.0. If a  copy of the MPL was not distributed with
+ * this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ *
+ * For further information see http://www.genivi.org/.
+ *
+ */
+
+#ifndef LOGTEST_H_
+#define LOGTEST_H_
+
+#include "gtest/gtest.h"
+#include <mutex>
+#include <streambuf>
+#include <string>
+
+namespace am
+{
+
+    /**
+     * collects what the stdout logger writes, the background thread of the logger writes while the test reads
+     */
+    class CAmCaptureBuffer: public std::streambuf
+    {
+        std::mutex mMutex;
+        std::string mText;
+    protected:
+        int_type overflow(int_type c);
+        std::streamsize xsputn(const char *s, std::streamsize n);
+    public:
+        std::string text();
+
+        /**
+         * waits until the captured text contains the given text
+         * @return false if it did not show up in time
+         */
+        bool waitFor(const std::string &text, const unsigned timeoutMs = 5000);
+    };
+
+    class CAmLogTest: public ::testing::Test
+    {
+    public:
+        CAmLogTest();
+        ~CAmLogTest();
+        CAmCaptureBuffer mCapture;
+        std::streambuf *mpCoutBuffer;
+        void SetUp();
+        void TearDown();
+    };
+
+}
+
+#endif /* LOGTEST_H_ */
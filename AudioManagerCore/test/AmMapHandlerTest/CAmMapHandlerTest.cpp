@@ -29,6 +29,7 @@
 #include <ios>
 #include "CAmDltWrapper.h"
 #include "CAmCommandLineSingleton.h"
+#include "CAmCommandReceiver.h"
 
 using namespace am;
 using namespace testing;
@@ -3503,6 +3504,16 @@ TEST_F(CAmMapHandlerTest, dbo_changeMainNotificationsSources)
     ASSERT_EQ(E_OK,pDatabaseHandler.changeMainSourceNotificationConfigurationDB(sourceID,notify2));
 }
 
+TEST_F(CAmMapHandlerTest,commandReadyOfInjectedInterface)
+{
+    // the injected interface was not loaded from a library, so it has no name
+    CAmCommandReceiver commandReceiver(&pDatabaseHandler, &pControlSender, &pSocketHandler);
+    EXPECT_CALL(pMockInterface,startupInterface(&commandReceiver)).WillOnce(Return(E_OK));
+    ASSERT_EQ(E_OK, pCommandSender.startupInterfaces(&commandReceiver));
+    EXPECT_CALL(pMockInterface,setCommandReady(_)).Times(1);
+    pCommandSender.setCommandReady();
+}
+
 int main(int argc, char **argv)
 {
 	try
@@ -644,6 +644,470 @@ TEST_F(CAmRoutingInterfaceTest,handleOverflowAbsolute)
 }
 
 
+TEST_F(CAmRoutingInterfaceTest,handleTimeout)
+{
+    am_Handle_s handle, handleAcked;
+    am_sinkID_t sinkID;
+    am_Sink_s sink;
+    am_Domain_s domain;
+    am_domainID_t domainID;
+
+    pCF.createSink(sink);
+    pCF.createDomain(domain);
+    domain.name = "mock";
+    domain.busname = "mock";
+    sink.sinkID = 2;
+    sink.domainID = DYNAMIC_ID_BOUNDARY;
+    am_SoundProperty_s soundProperty;
+    soundProperty.type = SP_GENIVI_TREBLE;
+    soundProperty.value = 23;
+    sink.listSoundProperties.push_back(soundProperty);
+    ASSERT_EQ(E_OK, pDatabaseHandler.enterDomainDB(domain,domainID));
+    ASSERT_EQ(E_OK, pDatabaseHandler.enterSinkDB(sink,sinkID));
+
+    EXPECT_CALL(pMockInterface,startupInterface(_)).WillOnce(Return(E_OK));
+    ASSERT_EQ(E_OK, pRoutingSender.startupInterfaces(&pRoutingReceiver));
+    ASSERT_EQ(E_OUT_OF_RANGE, pRoutingSender.setHandleTimeout(H_MAX, 200));
+    ASSERT_EQ(E_OK, pRoutingSender.setHandleTimeout(H_SETSINKSOUNDPROPERTY, 200));
+
+    // the acked handle is not aborted, the other one is aborted once
+    EXPECT_CALL(pMockInterface,asyncSetSinkSoundProperty(_,sinkID,_)).WillRepeatedly(Return(E_OK));
+    ASSERT_EQ(E_OK, pControlReceiver.setSinkSoundProperty(handleAcked,sinkID,soundProperty));
+    ASSERT_EQ(E_OK, pControlReceiver.setSinkSoundProperty(handle,sinkID,soundProperty));
+    EXPECT_CALL(pMockControlInterface,cbAckSetSinkSoundProperty(_,E_OK));
+    pRoutingReceiver.ackSetSinkSoundProperty(handleAcked,E_OK);
+    auto isHandle = Truly([&](const am_Handle_s &h) { return (h.handle == handle.handle); });
+    EXPECT_CALL(pMockInterface,asyncAbort(isHandle)).WillOnce(Return(E_OK));
+    EXPECT_CALL(pMockControlInterface,cbHandleTimeout(isHandle));
+
+    timespec stop = { 0, 500000000 };
+    sh_timerHandle_t stopTimer;
+    ASSERT_EQ(E_OK, pSocketHandler.addTimer(stop, [&](const sh_timerHandle_t, void *) { pSocketHandler.exit_mainloop(); }, stopTimer, NULL));
+    pSocketHandler.start_listenting();
+
+    std::vector<am_Handle_s> listHandles;
+    ASSERT_EQ(E_OK, pControlReceiver.getListHandles(listHandles));
+    ASSERT_TRUE(listHandles.empty());
+
+    // the number of the aborted handle is not used again, its late acknowledge is dropped
+    am_Handle_s handleNew;
+    ASSERT_EQ(E_OK, pControlReceiver.setSinkSoundProperty(handleNew,sinkID,soundProperty));
+    ASSERT_NE(handle.handle, handleNew.handle);
+    EXPECT_CALL(pMockControlInterface,cbAckSetSinkSoundProperty(_,_)).Times(0);
+    pRoutingReceiver.ackSetSinkSoundProperty(handle,E_OK);
+    listHandles.clear();
+    ASSERT_EQ(E_OK, pControlReceiver.getListHandles(listHandles));
+    ASSERT_EQ(1u, listHandles.size());
+    ASSERT_EQ(handleNew.handle, listHandles[0].handle);
+}
+
+TEST_F(CAmRoutingInterfaceTest,handleTimeoutAbortAcknowledged)
+{
+    am_Handle_s handle;
+    am_sinkID_t sinkID;
+    am_Sink_s sink;
+    am_Domain_s domain;
+    am_domainID_t domainID;
+
+    pCF.createSink(sink);
+    pCF.createDomain(domain);
+    domain.name = "mock";
+    domain.busname = "mock";
+    sink.sinkID = 2;
+    sink.domainID = DYNAMIC_ID_BOUNDARY;
+    am_SoundProperty_s soundProperty;
+    soundProperty.type = SP_GENIVI_TREBLE;
+    soundProperty.value = 23;
+    sink.listSoundProperties.push_back(soundProperty);
+    ASSERT_EQ(E_OK, pDatabaseHandler.enterDomainDB(domain,domainID));
+    ASSERT_EQ(E_OK, pDatabaseHandler.enterSinkDB(sink,sinkID));
+
+    EXPECT_CALL(pMockInterface,startupInterface(_)).WillOnce(Return(E_OK));
+    ASSERT_EQ(E_OK, pRoutingSender.startupInterfaces(&pRoutingReceiver));
+    ASSERT_EQ(E_OK, pRoutingSender.setHandleTimeout(H_SETSINKSOUNDPROPERTY, 200));
+
+    // the plugin acknowledges the abort right away, the controller gets only this acknowledge
+    EXPECT_CALL(pMockInterface,asyncSetSinkSoundProperty(_,sinkID,_)).WillRepeatedly(Return(E_OK));
+    ASSERT_EQ(E_OK, pControlReceiver.setSinkSoundProperty(handle,sinkID,soundProperty));
+    auto isHandle = Truly([&](const am_Handle_s &h) { return (h.handle == handle.handle); });
+    EXPECT_CALL(pMockInterface,asyncAbort(isHandle)).WillOnce(Invoke([&](const am_Handle_s h)
+    {
+        pRoutingReceiver.ackSetSinkSoundProperty(h,E_ABORTED);
+        return (E_OK);
+    }));
+    EXPECT_CALL(pMockControlInterface,cbAckSetSinkSoundProperty(isHandle,E_ABORTED));
+    EXPECT_CALL(pMockControlInterface,cbHandleTimeout(_)).Times(0);
+
+    timespec stop = { 0, 500000000 };
+    sh_timerHandle_t stopTimer;
+    ASSERT_EQ(E_OK, pSocketHandler.addTimer(stop, [&](const sh_timerHandle_t, void *) { pSocketHandler.exit_mainloop(); }, stopTimer, NULL));
+    pSocketHandler.start_listenting();
+    Mock::VerifyAndClearExpectations(&pMockControlInterface);
+
+    // the number is free and not quarantined, the handle that gets it again is acknowledged normally
+    am_Handle_s handleNew;
+    std::vector<am_Handle_s> listHandles;
+    EXPECT_CALL(pMockControlInterface,cbAckSetSinkSoundProperty(_,E_OK)).Times(AnyNumber());
+    for (uint16_t i = 0; i < 1024; i++)
+    {
+        ASSERT_EQ(E_OK, pControlReceiver.setSinkSoundProperty(handleNew,sinkID,soundProperty));
+        ASSERT_NE(0, handleNew.handle);
+        ASSERT_EQ(E_OK, pControlReceiver.getListHandles(listHandles));
+        ASSERT_EQ(1u, listHandles.size());
+        if (handleNew.handle == handle.handle)
+        {
+            break;
+        }
+
+        pRoutingReceiver.ackSetSinkSoundProperty(handleNew,E_OK);
+    }
+
+    ASSERT_EQ(handle.handle, handleNew.handle);
+    EXPECT_CALL(pMockControlInterface,cbAckSetSinkSoundProperty(isHandle,E_OK));
+    pRoutingReceiver.ackSetSinkSoundProperty(handleNew,E_OK);
+    ASSERT_EQ(E_OK, pControlReceiver.getListHandles(listHandles));
+    ASSERT_TRUE(listHandles.empty());
+}
+
+TEST_F(CAmRoutingInterfaceTest,setVolumesOfTwoDomains)
+{
+    MockIAmRoutingSend pMockInterface2;
+    pRoutingInterfaceBackdoor.injectInterface(&pRoutingSender, &pMockInterface2, "mock2");
+    am_Domain_s domain, domain2;
+    am_domainID_t domainID, domainID2;
+    am_Sink_s sink;
+    am_sinkID_t sinkID1, sinkID2, sinkID3;
+    pCF.createDomain(domain);
+    domain.name = "mock";
+    domain.busname = "mock";
+    domain.domainID = 0;
+    pCF.createDomain(domain2);
+    domain2.domainID = 0;
+    domain2.name = "mock2";
+    domain2.busname = "mock2";
+    ASSERT_EQ(E_OK, pDatabaseHandler.enterDomainDB(domain,domainID));
+    ASSERT_EQ(E_OK, pDatabaseHandler.enterDomainDB(domain2,domainID2));
+    pCF.createSink(sink);
+    sink.sinkID = 0;
+    sink.name = "sink1";
+    sink.domainID = domainID;
+    ASSERT_EQ(E_OK, pDatabaseHandler.enterSinkDB(sink,sinkID1));
+    sink.name = "sink2";
+    sink.domainID = domainID2;
+    ASSERT_EQ(E_OK, pDatabaseHandler.enterSinkDB(sink,sinkID2));
+    sink.name = "sink3";
+    sink.domainID = domainID;
+    ASSERT_EQ(E_OK, pDatabaseHandler.enterSinkDB(sink,sinkID3));
+
+    std::vector<am_Volumes_s> listVolumes;
+    am_Volumes_s volume;
+    volume.volumeType = VT_SINK;
+    volume.ramp = RAMP_GENIVI_DIRECT;
+    volume.time = 0;
+    for (am_sinkID_t sinkID : { sinkID1, sinkID2, sinkID3 })
+    {
+        volume.volumeID.sink = sinkID;
+        volume.volume = 10 * sinkID;
+        listVolumes.push_back(volume);
+    }
+
+    // each domain gets its volumes with a handle of its own
+    am_Handle_s handle, part1, part2;
+    EXPECT_CALL(pMockInterface,asyncSetVolumes(_,Truly([](const std::vector<am_Volumes_s> &list) { return (list.size() == 2); }))).WillOnce(DoAll(SaveArg<0>(&part1), Return(E_OK)));
+    EXPECT_CALL(pMockInterface2,asyncSetVolumes(_,Truly([](const std::vector<am_Volumes_s> &list) { return (list.size() == 1); }))).WillOnce(DoAll(SaveArg<0>(&part2), Return(E_OK)));
+    ASSERT_EQ(E_OK, pControlReceiver.setVolumes(handle,listVolumes));
+    ASSERT_EQ(handle.handleType, H_SETVOLUMES);
+    ASSERT_NE(handle.handle, part1.handle);
+    ASSERT_NE(handle.handle, part2.handle);
+
+    // the ticks of the parts reach the controller with the handle of the batch, also when they wait for the acknowledge
+    auto isBatch = Truly([&](const am_Handle_s &h) { return ((h.handle == handle.handle) && (h.handleType == H_SETVOLUMES)); });
+    EXPECT_CALL(pMockControlInterface,hookSystemSinkVolumeTick(isBatch,sinkID1,5));
+    pRoutingReceiver.ackSinkVolumeTick(part1,sinkID1,5);
+    Mock::VerifyAndClearExpectations(&pMockControlInterface);
+    pRoutingReceiver.setVolumeTickInterval(1000);
+    pRoutingReceiver.ackSinkVolumeTick(part2,sinkID2,15);
+
+    // the controller gets one acknowledge when both domains are done
+    EXPECT_CALL(pMockControlInterface,hookSystemSinkVolumeTick(isBatch,sinkID2,15));
+    EXPECT_CALL(pMockControlInterface,cbAckSetVolumes(_,_,_)).Times(0);
+    pRoutingReceiver.ackSetVolumes(part2, std::vector<am_Volumes_s>(1, listVolumes[1]), E_OK);
+    Mock::VerifyAndClearExpectations(&pMockControlInterface);
+    pRoutingReceiver.setVolumeTickInterval(0);
+    am_Handle_s acked;
+    std::vector<am_Volumes_s> listAcked;
+    EXPECT_CALL(pMockControlInterface,cbAckSetVolumes(_,_,E_OK)).WillOnce(DoAll(SaveArg<0>(&acked), SaveArg<1>(&listAcked)));
+    pRoutingReceiver.ackSetVolumes(part1, std::vector<am_Volumes_s>(1, listVolumes[0]), E_OK);
+    ASSERT_EQ(acked.handle, handle.handle);
+    ASSERT_EQ(listAcked.size(), 2u);
+
+    am_Sink_s sinkData;
+    ASSERT_EQ(E_OK, pDatabaseHandler.getSinkInfoDB(sinkID2, sinkData));
+    ASSERT_EQ(sinkData.volume, 10 * sinkID2);
+    ASSERT_EQ(E_OK, pDatabaseHandler.getSinkInfoDB(sinkID3, sinkData));
+    ASSERT_EQ(sinkData.volume, 10 * sinkID3);
+    std::vector<am_Handle_s> listHandles;
+    ASSERT_EQ(E_OK, pControlReceiver.getListHandles(listHandles));
+    ASSERT_TRUE(listHandles.empty());
+}
+
+TEST_F(CAmRoutingInterfaceTest,setVolumesOfTwoDomainsPartFails)
+{
+    MockIAmRoutingSend pMockInterface2;
+    pRoutingInterfaceBackdoor.injectInterface(&pRoutingSender, &pMockInterface2, "mock2");
+    am_Domain_s domain, domain2;
+    am_domainID_t domainID, domainID2;
+    am_Sink_s sink;
+    am_sinkID_t sinkID1, sinkID2;
+    pCF.createDomain(domain);
+    domain.name = "mock";
+    domain.busname = "mock";
+    domain.domainID = 0;
+    pCF.createDomain(domain2);
+    domain2.domainID = 0;
+    domain2.name = "mock2";
+    domain2.busname = "mock2";
+    ASSERT_EQ(E_OK, pDatabaseHandler.enterDomainDB(domain,domainID));
+    ASSERT_EQ(E_OK, pDatabaseHandler.enterDomainDB(domain2,domainID2));
+    pCF.createSink(sink);
+    sink.sinkID = 0;
+    sink.name = "sink1";
+    sink.domainID = domainID;
+    ASSERT_EQ(E_OK, pDatabaseHandler.enterSinkDB(sink,sinkID1));
+    sink.name = "sink2";
+    sink.domainID = domainID2;
+    ASSERT_EQ(E_OK, pDatabaseHandler.enterSinkDB(sink,sinkID2));
+
+    EXPECT_CALL(pMockInterface,startupInterface(_)).WillOnce(Return(E_OK));
+    EXPECT_CALL(pMockInterface2,startupInterface(_)).WillOnce(Return(E_OK));
+    ASSERT_EQ(E_OK, pRoutingSender.startupInterfaces(&pRoutingReceiver));
+
+    std::vector<am_Volumes_s> listVolumes;
+    am_Volumes_s volume;
+    volume.volumeType = VT_SINK;
+    volume.ramp = RAMP_GENIVI_DIRECT;
+    volume.time = 0;
+    for (am_sinkID_t sinkID : { sinkID1, sinkID2 })
+    {
+        volume.volumeID.sink = sinkID;
+        volume.volume = 10 * sinkID;
+        listVolumes.push_back(volume);
+    }
+
+    // the first domain acknowledges before the second fails, the controller gets the batch with the error
+    EXPECT_CALL(pMockInterface,asyncSetVolumes(_,_)).WillOnce(Invoke([&](const am_Handle_s h, const std::vector<am_Volumes_s> &list)
+    {
+        pRoutingReceiver.ackSetVolumes(h, list, E_OK);
+        return (E_OK);
+    }));
+    EXPECT_CALL(pMockInterface2,asyncSetVolumes(_,_)).WillOnce(Return(E_NOT_POSSIBLE));
+    am_Handle_s acked;
+    std::vector<am_Volumes_s> listAcked;
+    EXPECT_CALL(pMockControlInterface,cbAckSetVolumes(_,_,E_NOT_POSSIBLE)).WillOnce(DoAll(SaveArg<0>(&acked), SaveArg<1>(&listAcked)));
+    am_Handle_s handle;
+    ASSERT_EQ(E_OK, pControlReceiver.setVolumes(handle,listVolumes));
+    ASSERT_EQ(handle.handleType, H_SETVOLUMES);
+    ASSERT_EQ(acked.handle, handle.handle);
+    ASSERT_EQ(listAcked.size(), 1u);
+    ASSERT_EQ(listAcked[0].volumeID.sink, sinkID1);
+
+    am_Sink_s sinkData;
+    ASSERT_EQ(E_OK, pDatabaseHandler.getSinkInfoDB(sinkID1, sinkData));
+    ASSERT_EQ(sinkData.volume, 10 * sinkID1);
+    std::vector<am_Handle_s> listHandles;
+    ASSERT_EQ(E_OK, pControlReceiver.getListHandles(listHandles));
+    ASSERT_TRUE(listHandles.empty());
+}
+
+TEST_F(CAmRoutingInterfaceTest,crossFade)
+{
+    am_Sink_s sink;
+    am_Source_s source;
+    am_Crossfader_s crossfader;
+    am_Domain_s domain;
+    am_domainID_t domainID;
+    am_sinkID_t sinkID;
+    am_sourceID_t sourceID;
+    am_crossfaderID_t crossfaderID;
+    am_Handle_s handle;
+    pCF.createDomain(domain);
+    domain.name = "mock";
+    domain.busname = "mock";
+    ASSERT_EQ(E_OK, pDatabaseHandler.enterDomainDB(domain,domainID));
+    pCF.createSink(sink);
+    sink.domainID = domainID;
+    sink.sinkID = 2;
+    sink.name = "sinkA";
+    ASSERT_EQ(E_OK, pDatabaseHandler.enterSinkDB(sink,sinkID));
+    sink.sinkID = 3;
+    sink.name = "sinkB";
+    ASSERT_EQ(E_OK, pDatabaseHandler.enterSinkDB(sink,sinkID));
+    pCF.createSource(source);
+    source.domainID = domainID;
+    source.sourceID = 4;
+    ASSERT_EQ(E_OK, pDatabaseHandler.enterSourceDB(source,sourceID));
+    crossfader.crossfaderID = 5;
+    crossfader.name = "crossfader";
+    crossfader.sinkID_A = 2;
+    crossfader.sinkID_B = 3;
+    crossfader.sourceID = 4;
+    crossfader.hotSink = HS_SINKA;
+    ASSERT_EQ(E_OK, pDatabaseHandler.enterCrossfaderDB(crossfader,crossfaderID));
+
+    // the crossfader is served by the interface of its source
+    EXPECT_CALL(pMockInterface,asyncCrossFade(_,5,HS_SINKB,RAMP_GENIVI_DIRECT,200)).WillOnce(Return(E_OK));
+    ASSERT_EQ(E_OK, pControlReceiver.crossfade(handle,HS_SINKB,5,RAMP_GENIVI_DIRECT,200));
+    ASSERT_EQ(handle.handleType, H_CROSSFADE);
+
+    ASSERT_EQ(E_OK, pDatabaseHandler.removeCrossfaderDB(5));
+    ASSERT_EQ(E_NON_EXISTENT, pRoutingSender.asyncCrossFade(handle,5,HS_SINKA,RAMP_GENIVI_DIRECT,200));
+}
+
+TEST_F(CAmRoutingInterfaceTest,volumeCoalescing)
+{
+    am_Sink_s sink;
+    am_sinkID_t sinkID;
+    am_Domain_s domain;
+    am_domainID_t domainID;
+    am_Handle_s handle1, handle2, handle3;
+    pCF.createSink(sink);
+    pCF.createDomain(domain);
+    domain.name = "mock";
+    domain.busname = "mock";
+    sink.sinkID = 2;
+    sink.domainID = DYNAMIC_ID_BOUNDARY;
+    ASSERT_EQ(E_OK, pDatabaseHandler.enterDomainDB(domain,domainID));
+    ASSERT_EQ(E_OK, pDatabaseHandler.enterSinkDB(sink,sinkID));
+    pRoutingSender.setVolumeCoalescing(true);
+
+    // the second change waits for the first, the third replaces the second
+    EXPECT_CALL(pMockInterface,asyncSetSinkVolume(_,sinkID,10,_,_)).WillOnce(Return(E_OK));
+    ASSERT_EQ(E_OK, pControlReceiver.setSinkVolume(handle1,sinkID,10,RAMP_GENIVI_DIRECT,100));
+    ASSERT_EQ(E_OK, pControlReceiver.setSinkVolume(handle2,sinkID,20,RAMP_GENIVI_DIRECT,100));
+    ASSERT_EQ(E_OK, pControlReceiver.setSinkVolume(handle3,sinkID,30,RAMP_GENIVI_DIRECT,100));
+    ASSERT_NE(handle1.handle, handle2.handle);
+    ASSERT_EQ(handle2.handle, handle3.handle);
+    Mock::VerifyAndClearExpectations(&pMockInterface);
+
+    // only the newest target is sent when the first is acknowledged
+    EXPECT_CALL(pMockInterface,asyncSetSinkVolume(_,sinkID,30,_,_)).WillOnce(Return(E_OK));
+    EXPECT_CALL(pMockControlInterface,cbAckSetSinkVolumeChange(_,10,E_OK));
+    pRoutingReceiver.ackSetSinkVolumeChange(handle1,10,E_OK);
+    Mock::VerifyAndClearExpectations(&pMockInterface);
+
+    EXPECT_CALL(pMockControlInterface,cbAckSetSinkVolumeChange(_,30,E_OK));
+    pRoutingReceiver.ackSetSinkVolumeChange(handle2,30,E_OK);
+    am_Sink_s sinkData;
+    ASSERT_EQ(E_OK, pDatabaseHandler.getSinkInfoDB(sinkID, sinkData));
+    ASSERT_EQ(sinkData.volume, 30);
+
+    // nothing runs anymore, so the next change is sent at once
+    EXPECT_CALL(pMockInterface,asyncSetSinkVolume(_,sinkID,40,_,_)).WillOnce(Return(E_OK));
+    ASSERT_EQ(E_OK, pControlReceiver.setSinkVolume(handle1,sinkID,40,RAMP_GENIVI_DIRECT,100));
+}
+
+TEST_F(CAmRoutingInterfaceTest,abortWaitingVolume)
+{
+    am_Sink_s sink;
+    am_sinkID_t sinkID;
+    am_Domain_s domain;
+    am_domainID_t domainID;
+    am_Handle_s handle1, handle2;
+    pCF.createSink(sink);
+    pCF.createDomain(domain);
+    domain.name = "mock";
+    domain.busname = "mock";
+    sink.sinkID = 2;
+    sink.domainID = DYNAMIC_ID_BOUNDARY;
+    ASSERT_EQ(E_OK, pDatabaseHandler.enterDomainDB(domain,domainID));
+    ASSERT_EQ(E_OK, pDatabaseHandler.enterSinkDB(sink,sinkID));
+    EXPECT_CALL(pMockInterface,startupInterface(_)).WillOnce(Return(E_OK));
+    ASSERT_EQ(E_OK, pRoutingSender.startupInterfaces(&pRoutingReceiver));
+    ASSERT_EQ(E_OK, pRoutingSender.setHandleTimeout(H_SETSINKVOLUME, 200));
+    pRoutingSender.setVolumeCoalescing(true);
+
+    EXPECT_CALL(pMockInterface,asyncSetSinkVolume(_,sinkID,10,_,_)).WillOnce(Return(E_OK));
+    ASSERT_EQ(E_OK, pControlReceiver.setSinkVolume(handle1,sinkID,10,RAMP_GENIVI_DIRECT,100));
+    ASSERT_EQ(E_OK, pControlReceiver.setSinkVolume(handle2,sinkID,20,RAMP_GENIVI_DIRECT,100));
+
+    // the routing plugin never got the waiting change, so it is aborted without it
+    auto isHandle2 = Truly([&](const am_Handle_s &h) { return (h.handle == handle2.handle); });
+    EXPECT_CALL(pMockInterface,asyncAbort(_)).Times(0);
+    EXPECT_CALL(pMockControlInterface,cbAckSetSinkVolumeChange(isHandle2,20,E_ABORTED));
+    ASSERT_EQ(E_OK, pControlReceiver.abortAction(handle2));
+    Mock::VerifyAndClearExpectations(&pMockInterface);
+    Mock::VerifyAndClearExpectations(&pMockControlInterface);
+
+    // nothing waits anymore, the next change waits again and is sent after the acknowledge with its own timeout
+    ASSERT_EQ(E_OK, pControlReceiver.setSinkVolume(handle2,sinkID,30,RAMP_GENIVI_DIRECT,100));
+    timespec stop = { 0, 150000000 };
+    sh_timerHandle_t stopTimer;
+    ASSERT_EQ(E_OK, pSocketHandler.addTimer(stop, [&](const sh_timerHandle_t, void *) {
+        EXPECT_CALL(pMockInterface,asyncSetSinkVolume(_,sinkID,30,_,_)).WillOnce(Return(E_OK));
+        EXPECT_CALL(pMockControlInterface,cbAckSetSinkVolumeChange(_,10,E_OK));
+        pRoutingReceiver.ackSetSinkVolumeChange(handle1,10,E_OK);
+    }, stopTimer, NULL));
+    timespec stop2 = { 0, 250000000 };
+    sh_timerHandle_t stopTimer2;
+    ASSERT_EQ(E_OK, pSocketHandler.addTimer(stop2, [&](const sh_timerHandle_t, void *) { pSocketHandler.exit_mainloop(); }, stopTimer2, NULL));
+    EXPECT_CALL(pMockInterface,asyncAbort(_)).Times(0);
+    pSocketHandler.start_listenting();
+
+    std::vector<am_Handle_s> listHandles;
+    ASSERT_EQ(E_OK, pControlReceiver.getListHandles(listHandles));
+    ASSERT_EQ(1u, listHandles.size());
+    ASSERT_EQ(handle2.handle, listHandles[0].handle);
+}
+
+TEST_F(CAmRoutingInterfaceTest,volumeTickThrottling)
+{
+    am_Handle_s handle;
+    handle.handle = 7;
+    handle.handleType = H_SETSINKVOLUME;
+    am_Handle_s otherHandle;
+    otherHandle.handle = 8;
+    otherHandle.handleType = H_SETSINKVOLUME;
+    auto isHandle = Truly([&](const am_Handle_s &h) { return (h.handle == handle.handle); });
+    auto isOtherHandle = Truly([&](const am_Handle_s &h) { return (h.handle == otherHandle.handle); });
+
+    // without interval every tick is forwarded when it comes
+    EXPECT_CALL(pMockControlInterface,hookSystemSinkVolumeTick(isHandle,2,10));
+    pRoutingReceiver.ackSinkVolumeTick(handle,2,10);
+    Mock::VerifyAndClearExpectations(&pMockControlInterface);
+
+    // the latest tick per sink and source is forwarded once per interval
+    pRoutingReceiver.setVolumeTickInterval(100);
+    EXPECT_CALL(pMockControlInterface,hookSystemSinkVolumeTick(_,_,_)).Times(0);
+    EXPECT_CALL(pMockControlInterface,hookSystemSourceVolumeTick(_,_,_)).Times(0);
+    EXPECT_CALL(pMockControlInterface,hookSystemSinkVolumeTick(isHandle,2,30));
+    EXPECT_CALL(pMockControlInterface,hookSystemSinkVolumeTick(isOtherHandle,3,50));
+    EXPECT_CALL(pMockControlInterface,hookSystemSourceVolumeTick(isOtherHandle,4,60));
+    for (am_volume_t volume = 20; volume <= 30; volume++)
+    {
+        pRoutingReceiver.ackSinkVolumeTick(handle,2,volume);
+    }
+
+    pRoutingReceiver.ackSinkVolumeTick(otherHandle,3,50);
+    pRoutingReceiver.ackSourceVolumeTick(otherHandle,4,60);
+
+    timespec stop = { 0, 150000000 };
+    sh_timerHandle_t stopTimer;
+    ASSERT_EQ(E_OK, pSocketHandler.addTimer(stop, [&](const sh_timerHandle_t, void *) { pSocketHandler.exit_mainloop(); }, stopTimer, NULL));
+    pSocketHandler.start_listenting();
+    Mock::VerifyAndClearExpectations(&pMockControlInterface);
+
+    // the waiting tick of a ramp comes before its acknowledge
+    {
+        InSequence sequence;
+        EXPECT_CALL(pMockControlInterface,hookSystemSinkVolumeTick(isHandle,2,40));
+        EXPECT_CALL(pMockControlInterface,cbAckSetSinkVolumeChange(isHandle,45,E_OK));
+    }
+
+    pRoutingReceiver.ackSinkVolumeTick(handle,2,40);
+    pRoutingReceiver.ackSetSinkVolumeChange(handle,45,E_OK);
+    Mock::VerifyAndClearExpectations(&pMockControlInterface);
+    pRoutingReceiver.setVolumeTickInterval(0);
+}
 
 int main(int argc, char **argv)
 {
@@ -58,6 +58,7 @@
 #include "CAmDltWrapper.h"
 #include "CAmSocketHandler.h"
 #include "CAmCommandLineSingleton.h"
+#include "CAmStartupProfiler.h"
 #include "CAmDatabaseHandlerMap.h"
 
 #ifndef AUDIOMANGER_APP_ID
@@ -75,7 +76,7 @@ std::vector<std::string> listCommandPluginDirs;
 std::vector<std::string> listRoutingPluginDirs;
 
 // List of signals to be handled with signalfd
-std::vector<uint8_t> listOfSignalsFD = { SIGHUP, SIGTERM, SIGCHLD };
+std::vector<uint8_t> listOfSignalsFD = { SIGHUP, SIGTERM, SIGCHLD, SIGUSR1 };
 
 // commandline options used by the Audiomanager itself
 TCLAP::ValueArg<std::string>  controllerPlugin("c", "controllerPlugin", "use controllerPlugin full path with .so ending", false, CONTROLLER_PLUGIN_DIR, "string");
@@ -84,11 +85,25 @@ TCLAP::ValueArg<std::string>  additionalRoutingPluginDirs("R", "additionalRoutin
 TCLAP::ValueArg<std::string>  routingPluginDir("r", "RoutingPluginDir", "path for looking for routing plugins", false, " ", "string");
 TCLAP::ValueArg<std::string>  commandPluginDir("l", "CommandPluginDir", "path for looking for command plugins", false, " ", "string");
 TCLAP::ValueArg<std::string>  dltLogFilename("F", "dltLogFilename", "the name of the logfile, absolute path. Only if logging is et to file", false, " ", "string");
+TCLAP::ValueArg<unsigned int> dltLogFileSize("S", "dltLogFileSize", "the size of the logfile in kB before it is rotated. Only if logging is set to file", false, 1024, "int");
+TCLAP::ValueArg<unsigned int> dltLogFileCount("N", "dltLogFileCount", "the number of rotated logfiles that are kept. Only if logging is set to file", false, 4, "int");
+TCLAP::ValueArg<unsigned int> dltLogFileSync("Y", "dltLogFileSync", "when the logfile is synced to the storage. 0=never, 1=when it is rotated(default), 2=after every line", false, 1, "int");
+TCLAP::ValueArg<unsigned int> flightRecorderSize("D", "flightRecorderSize", "the size in kB of the ring that keeps the recent debug logs in memory, 0=off(default)", false, 0, "int");
+TCLAP::ValueArg<std::string>  flightRecorderFile("P", "flightRecorderFile", "the file the recent logs are dumped to on a crash or SIGUSR1", false, "/tmp/AudioManager.flightrecorder", "string");
+TCLAP::ValueArg<std::string>  startupTraceFile("j", "startupTraceFile", "the file the startup phases are written to as Chrome trace, absolute path. Empty for none(default)", false, "", "string");
+TCLAP::ValueArg<unsigned int> startupReportDeadline("J", "startupReportDeadline", "the time in ms the startup report waits for plugins that are not ready, then they are reported as open. 0=wait for all, default 10000", false, 10000, "int");
+TCLAP::ValueArg<unsigned int> handleTimeout("t", "handleTimeout", "the time in ms a routing plugin has to acknowledge an action before it is aborted, 0=no supervision(default)", false, 0, "int");
+TCLAP::ValueArg<unsigned int> volumeTickInterval("V", "volumeTickInterval", "the volume ticks of a sink or source are forwarded to the controller at most once per interval in ms, 0=every tick(default)", false, 0, "int");
 TCLAP::ValueArg<unsigned int> dltOutput("O", "dltOutput", "defines where logs are written. 0=dlt-daemon(default), 1=command line, 2=file ", false, 0, "int");
 TCLAP::SwitchArg              dltEnable("e", "dltEnable", "Enables or disables dlt logging. Default = enabled", true);
+TCLAP::SwitchArg              dltAsync("a", "dltAsync", "logs are written by a background thread, logging never waits for the output", false);
 TCLAP::SwitchArg              dbusWrapperTypeBool("T", "dbusType", "DbusType to be used by CAmDbusWrapper: if option is selected, DBUS_SYSTEM is used otherwise DBUS_SESSION", false);
+TCLAP::SwitchArg              volumeCoalescing("C", "volumeCoalescing", "a sink or source has at most one volume change at the routing plugin, newer changes wait and replace each other", false);
 TCLAP::SwitchArg              currentSettings("i", "currentSettings", "print current settings and exit", false);
 TCLAP::SwitchArg              daemonizeAM("d", "daemonize", "daemonize Audiomanager. Better use systemd...", false);
+#ifdef WITH_IO_URING
+TCLAP::SwitchArg              ioUring("u", "ioUring", "use io_uring for the mainloop, falls back to ppoll if the kernel does not support it", false);
+#endif
 
 int fd0, fd1, fd2;
 
@@ -180,6 +195,27 @@ void printCmdInformation()
     exit(0);
 }
 
+/**
+ * dumps the flight recorder and lets the signal crash the process
+ * @param sig
+ * @param siginfo
+ * @param context
+ */
+static void crashHandler(int sig, siginfo_t *siginfo, void *context)
+{
+    (void)siginfo;
+    (void)context;
+    const int fd = open(flightRecorderFile.getValue().c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
+    if (fd != -1)
+    {
+        CAmDltWrapper::instance()->dumpFlightRecorder(fd);
+        close(fd);
+    }
+
+    // the handler was reset, so the signal takes its default action now
+    raise(sig);
+}
+
 /**
  * the signal handler
  * @param sig
@@ -212,6 +248,8 @@ static void signalHandler(int sig, siginfo_t *siginfo, void *context)
 
 void mainProgram(int argc, char *argv[])
 {
+    CAmStartupProfiler *pProfiler(CAmStartupProfiler::instance());
+    pProfiler->step("command line preparse");
 
     // initialize the commandline parser, and add all neccessary commands
     try
@@ -226,9 +264,23 @@ void mainProgram(int argc, char *argv[])
         cmd->add(daemonizeAM);
         cmd->add(dltEnable);
         cmd->add(dltLogFilename);
+        cmd->add(dltLogFileSize);
+        cmd->add(dltLogFileCount);
+        cmd->add(dltLogFileSync);
         cmd->add(dltOutput);
+        cmd->add(dltAsync);
+        cmd->add(flightRecorderSize);
+        cmd->add(flightRecorderFile);
+        cmd->add(handleTimeout);
+        cmd->add(volumeCoalescing);
+        cmd->add(volumeTickInterval);
+        cmd->add(startupTraceFile);
+        cmd->add(startupReportDeadline);
 #ifdef WITH_DBUS_WRAPPER
         cmd->add(dbusWrapperTypeBool);
+#endif
+#ifdef WITH_IO_URING
+        cmd->add(ioUring);
 #endif
     }
     catch (TCLAP::ArgException &e)  // catch any exceptions
@@ -244,15 +296,47 @@ void mainProgram(int argc, char *argv[])
         daemonize();
     }
 
+    pProfiler->setTraceFile(startupTraceFile.getValue());
+    pProfiler->step("logging");
     CAmDltWrapper::instanctiateOnce(AUDIOMANGER_APP_ID, AUDIOMANGER_APP_DESCRIPTION, dltEnable.getValue(), static_cast<am::CAmDltWrapper::logDestination>(dltOutput.getValue()), dltLogFilename.getValue());
+    if (dltOutput.getValue() == CAmDltWrapper::FILE_OUT)
+    {
+        CAmDltWrapper::instance()->configureLogFile(dltLogFileSize.getValue() * 1024, dltLogFileCount.getValue(), static_cast<CAmLogFileSink::syncPolicy_e>(dltLogFileSync.getValue()));
+    }
+
+    if (dltAsync.getValue())
+    {
+        CAmDltWrapper::instance()->enableAsyncLogging(true);
+    }
+
+    if (flightRecorderSize.getValue() > 0)
+    {
+        CAmDltWrapper::instance()->enableFlightRecorder(flightRecorderSize.getValue() * 1024);
+        struct sigaction crashAction;
+        memset(&crashAction, '\0', sizeof(crashAction));
+        crashAction.sa_sigaction = &crashHandler;
+        crashAction.sa_flags     = SA_SIGINFO | SA_RESETHAND;
+        for (int sig : { SIGSEGV, SIGBUS, SIGFPE, SIGILL, SIGABRT })
+        {
+            sigaction(sig, &crashAction, NULL);
+        }
+    }
 
     // Instantiate all classes. Keep in same order !
+    pProfiler->step("socket handler");
     CAmSocketHandler iSocketHandler;
     if (iSocketHandler.fatalErrorOccurred())
     {
         throw std::runtime_error(std::string("CAmSocketHandler: Could not create pipe or file descriptor is invalid."));
     }
 
+#ifdef WITH_IO_URING
+    if (ioUring.getValue() && (iSocketHandler.setBackend(CAmSocketHandler::BACKEND_IO_URING) != E_OK))
+    {
+        logWarning("io_uring is not supported, the mainloop uses ppoll");
+    }
+#endif
+
     if (E_OK != iSocketHandler.listenToSignals(listOfSignalsFD))
     {
         logWarning("CAmSocketHandler failed to register itself as signal handler.");
@@ -278,6 +362,14 @@ void mainProgram(int argc, char *argv[])
             case SIGHUP:
                 CAmControlSender::CallsetControllerRundownSafe(sig);
                 break;
+
+            case SIGUSR1:
+                if (!CAmDltWrapper::instance()->dumpFlightRecorder(flightRecorderFile.getValue()))
+                {
+                    logWarning("the flight recorder could not be dumped to", flightRecorderFile.getValue());
+                }
+
+                break;
             default:
                 break;
             }
@@ -309,13 +401,25 @@ void mainProgram(int argc, char *argv[])
     // this must be done in the constructor.
     // later when the plugins are started, the commandline is already parsed and the objects defined before can be used to get the neccesary information
 
+    pProfiler->step("database");
     CAmDatabaseHandlerMap iDatabaseHandler;
     IAmDatabaseHandler   *pDatabaseHandler = dynamic_cast<IAmDatabaseHandler *>(&iDatabaseHandler);
 
+    pProfiler->step("routing plugins");
     CAmRoutingSender iRoutingSender(listRoutingPluginDirs, pDatabaseHandler);
+    for (int type = H_CONNECT; type < H_MAX; type++)
+    {
+        iRoutingSender.setHandleTimeout(static_cast<am_Handle_e>(type), handleTimeout.getValue());
+    }
+
+    iRoutingSender.setVolumeCoalescing(volumeCoalescing.getValue());
+
+    pProfiler->step("command plugins");
     CAmCommandSender iCommandSender(listCommandPluginDirs, &iSocketHandler);
+    pProfiler->step("control plugin");
     CAmControlSender iControlSender(controllerPlugin.getValue(), &iSocketHandler);
 
+    pProfiler->step("command line parse");
     try
     {
         // parse the commandline options
@@ -335,11 +439,13 @@ void mainProgram(int argc, char *argv[])
     logInfo("The version of the Audiomanager", DAEMONVERSION EXTRAVERSIONINFO);
 
 #ifdef WITH_CAPI_WRAPPER
+    pProfiler->step("CommonAPI");
     // We instantiate a singleton with the current socket handler, which loads the common-api runtime.
     CAmCommonAPIWrapper *pCAPIWrapper = CAmCommonAPIWrapper::instantiateOnce(&iSocketHandler, "AudioManager");
 #endif /*WITH_CAPI_WRAPPER */
 
 #ifdef WITH_DBUS_WRAPPER
+    pProfiler->step("D-Bus");
     if (dbusWrapperTypeBool.getValue())
     {
         dbusWrapperType = DBUS_BUS_SYSTEM;
@@ -351,6 +457,7 @@ void mainProgram(int argc, char *argv[])
     CAmWatchdog iWatchdog(&iSocketHandler);
 #endif /*WITH_SYSTEMD_WATCHDOG*/
 
+    pProfiler->step("receivers");
     CAmRouter iRouter(pDatabaseHandler, &iControlSender);
 
 #ifdef WITH_DBUS_WRAPPER
@@ -361,6 +468,8 @@ void mainProgram(int argc, char *argv[])
     CAmRoutingReceiver iRoutingReceiver(pDatabaseHandler, &iRoutingSender, &iControlSender, &iSocketHandler);
 #endif /*WITH_DBUS_WRAPPER*/
 
+    iRoutingReceiver.setVolumeTickInterval(volumeTickInterval.getValue());
+
     CAmControlReceiver iControlReceiver(pDatabaseHandler, &iRoutingSender, &iCommandSender, &iSocketHandler, &iRouter);
 
     iDatabaseHandler.registerObserver(&iRoutingSender);
@@ -368,12 +477,17 @@ void mainProgram(int argc, char *argv[])
     iDatabaseHandler.registerObserver(&iRouter);
 // startup all the Plugins and Interfaces
 // at this point, commandline arguments can be parsed
+    pProfiler->step("startupController");
     iControlSender.startupController(&iControlReceiver);
+    pProfiler->step("command startupInterfaces");
     iCommandSender.startupInterfaces(&iCommandReceiver);
+    pProfiler->step("routing startupInterfaces");
     iRoutingSender.startupInterfaces(&iRoutingReceiver);
 
 // when the routingInterface is done, all plugins are loaded:
+    pProfiler->step("setControllerReady");
     iControlSender.setControllerReady();
+    pProfiler->ready(&iSocketHandler, startupReportDeadline.getValue());
 
 #ifdef WITH_SYSTEMD_WATCHDOG
     iWatchdog.startWatchdog();
@@ -381,6 +495,9 @@ void mainProgram(int argc, char *argv[])
 
     // start the mainloop here....
     iSocketHandler.start_listenting();
+
+    // writes out what is still buffered
+    CAmDltWrapper::instance()->enableAsyncLogging(false);
 }
 
 /**
@@ -426,6 +543,7 @@ int main(int argc, char *argv[], char * *envp)
     catch (std::exception &exc)
     {
         logError("The AudioManager ended by throwing the exception", exc.what());
+        CAmDltWrapper::instance()->enableAsyncLogging(false);
         std::cerr << "The AudioManager ended by throwing an exception " << exc.what() << std::endl;
         exit(EXIT_FAILURE);
     }
@@ -0,0 +1,492 @@
+/**
+ * SPDX license identifier: MPL-2.0
+ *
+ * Copyright (C) 2012, BMW AG
+ *
+ * This file is part of GENIVI Project AudioManager.
+ *
+ * Contributions are licensed to the GENIVI Alliance under one or more
+ * Contribution License Agreements.
+ *
+ * \copyright
+ * This Source Code Form is subject to the terms of the
+ * Mozilla Public License, v. 2.0. If a  copy of the MPL was not distributed with
+ * this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ *
+ * \file CAmCoroutine.h
+ * For further information see http://www.genivi.org/.
+ *
+ */
+
+#ifndef COROUTINE_H_
+#define COROUTINE_H_
+
+/**
+ * The AudioManager itself is built as C++11, coroutines need C++20. Everything in here is header only, so plugins
+ * which are built with C++20 can use it, for all others the header is empty.
+ */
+#if defined(__cpp_impl_coroutine) && (__cpp_impl_coroutine >= 201902L)
+
+#include <coroutine>
+#include <exception>
+#include <map>
+#include <optional>
+#include <utility>
+#include "CAmSocketHandler.h"
+#include "CAmSerializer.h"
+#include "CAmDltWrapper.h"
+
+namespace am
+{
+
+template<class T = void>
+class TAmTask;
+
+/**
+ * The parts of the task promise which do not depend on the result type.
+ * A task starts suspended. When it ends, it resumes the coroutine that awaits it, or destroys itself if it was started
+ * with TAmTask::start.
+ */
+class CAmTaskPromiseBase
+{
+public:
+    struct final_awaiter_s
+    {
+        bool await_ready() noexcept
+        {
+            return (false);
+        }
+
+        template<class TPromise>
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<TPromise> handle) noexcept
+        {
+            CAmTaskPromiseBase &promise = handle.promise();
+            if (promise.mContinuation)
+            {
+                return (promise.mContinuation);
+            }
+
+            if (promise.mDetached)
+            {
+                if (promise.mException)
+                {
+                    logError("TAmTask: a started task ended with an exception");
+                }
+
+                handle.destroy();
+            }
+
+            return (std::noop_coroutine());
+        }
+
+        void await_resume() noexcept
+        {
+        }
+    };
+
+    std::suspend_always initial_suspend() noexcept
+    {
+        return {};
+    }
+
+    final_awaiter_s final_suspend() noexcept
+    {
+        return {};
+    }
+
+    void unhandled_exception()
+    {
+        mException = std::current_exception();
+    }
+
+    std::coroutine_handle<> mContinuation; //!< the coroutine that awaits the task
+    std::exception_ptr      mException;
+    bool                    mDetached = false; //!< nobody owns the task, it destroys itself at the end
+};
+
+template<class T>
+class CAmTaskPromise : public CAmTaskPromiseBase
+{
+public:
+    TAmTask<T> get_return_object() noexcept;
+
+    void return_value(T value)
+    {
+        mValue.emplace(std::move(value));
+    }
+
+    T result()
+    {
+        if (mException)
+        {
+            std::rethrow_exception(mException);
+        }
+
+        return (std::move(*mValue));
+    }
+
+private:
+    std::optional<T> mValue;
+};
+
+template<>
+class CAmTaskPromise<void> : public CAmTaskPromiseBase
+{
+public:
+    TAmTask<void> get_return_object() noexcept;
+
+    void return_void() noexcept
+    {
+    }
+
+    void result()
+    {
+        if (mException)
+        {
+            std::rethrow_exception(mException);
+        }
+    }
+};
+
+/**
+ * A coroutine that runs in the mainloop. It can be awaited by another coroutine, which gets the result, or started
+ * with start, the task then runs on its own and cleans up when it ends.
+ * \section ex Example:
+ * @code
+ * TAmTask<am_Error_e> connectAndSetVolume(...)
+ * {
+ *     am_Handle_s handle;
+ *     mpControlReceive->connect(handle, connectionID, format, sourceID, sinkID);
+ *     mAcks.expect(handle);
+ *     am_Error_e error = co_await mAcks.ack(handle);
+ *     if (error == E_OK)
+ *     {
+ *         mpControlReceive->setSinkVolume(handle, sinkID, volume, RAMP_GENIVI_DIRECT, 0);
+ *         mAcks.expect(handle);
+ *         error = co_await mAcks.ack(handle);
+ *     }
+ *     co_return (error);
+ * }
+ * connectAndSetVolume(...).start();
+ * @endcode
+ */
+template<class T>
+class TAmTask
+{
+public:
+    typedef CAmTaskPromise<T> promise_type;
+
+    explicit TAmTask(std::coroutine_handle<promise_type> handle) noexcept
+        : mHandle(handle)
+    {
+    }
+
+    TAmTask(TAmTask &&other) noexcept
+        : mHandle(std::exchange(other.mHandle, nullptr))
+    {
+    }
+
+    TAmTask(const TAmTask &) = delete;
+    TAmTask &operator=(const TAmTask &) = delete;
+
+    ~TAmTask()
+    {
+        if (mHandle)
+        {
+            mHandle.destroy();
+        }
+    }
+
+    /**
+     * runs the task until its first suspension and gives up the ownership, the task destroys itself when it ends
+     */
+    void start()
+    {
+        std::coroutine_handle<promise_type> handle = std::exchange(mHandle, nullptr);
+        handle.promise().mDetached = true;
+        handle.resume();
+    }
+
+    bool await_ready() const noexcept
+    {
+        return (false);
+    }
+
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept
+    {
+        mHandle.promise().mContinuation = awaiting;
+        return (mHandle);
+    }
+
+    T await_resume()
+    {
+        return (mHandle.promise().result());
+    }
+
+private:
+    std::coroutine_handle<promise_type> mHandle;
+};
+
+template<class T>
+TAmTask<T> CAmTaskPromise<T>::get_return_object() noexcept
+{
+    return (TAmTask<T>(std::coroutine_handle<CAmTaskPromise<T> >::from_promise(*this)));
+}
+
+inline TAmTask<void> CAmTaskPromise<void>::get_return_object() noexcept
+{
+    return (TAmTask<void>(std::coroutine_handle<CAmTaskPromise<void> >::from_promise(*this)));
+}
+
+/**
+ * awaits until a filedescriptor gets readable, or any other of the given events.
+ * The result is the revents of the poll, POLLNVAL if the filedescriptor could not be polled.
+ */
+class CAmAwaitFd
+{
+public:
+    CAmAwaitFd(CAmSocketHandler &socketHandler, const int fd, const short events)
+        : mSocketHandler(socketHandler)
+        , mFd(fd)
+        , mEvents(events)
+        , mRevents(POLLNVAL)
+    {
+    }
+
+    bool await_ready() const noexcept
+    {
+        return (false);
+    }
+
+    bool await_suspend(std::coroutine_handle<> awaiting)
+    {
+        sh_pollHandle_t handle;
+        auto fired = [this, awaiting](const pollfd pollfd, const sh_pollHandle_t handle, void *) {
+                // removing the poll destroys this callback, so only the local copy is used after it
+                std::coroutine_handle<> resume = awaiting;
+                mRevents = pollfd.revents;
+                mSocketHandler.removeFDPoll(handle);
+                resume.resume();
+            };
+        return (mSocketHandler.addFDPoll(mFd, mEvents, NULL, fired, NULL, NULL, NULL, handle) == E_OK);
+    }
+
+    short await_resume() const noexcept
+    {
+        return (mRevents);
+    }
+
+private:
+    CAmSocketHandler &mSocketHandler;
+    const int         mFd;
+    const short       mEvents;
+    short             mRevents;
+};
+
+/**
+ * awaits the expiry of a one shot timer
+ */
+class CAmAwaitTimer
+{
+public:
+    CAmAwaitTimer(CAmSocketHandler &socketHandler, const timespec &timeout)
+        : mSocketHandler(socketHandler)
+        , mTimeout(timeout)
+    {
+    }
+
+    bool await_ready() const noexcept
+    {
+        return ((mTimeout.tv_sec == 0) && (mTimeout.tv_nsec == 0));
+    }
+
+    bool await_suspend(std::coroutine_handle<> awaiting)
+    {
+        sh_timerHandle_t handle;
+        auto callback = [this, awaiting](const sh_timerHandle_t handle, void *) {
+                // removing the timer destroys this callback, so only the local copy is used after it
+                std::coroutine_handle<> resume = awaiting;
+                mSocketHandler.removeTimer(handle);
+                resume.resume();
+            };
+        return (mSocketHandler.addTimer(mTimeout, callback, handle, NULL) == E_OK);
+    }
+
+    void await_resume() const noexcept
+    {
+    }
+
+private:
+    CAmSocketHandler &mSocketHandler;
+    const timespec    mTimeout;
+};
+
+/**
+ * continues the coroutine in the mainloop, can be awaited from any thread.
+ * The serializer must not use OVERFLOW_DROP, a dropped call would never resume the coroutine.
+ */
+class CAmAwaitMainloop
+{
+public:
+    explicit CAmAwaitMainloop(V2::CAmSerializer &serializer)
+        : mSerializer(serializer)
+    {
+    }
+
+    bool await_ready() const noexcept
+    {
+        return (false);
+    }
+
+    void await_suspend(std::coroutine_handle<> awaiting)
+    {
+        mSerializer.asyncInvocation(std::bind([](std::coroutine_handle<> handle) {
+                handle.resume();
+            }, awaiting));
+    }
+
+    void await_resume() const noexcept
+    {
+    }
+
+private:
+    V2::CAmSerializer &mSerializer;
+};
+
+inline CAmAwaitFd awaitFd(CAmSocketHandler &socketHandler, const int fd, const short events = POLLIN)
+{
+    return (CAmAwaitFd(socketHandler, fd, events));
+}
+
+inline CAmAwaitTimer awaitTimer(CAmSocketHandler &socketHandler, const timespec &timeout)
+{
+    return (CAmAwaitTimer(socketHandler, timeout));
+}
+
+inline CAmAwaitMainloop awaitMainloop(V2::CAmSerializer &serializer)
+{
+    return (CAmAwaitMainloop(serializer));
+}
+
+/**
+ * connects the acknowledgements of asynchronous actions to the coroutines waiting for them.
+ * The controller forwards every cbAck* to complete, a coroutine awaits ack with the handle it got from the action.
+ * An acknowledgement can arrive before the coroutine awaits it, for example because the routing plugin acknowledged
+ * within the call. It is only kept if the coroutine called expect with the handle right after the action, all other
+ * acknowledgements that nobody waits for are dropped, so a handle number that is used again never sees an old one.
+ */
+class CAmHandleAwaiter
+{
+public:
+    class CAmAwaitAck
+    {
+    public:
+        CAmAwaitAck(CAmHandleAwaiter &awaiter, const am_Handle_s handle)
+            : mAwaiter(awaiter)
+            , mKey(key(handle))
+            , mError(E_UNKNOWN)
+        {
+        }
+
+        bool await_ready()
+        {
+            std::map<uint16_t, expected_s>::iterator it = mAwaiter.mExpected.find(mKey);
+            if ((it == mAwaiter.mExpected.end()) || !it->second.completed)
+            {
+                return (false);
+            }
+
+            mError = it->second.error;
+            mAwaiter.mExpected.erase(it);
+            return (true);
+        }
+
+        void await_suspend(std::coroutine_handle<> awaiting)
+        {
+            mAwaiter.mExpected.erase(mKey);
+            mAwaiter.mWaiting[mKey] = waiting_s { awaiting, &mError };
+        }
+
+        am_Error_e await_resume() const noexcept
+        {
+            return (mError);
+        }
+
+    private:
+        CAmHandleAwaiter &mAwaiter;
+        const uint16_t    mKey;
+        am_Error_e        mError;
+    };
+
+    /**
+     * keeps the acknowledgement of the handle if it arrives before it is awaited
+     * @param handle the handle the action just returned
+     */
+    void expect(const am_Handle_s handle)
+    {
+        mExpected[key(handle)] = expected_s { false, E_UNKNOWN };
+    }
+
+    /**
+     * @param handle the handle of the action
+     * @return awaitable with the error of the acknowledgement as result
+     */
+    CAmAwaitAck ack(const am_Handle_s handle)
+    {
+        return (CAmAwaitAck(*this, handle));
+    }
+
+    /**
+     * hands an acknowledgement over, resumes the waiting coroutine
+     * @param handle
+     * @param error
+     * @return true if a coroutine was waiting for the handle
+     */
+    bool complete(const am_Handle_s handle, const am_Error_e error)
+    {
+        std::map<uint16_t, waiting_s>::iterator it = mWaiting.find(key(handle));
+        if (it == mWaiting.end())
+        {
+            std::map<uint16_t, expected_s>::iterator expected = mExpected.find(key(handle));
+            if ((expected != mExpected.end()) && !expected->second.completed)
+            {
+                expected->second = expected_s { true, error };
+            }
+
+            return (false);
+        }
+
+        waiting_s waiting = it->second;
+        mWaiting.erase(it);
+        *waiting.pError = error;
+        waiting.coroutine.resume();
+        return (true);
+    }
+
+private:
+    struct waiting_s
+    {
+        std::coroutine_handle<> coroutine;
+        am_Error_e             *pError;
+    };
+
+    struct expected_s
+    {
+        bool       completed; //!< the acknowledgement arrived
+        am_Error_e error;
+    };
+
+    static uint16_t key(const am_Handle_s handle)
+    {
+        return (static_cast<uint16_t>((handle.handleType << 10) | handle.handle));
+    }
+
+    std::map<uint16_t, waiting_s>  mWaiting;   //!< coroutines waiting for an acknowledgement, by handle
+    std::map<uint16_t, expected_s> mExpected;  //!< handles that will be awaited, with their acknowledgement once it arrived
+};
+
+} /* namespace am */
+
+#endif /* __cpp_impl_coroutine */
+#endif /* COROUTINE_H_ */
@@ -25,8 +25,12 @@
 #include <fstream>
 #include <map>
 #include <vector>
+#include <atomic>
+#include <mutex>
+#include <thread>
 #include <audiomanagerconfig.h>
 #include "audiomanagertypes.h"
+#include "CAmLogFileSink.h"
 
 #ifdef WITH_DLT
 # include <dlt.h>
@@ -94,6 +98,14 @@ typedef enum
 
 #endif // WITH_DLT
 
+/**
+ * log calls with a less important level than this are removed by the compiler, set with the cmake variable
+ * AM_COMPILED_LOG_LEVEL
+ */
+#ifndef AM_COMPILED_LOG_LEVEL
+# define AM_COMPILED_LOG_LEVEL 6
+#endif
+
 namespace am
 {
 
@@ -157,7 +169,11 @@ public:
 
     ~CAmDltWrapper();
 
-    bool init(DltLogLevelType loglevel, DltContext *context = NULL);
+    /**
+     * starts a record
+     * @param output false if the record is only kept by the flight recorder
+     */
+    bool init(DltLogLevelType loglevel, DltContext *context = NULL, const bool output = true);
 
     bool checkLogLevel(DltLogLevelType logLevel)
     {
@@ -176,8 +192,135 @@ public:
 #endif      // ifdef WITH_DLT
     }
 
+    /**
+     * checks without taking a lock if a record with this level would be written
+     * @param logLevel
+     * @param context the context of the record, NULL for the default context
+     */
+    bool isLogLevelEnabled(const DltLogLevelType logLevel, DltContext *context = NULL)
+    {
+        if (!mDebugEnabled)
+        {
+            return (false);
+        }
+
+#ifdef WITH_DLT
+        if (mlogDestination == logDestination::DAEMON)
+        {
+# ifdef DLT_IS_LOG_LEVEL_ENABLED
+            return (dlt_user_is_logLevel_enabled(context ? context : &mDltContext, logLevel) == DLT_RETURN_TRUE);
+# else
+            (void)context;
+            return (true);
+# endif     // ifdef DLT_IS_LOG_LEVEL_ENABLED
+        }
+#endif      // ifdef WITH_DLT
+        (void)context;
+        return (!mOnlyError || (logLevel <= DLT_LOG_ERROR));
+    }
+
+    /**
+     * sets the rotation and the sync policy of the logfile, only if the destination is FILE_OUT
+     * @param segmentSize the size of the logfile before it is rotated
+     * @param numFiles the number of logfiles that are kept
+     * @param syncPolicy when the logfile is synced to the storage
+     * @return false if logging is not done to a file or the file could not be mapped again
+     */
+    bool configureLogFile(const size_t segmentSize, const unsigned numFiles, const CAmLogFileSink::syncPolicy_e syncPolicy);
+
+    /**
+     * the state of a call site for the rate limit, the AM_LOG_* macros keep one in a static variable at each call site.
+     * The tokens are counted in thousandths.
+     */
+    struct logSite_s
+    {
+        constexpr logSite_s()
+            : state(UINT64_MAX)
+            , suppressed(0)
+        {
+        }
+
+        std::atomic<uint64_t> state;      //!< the tokens in the upper, the time of the last update in ms in the lower half
+        std::atomic<uint32_t> suppressed; //!< records suppressed since the last one that was written
+    };
+
+    /**
+     * limits the number of records per call site with a token bucket. Only the records of the AM_LOG_* macros are
+     * limited, each use of a macro is a call site with its own bucket. The next record of a call site that is written
+     * again tells how many records of it were suppressed.
+     * Should be called before other threads start to log.
+     * @param context the context the limit is for, NULL for the default context
+     * @param logLevel the level the limit is for
+     * @param burst the number of records that can be written at once, 0 removes the limit
+     * @param perSecond the number of records per second that can be written after the burst
+     */
+    void setRateLimit(DltContext *context, const DltLogLevelType logLevel, const uint32_t burst, const uint32_t perSecond);
+
+    /**
+     * checks the rate limit of the call site of a record, does nothing if no limit is set
+     * @param site the call site, NULL if the record is not limited
+     * @param suppressed the number of records of the call site that were suppressed before, if the record can be written
+     * @return false if the record has to be suppressed
+     */
+    bool checkRateLimit(logSite_s *site, DltContext *context, const DltLogLevelType logLevel, uint32_t &suppressed)
+    {
+        suppressed = 0;
+        if ((site == NULL) || mRateLimits.empty())
+        {
+            return (true);
+        }
+
+        return (takeRateToken(*site, context, logLevel, suppressed));
+    }
+
+    struct logThreadBuffer_s; //!< the buffer of a thread for asynchronous logging, defined in the source
+    struct flightRecorder_s;  //!< the ring of the recent records, defined in the source
+
+    /**
+     * keeps the recent records in a ring in memory, also the ones that are not written because of their level. The
+     * records are kept in binary form and only formatted when the ring is dumped, after a crash for example.
+     * Should be called before other threads start to log.
+     * @param size the size of the ring in bytes, the oldest records are overwritten. 0 stops recording.
+     * @param logLevel the least important level that is recorded
+     */
+    void enableFlightRecorder(const size_t size, const DltLogLevelType logLevel = DLT_LOG_DEBUG);
+
+    bool isRecorded(const DltLogLevelType logLevel) const
+    {
+        return (logLevel <= mFlightRecorderLevel.load(std::memory_order_relaxed));
+    }
+
+    /**
+     * writes the records of the flight recorder as text into a file
+     * @return false if the flight recorder is not enabled or the file could not be created
+     */
+    bool dumpFlightRecorder(const std::string &filename);
+
+    /**
+     * writes the records of the flight recorder as text, without locking and allocating, for signal handlers of
+     * crashes. Records that are written at the same time are skipped, the times are in UTC.
+     */
+    void dumpFlightRecorder(const int fd);
+
     void deinit();
     void send();
+
+    /**
+     * switches to asynchronous logging. Each thread encodes its records in binary form into an own lock free buffer,
+     * the values are only copied. A background thread formats them and writes them to the destination.
+     * A record that does not fit into the buffer is dropped and counted, so logging never waits for the output or
+     * for other threads.
+     * Should be called before other threads start to log.
+     * @param enable true to start, false to write out all buffered records and go back to synchronous logging
+     * @param threadBufferSize the size of the buffer of each thread in bytes
+     */
+    void enableAsyncLogging(const bool enable, const size_t threadBufferSize = 65536);
+
+    /**
+     * waits until all buffered records are written, returns immediately if logging is synchronous
+     */
+    void flush();
+
     void append(const int8_t value);
     void append(const uint8_t value);
     void append(const int16_t value);
@@ -200,6 +343,11 @@ public:
     template<typename T = const char *>
     void append(const char *value)
     {
+        if (encodeString(value, false))
+        {
+            return;
+        }
+
 #ifdef WITH_DLT
         if (mlogDestination == logDestination::DAEMON)
         {
@@ -239,7 +387,7 @@ public:
             return;
         }
 
-        append(mStr_error[value]);
+        appendStatic(mStr_error[value]);
     }
 
     // specialization for const am_Error_e
@@ -253,7 +401,7 @@ public:
             return;
         }
 
-        append(mStr_sourceState[value]);
+        appendStatic(mStr_sourceState[value]);
     }
 
     template<typename T = const am_MuteState_e>
@@ -266,7 +414,7 @@ public:
             return;
         }
 
-        append(mStr_MuteState[value]);
+        appendStatic(mStr_MuteState[value]);
     }
 
     template<typename T = const am_DomainState_e>
@@ -279,7 +427,7 @@ public:
             return;
         }
 
-        append(mStr_DomainState[value]);
+        appendStatic(mStr_DomainState[value]);
     }
 
     template<typename T = const am_ConnectionState_e>
@@ -292,7 +440,7 @@ public:
             return;
         }
 
-        append(mStr_ConnectionState[value]);
+        appendStatic(mStr_ConnectionState[value]);
     }
 
     template<typename T = const am_Availability_e>
@@ -305,7 +453,7 @@ public:
             return;
         }
 
-        append(mStr_Availability[value]);
+        appendStatic(mStr_Availability[value]);
     }
 
     template<typename T = const am_InterruptState_e>
@@ -318,7 +466,7 @@ public:
             return;
         }
 
-        append(mStr_Interrupt[value]);
+        appendStatic(mStr_Interrupt[value]);
     }
 
     template<typename T = const am_Handle_e>
@@ -331,7 +479,7 @@ public:
             return;
         }
 
-        append(mStr_Handle[value]);
+        appendStatic(mStr_Handle[value]);
     }
 
     template<typename T = const am_Handle_s>
@@ -351,13 +499,18 @@ public:
             return;
         }
 
-        append(mStr_NotificationStatus[value]);
+        appendStatic(mStr_NotificationStatus[value]);
     }
 
     // Template to print unknown pointer types with their address
     template<typename T>
     void append(T *value)
     {
+        if (encodePointer(value))
+        {
+            return;
+        }
+
         std::ostringstream ss;
         ss << "0x" << std::hex << (uint64_t)value;
         append(ss.str().c_str());
@@ -387,7 +540,40 @@ private:
      */
     CAmDltWrapper(const char *appid, const char *description, const bool debugEnabled = true, const logDestination logDest = logDestination::DAEMON, const std::string Filename = "", bool onlyError = false); // is private because of singleton pattern
     bool initNoDlt(DltLogLevelType loglevel, DltContext *context);
-    std::string now();
+
+    /**
+     * the parts of init and send which write the record directly
+     * @param flushLine if false, the output stream is not flushed after the record
+     */
+    bool initSync(DltLogLevelType loglevel, DltContext *context);
+    void sendSync(const bool flushLine = true);
+
+    /**
+     * add the value to the binary record if the calling thread logs asynchronously
+     * @param isStatic the string lives as long as the program, so only the pointer is kept
+     * @return false if the calling thread does not log asynchronously
+     */
+    bool encodeString(const char *value, const bool isStatic);
+    bool encodePointer(const void *value);
+
+    /**
+     * appends a string that lives as long as the program, like the names of the enum values
+     */
+    void appendStatic(const char *value);
+
+    bool takeRateToken(logSite_s &site, DltContext *context, const DltLogLevelType logLevel, uint32_t &suppressed);
+
+    /**
+     * formats a binary record with the append functions, must be called between initSync and sendSync
+     */
+    void decode(const char *data, const size_t length);
+    bool initEncoded(DltLogLevelType loglevel, DltContext *context, const bool output, const bool recorded);
+    void sendEncoded();
+    void sendAsync(DltLogLevelType loglevel, DltContext *context, const std::string &arguments);
+    std::string contextName(DltContext *context);
+    logThreadBuffer_s *threadBuffer();
+    size_t drainAsync();
+    void asyncThread();
 
     DltContext                          mDltContext;       //!< the default context
     DltContextData                      mDltContextData;   //!< contextdata
@@ -395,40 +581,93 @@ private:
     std::map<DltContext *, std::string> mMapContext;       //!< a Map for all registered context
     bool mDebugEnabled;                                    //!< debug Enabled or not
     logDestination                      mlogDestination;   //!< The log destination
-    std::ofstream                       mFilename;         //!< Filename for logging
+    CAmLogFileSink                      mFileSink;         //!< the file for logging
     bool                   mOnlyError;                     //!< Only if Log Level is above Error
     bool                   mLogOn;                         //!< Used to keep track if currently logging is on
     static CAmDltWrapper  *mpDLTWrapper;                   //!< pointer to the wrapper instance
     static pthread_mutex_t mMutex;
 
+    std::atomic<bool>      mAsync;                         //!< records are handed over to the background thread
+    size_t                 mAsyncBufferSize;               //!< size of the buffers of new threads
+    std::mutex             mAsyncMutex;                    //!< protects the list of buffers
+    std::vector<logThreadBuffer_s *> mAsyncBuffers;        //!< the buffers of all threads that logged asynchronously
+    std::thread            mAsyncThread;                   //!< writes the buffered records
+    int                    mAsyncEventFd;                  //!< wakes the background thread up
+    std::atomic<bool>      mAsyncSleeping;                 //!< the background thread waits for the eventfd
+    std::atomic<bool>      mAsyncStop;
+    std::atomic<uint64_t>  mAsyncDropped;                  //!< records dropped because a buffer was full
+    std::atomic<uint64_t>  mAsyncPasses;                   //!< completed passes of the background thread
+
+    struct rateLimit_s
+    {
+        uint32_t burst;
+        uint32_t perSecond;
+    };
+
+    std::map<std::pair<DltContext *, DltLogLevelType>, rateLimit_s> mRateLimits; //!< the limits per context and level
+
+    flightRecorder_s      *mpFlightRecorder;               //!< the recent records, NULL if never enabled
+    std::atomic<int>       mFlightRecorderLevel;           //!< the least important level that is recorded, DLT_LOG_DEFAULT if off
+
 };
 
 /**
- * logs given values with a given context (register first!) and given loglevel
+ * logs given values from a call site, with a given context (register first!) and given loglevel
+ * @param site the call site the rate limit is applied for, NULL if the record is not limited
  * @param context
  * @param loglevel
  * @param value
  * @param ...
  */
 template<typename T, typename... TArgs>
-void log(DltContext *const context, DltLogLevelType loglevel, T value, TArgs... args)
+void logSite(CAmDltWrapper::logSite_s *site, DltContext *const context, DltLogLevelType loglevel, T value, TArgs... args)
 {
+    if (loglevel > AM_COMPILED_LOG_LEVEL)
+    {
+        return;
+    }
+
     CAmDltWrapper *inst(CAmDltWrapper::instance());
-    if (!inst->getEnabled())
+    const bool     output = inst->isLogLevelEnabled(loglevel, context);
+    if (!output && !inst->isRecorded(loglevel))
     {
         return;
     }
 
-    if (!inst->init(loglevel, context))
+    uint32_t suppressed;
+    if (!inst->checkRateLimit(site, context, loglevel, suppressed))
+    {
+        return;
+    }
+
+    if (!inst->init(loglevel, context, output))
     {
         return;
     }
 
     inst->append(value);
     inst->append(args...);
+    if (suppressed)
+    {
+        inst->append("similar messages suppressed:", suppressed);
+    }
+
     inst->send();
 }
 
+/**
+ * logs given values with a given context (register first!) and given loglevel
+ * @param context
+ * @param loglevel
+ * @param value
+ * @param ...
+ */
+template<typename T, typename... TArgs>
+void log(DltContext *const context, DltLogLevelType loglevel, T value, TArgs... args)
+{
+    logSite(NULL, context, loglevel, std::move(value), std::move(args)...);
+}
+
 /**
  * logs given values with debuglevel with the default context
  * @param value
@@ -484,6 +723,41 @@ void logVerbose(T value, TArgs... args)
     log(NULL, DLT_LOG_VERBOSE, value, args...);
 }
 
+/**
+ * @return true if a record with this level is compiled in and would be written or recorded
+ */
+inline bool logLevelEnabled(const DltLogLevelType loglevel, DltContext *const context = NULL)
+{
+    if (loglevel > AM_COMPILED_LOG_LEVEL)
+    {
+        return (false);
+    }
+
+    CAmDltWrapper *inst(CAmDltWrapper::instance());
+    return (inst->isLogLevelEnabled(loglevel, context) || inst->isRecorded(loglevel));
+}
+
 }
 
+/**
+ * The log templates get their arguments evaluated, even if the level is not enabled. These macros check the level
+ * first, so expensive arguments like __METHOD_NAME__ are only built if the record is written. Each use of a macro is
+ * a call site for the rate limit.
+ */
+#define AM_LOG_AT(level, ...)                                 \
+    do                                                        \
+    {                                                         \
+        if (am::logLevelEnabled(level))                       \
+        {                                                     \
+            static am::CAmDltWrapper::logSite_s amLogSite;    \
+            am::logSite(&amLogSite, NULL, level, __VA_ARGS__); \
+        }                                                     \
+    } while (0)
+
+#define AM_LOG_ERROR(...)   AM_LOG_AT(DLT_LOG_ERROR, __VA_ARGS__)
+#define AM_LOG_WARNING(...) AM_LOG_AT(DLT_LOG_WARN, __VA_ARGS__)
+#define AM_LOG_INFO(...)    AM_LOG_AT(DLT_LOG_INFO, __VA_ARGS__)
+#define AM_LOG_DEBUG(...)   AM_LOG_AT(DLT_LOG_DEBUG, __VA_ARGS__)
+#define AM_LOG_VERBOSE(...) AM_LOG_AT(DLT_LOG_VERBOSE, __VA_ARGS__)
+
 #endif /* DLTWRAPPER_H_ */
@@ -0,0 +1,132 @@
+/**
+ * SPDX license identifier: MPL-2.0
+ *
+ * Copyright (C) 2012, BMW AG
+ *
+ * This file is part of GENIVI Project AudioManager.
+ *
+ * Contributions are licensed to the GENIVI Alliance under one or more
+ * Contribution License Agreements.
+ *
+ * \copyright
+ * This Source Code Form is subject to the terms of the
+ * Mozilla Public License, v. 2.0. If a  copy of the MPL was not distributed with
+ * this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ *
+ * \file CAmFixedBlockPool.h
+ * For further information see http://www.genivi.org/.
+ *
+ */
+
+#ifndef FIXEDBLOCKPOOL_H_
+#define FIXEDBLOCKPOOL_H_
+
+#include <atomic>
+#include <memory>
+#include <cstddef>
+#include <stdint.h>
+
+namespace am
+{
+
+/**
+ * A pool of equally sized memory blocks which are allocated once.
+ * The free blocks are kept in a lock free stack of block indices. The head carries a tag that is increased with
+ * every change, so a thread that was preempted in the middle of a pop cannot take a block that was reused meanwhile.
+ * allocate and release can be called from any thread.
+ */
+class CAmFixedBlockPool
+{
+public:
+    static const size_t BLOCK_ALIGNMENT = 16; //!< every block is aligned to this
+
+    /**
+     * @param blockSize the size of a block, rounded up to the alignment
+     * @param numBlocks the number of blocks
+     */
+    CAmFixedBlockPool(const size_t blockSize, const uint32_t numBlocks)
+        : mBlockSize((blockSize + BLOCK_ALIGNMENT - 1) & ~(BLOCK_ALIGNMENT - 1))
+        , mNumBlocks(numBlocks)
+        , mMemory(new char[mBlockSize * numBlocks + BLOCK_ALIGNMENT])
+        , mBlocks(mMemory.get() + (BLOCK_ALIGNMENT - reinterpret_cast<uintptr_t>(mMemory.get()) % BLOCK_ALIGNMENT) % BLOCK_ALIGNMENT)
+        , mNext(new std::atomic<uint32_t>[numBlocks ? numBlocks : 1])
+        , mHead(0)
+    {
+        for (uint32_t i = 0; i < numBlocks; ++i)
+        {
+            mNext[i].store(i + 1 < numBlocks ? i + 2 : 0, std::memory_order_relaxed);
+        }
+
+        mHead.store(numBlocks ? 1 : 0, std::memory_order_release);
+    }
+
+    /**
+     * takes a block
+     * @param size the needed size
+     * @param alignment the needed alignment
+     * @return the block or NULL if the size does not fit into a block or the pool is empty
+     */
+    void *allocate(const size_t size, const size_t alignment)
+    {
+        if ((size > mBlockSize) || (alignment > BLOCK_ALIGNMENT))
+        {
+            return (NULL);
+        }
+
+        uint64_t head = mHead.load(std::memory_order_acquire);
+        for (;;)
+        {
+            const uint32_t index = static_cast<uint32_t>(head);
+            if (index == 0)
+            {
+                return (NULL);
+            }
+
+            const uint64_t next = ((head >> 32) + 1) << 32 | mNext[index - 1].load(std::memory_order_relaxed);
+            if (mHead.compare_exchange_weak(head, next, std::memory_order_acq_rel, std::memory_order_acquire))
+            {
+                return (mBlocks + (index - 1) * mBlockSize);
+            }
+        }
+    }
+
+    /**
+     * gives a block back
+     * @param block a block returned by allocate
+     */
+    void release(void *block)
+    {
+        const uint32_t index = static_cast<uint32_t>((static_cast<char *>(block) - mBlocks) / mBlockSize) + 1;
+        uint64_t       head  = mHead.load(std::memory_order_acquire);
+        for (;;)
+        {
+            mNext[index - 1].store(static_cast<uint32_t>(head), std::memory_order_relaxed);
+            const uint64_t next = ((head >> 32) + 1) << 32 | index;
+            if (mHead.compare_exchange_weak(head, next, std::memory_order_acq_rel, std::memory_order_acquire))
+            {
+                return;
+            }
+        }
+    }
+
+    /**
+     * @return true if the memory belongs to the pool
+     */
+    bool owns(const void *memory) const
+    {
+        const char *pointer = static_cast<const char *>(memory);
+        return ((pointer >= mBlocks) && (pointer < mBlocks + mBlockSize * mNumBlocks));
+    }
+
+private:
+    const size_t                             mBlockSize;
+    const uint32_t                           mNumBlocks;
+    std::unique_ptr<char[]>                  mMemory;
+    char                                    *mBlocks; //!< mMemory aligned to BLOCK_ALIGNMENT
+    std::unique_ptr<std::atomic<uint32_t>[]> mNext;   //!< next free block per block, index + 1, 0 is the end
+    std::atomic<uint64_t>                    mHead;   //!< tag in the upper half, index + 1 of the first free block in the lower half
+};
+
+} /* namespace am */
+#endif /* FIXEDBLOCKPOOL_H_ */
@@ -0,0 +1,116 @@
+/**
+ * SPDX license identifier: MPL-2.0
+ *
+ * Copyright (C) 2012, BMW AG
+ *
+ * This file is part of GENIVI Project AudioManager.
+ *
+ * Contributions are licensed to the GENIVI Alliance under one or more
+ * Contribution License Agreements.
+ *
+ * \copyright
+ * This Source Code Form is subject to the terms of the
+ * Mozilla Public License, v. 2.0. If a  copy of the MPL was not distributed with
+ * this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ *
+ * \file CAmIoUring.h
+ * For further information see http://www.genivi.org/.
+ *
+ */
+
+#ifndef CAMIOURING_H_
+#define CAMIOURING_H_
+
+#include <stdint.h>
+#include <time.h>
+#include <sys/poll.h>
+#include <vector>
+
+struct io_uring_sqe;
+struct io_uring_cqe;
+
+namespace am
+{
+
+/**
+ * A minimal io_uring used as the waiting backend of the am::CAmSocketHandler.
+ * It works directly on the kernel interface, no liburing is needed.
+ * wait() has the semantics of ppoll: the polls are armed as one shot polls, re-armed after they fired
+ * and removed when the fd is not in the polling array anymore, so a fd that stays readable is reported again.
+ * Arming, removing and waiting is done with one io_uring_enter per call.
+ */
+class CAmIoUring
+{
+public:
+    CAmIoUring();
+    ~CAmIoUring();
+
+    /**
+     * sets up the ring
+     * @param entries the size of the submission queue
+     * @return false if the kernel does not support io_uring or the needed features
+     */
+    bool init(const unsigned entries);
+
+    /**
+     * waits on the fds like ppoll
+     * @param fds the polling array, the revents are set
+     * @param timeout the timeout, NULL to wait forever
+     * @return the number of fds with revents, 0 on timeout, -1 with errno on error
+     */
+    int wait(std::vector<pollfd> &fds, const timespec *timeout);
+
+    /**
+     * the fd was replaced or its events changed, the poll is removed and armed again on the next wait
+     * @param fd
+     */
+    void rearm(const int fd);
+
+private:
+    struct armed_s //!< the state of the poll per fd
+    {
+        uint32_t generation; //!< increased with every poll added, to ignore completions of older polls on the same fd
+        uint32_t iteration;  //!< the last wait the fd was in the polling array
+        uint32_t index;      //!< index in the polling array of the current wait
+        short    events;     //!< the events the poll was armed with
+        bool     armed;      //!< a poll is in flight
+        armed_s()
+            : generation(0)
+            , iteration(0)
+            , index(0)
+            , events(0)
+            , armed(false)
+        {}
+    };
+
+    io_uring_sqe *getSqe();
+    void queuePoll(const int fd, armed_s &armed, const short events);
+    void queueRemove(const int fd, armed_s &armed);
+    int enter(const unsigned minComplete, const timespec *timeout);
+    int reap(std::vector<pollfd> &fds);
+
+    int                  mRingFd;
+    void                *mSqRing;     //!< mapping of the submission queue ring
+    size_t               mSqRingSize;
+    void                *mCqRing;     //!< mapping of the completion queue ring, same as mSqRing for single mmap kernels
+    size_t               mCqRingSize;
+    io_uring_sqe        *mSqes;       //!< mapping of the submission queue entries
+    size_t               mSqesSize;
+    unsigned            *mSqHead;
+    unsigned            *mSqTail;
+    unsigned            *mSqMask;
+    unsigned            *mSqEntries;
+    unsigned            *mSqArray;
+    unsigned            *mCqHead;
+    unsigned            *mCqTail;
+    unsigned            *mCqMask;
+    io_uring_cqe        *mCqes;
+    unsigned             mSqLocalTail; //!< tail of the queued, not yet submitted entries
+    unsigned             mToSubmit;
+    uint32_t             mIteration;
+    std::vector<armed_s> mArmed;       //!< fd indexed state of the polls
+};
+
+} /* namespace am */
+#endif /* CAMIOURING_H_ */
@@ -0,0 +1,109 @@
+/**
+ * SPDX license identifier: MPL-2.0
+ *
+ * Copyright (C) 2012, BMW AG
+ *
+ * This file is part of GENIVI Project AudioManager.
+ *
+ * Contributions are licensed to the GENIVI Alliance under one or more
+ * Contribution License Agreements.
+ *
+ * \copyright
+ * This Source Code Form is subject to the terms of the
+ * Mozilla Public License, v. 2.0. If a  copy of the MPL was not distributed with
+ * this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ *
+ * \file CAmLogFileSink.h
+ * For further information see http://www.genivi.org/.
+ *
+ */
+
+#ifndef CAMLOGFILESINK_H_
+#define CAMLOGFILESINK_H_
+
+#include <stdint.h>
+#include <time.h>
+#include <string>
+
+namespace am
+{
+
+/**
+ * The file destination of the am::CAmDltWrapper. The lines are copied into a memory mapped segment of the file that
+ * is preallocated, so writing a line does not need a system call and does not wait for the storage.
+ * When a segment is full, the file is rotated: file.1 becomes file.2 and so on, the file becomes file.1 and a new
+ * segment is started. Each line starts with the local time with milliseconds, the text of it is only formatted
+ * again when the millisecond changed.
+ * The sink is not thread safe, the caller has to lock.
+ */
+class CAmLogFileSink
+{
+public:
+    /**
+     * when the written lines are synced to the storage
+     */
+    enum syncPolicy_e
+    {
+        SYNC_NEVER     = 0, //!< the kernel writes the pages back when it wants to
+        SYNC_ON_ROTATE = 1, //!< a segment is synced when it is full and when the sink is closed
+        SYNC_ALWAYS    = 2  //!< every line is synced, the writer waits for the storage
+    };
+
+    CAmLogFileSink();
+    ~CAmLogFileSink();
+
+    /**
+     * creates the file, an existing one is truncated
+     * @param filename the name of the file with absolute path
+     * @param segmentSize the size of the file before it is rotated
+     * @param numFiles the number of files that are kept, including the one that is written
+     * @param syncPolicy
+     * @return false if the file could not be created or mapped
+     */
+    bool open(const std::string &filename, const size_t segmentSize = 1 << 20, const unsigned numFiles = 4, const syncPolicy_e syncPolicy = SYNC_ON_ROTATE);
+
+    /**
+     * changes the parameters of an open sink, the lines that are already written are kept
+     * @return false if the file could not be mapped again
+     */
+    bool configure(const size_t segmentSize, const unsigned numFiles, const syncPolicy_e syncPolicy);
+
+    /**
+     * cuts the file to the written size and closes it
+     */
+    void close();
+    bool isOpen() const;
+
+    /**
+     * writes a line, the time prefix and the newline are added. A line that is longer than a segment is cut.
+     */
+    void write(const char *text, const size_t length);
+    void write(const std::string &text);
+
+    /**
+     * syncs the written lines to the storage, regardless of the policy
+     */
+    void sync();
+
+private:
+    bool openSegment(const bool keep);
+    void closeSegment();
+    void rotate();
+    void updatePrefix();
+
+    std::string  mFilename;
+    size_t       mSegmentSize;
+    unsigned     mNumFiles;
+    syncPolicy_e mSyncPolicy;
+    int          mFd;
+    char        *mpSegment;     //!< the mapping of the segment
+    size_t       mUsed;         //!< the bytes written into the segment
+    uint64_t     mPrefixMs;     //!< the time of the cached prefix in ms since the epoch
+    time_t       mPrefixSecond; //!< the second the date and time of the cached prefix belong to
+    char         mPrefix[32];   //!< "date time.ms "
+    size_t       mPrefixLength;
+};
+
+} /* namespace am */
+#endif /* CAMLOGFILESINK_H_ */
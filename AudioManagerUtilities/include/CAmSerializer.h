@@ -20,11 +20,20 @@
 
 #include <deque>
 #include <cassert>
+#include <condition_variable>
+#include <future>
+#include <map>
 #include <memory>
+#include <mutex>
+#include <new>
 #include <stdexcept>
+#include <thread>
 #include <unistd.h>
+#include <sys/eventfd.h>
 #include "CAmDltWrapper.h"
 #include "CAmSocketHandler.h"
+#include "TAmMpscRing.h"
+#include "CAmFixedBlockPool.h"
 
 /*!
  * \brief Helper structures used within std::bind for automatically identification of all placeholders.
@@ -877,6 +886,29 @@ namespace V2
 {
 class CAmSerializer
 {
+public:
+    /**
+     * what happens to an asynchronous call if the queue is full. Synchronous calls always wait.
+     * The mainloop can not wait for itself, there a call to a full queue is dropped and a synchronous call is made directly.
+     */
+    typedef enum : uint8_t
+    {
+        OVERFLOW_BLOCK    = 0u, //!< the caller sleeps until the mainloop made room
+        OVERFLOW_DROP     = 1u, //!< the call is dropped, a future of the call gets a broken promise
+        OVERFLOW_COALESCE = 2u  //!< calls with a coalescing key are parked, the latest call per key wins. Others wait.
+    } overflow_policy_e;
+
+    struct statistic_s //!< counters of the serializer
+    {
+        uint64_t enqueued;                        //!< calls put into the queue
+        uint64_t dispatched;                      //!< calls made by the mainloop
+        uint64_t dropped;                         //!< calls dropped because the queue was full
+        uint64_t coalesced;                       //!< parked calls replaced by a newer one with the same key
+        uint64_t highWaterMark;                   //!< the max number of queued calls
+        CAmSocketHandler::sh_statistic_s latency; //!< time between enqueueing and dispatching in nanoseconds
+    };
+
+private:
     /**
      * Prototype for a delegate
      */
@@ -889,11 +921,59 @@ class CAmSerializer
             SyncCallType = false, AsyncCallType = true
         } CallType;
 
+        uint64_t mEnqueueTime; //!< monotonic time in nanoseconds when the delegate was queued
+
+        CAmDelegate()
+            : mEnqueueTime(0)
+        {
+        }
+
         virtual ~CAmDelegate()
         {
         }
 
-        virtual CallType call(int *pipe) = 0;
+        virtual CallType call() = 0;
+
+    };
+
+    /**
+     * Base of the synchronous delegates. They live on the stack of the calling thread, which waits on the own
+     * completion slot, so any number of threads can wait at the same time.
+     */
+    class CAmDelegateSync : public CAmDelegate
+    {
+        std::mutex              mMutex;
+        std::condition_variable mCondition;
+        bool                    mDone;
+    public:
+        CAmDelegateSync()
+            : mMutex()
+            , mCondition()
+            , mDone(false)
+        {
+        }
+
+        /**
+         * called by the mainloop after the invocation.
+         * The notification is done under the lock, the waiter can only destroy the delegate after it was released.
+         */
+        void complete()
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mDone = true;
+            mCondition.notify_one();
+        }
+
+        /**
+         * blocks the calling thread until complete was called
+         */
+        void wait()
+        {
+            std::unique_lock<std::mutex> lock(mMutex);
+            mCondition.wait(lock, [this]() {
+                return (mDone);
+            });
+        }
 
     };
 
@@ -911,17 +991,62 @@ class CAmSerializer
         {
         }
 
-        CallType call(int *pipe)
+        CallType call()
         {
-            (void)pipe;
             mInvocation();
             return (AsyncCallType);
         }
 
     };
 
+    /**
+     * Prototype for a delegate that hands the result over to a future.
+     */
     template<class TInvocation, class TRet>
-    class CAmDelegateSyncImpl : public CAmDelegate
+    class CAmDelegateFutureImpl : public CAmDelegate
+    {
+        TInvocation        mInvocation;
+        std::promise<TRet> mPromise;
+    public:
+        friend class CAmSerializer;
+        CAmDelegateFutureImpl(TInvocation &&invocation)
+            : mInvocation(std::move(invocation))
+            , mPromise()
+        {
+        }
+
+        CallType call()
+        {
+            mPromise.set_value(mInvocation());
+            return (AsyncCallType);
+        }
+
+    };
+
+    template<class TInvocation>
+    class CAmDelegateFutureImpl<TInvocation, void> : public CAmDelegate
+    {
+        TInvocation        mInvocation;
+        std::promise<void> mPromise;
+    public:
+        friend class CAmSerializer;
+        CAmDelegateFutureImpl(TInvocation &&invocation)
+            : mInvocation(std::move(invocation))
+            , mPromise()
+        {
+        }
+
+        CallType call()
+        {
+            mInvocation();
+            mPromise.set_value();
+            return (AsyncCallType);
+        }
+
+    };
+
+    template<class TInvocation, class TRet>
+    class CAmDelegateSyncImpl : public CAmDelegateSync
     {
         TInvocation mInvocation;
         TRet       &mReturn;
@@ -933,23 +1058,17 @@ class CAmSerializer
         {
         }
 
-        CallType call(int *pipe)
+        CallType call()
         {
             mReturn = mInvocation();
-            ssize_t result(-1);
-            result = write(pipe[1], this, sizeof(this));
-            if (result == -1)
-            {
-                logError("CAmSerializer: Problem writing into pipe! Error No:", errno);
-            }
-
+            complete();
             return (SyncCallType);
         }
 
     };
 
     template<class TInvocation>
-    class CAmDelegateSyncVoidImpl : public CAmDelegate
+    class CAmDelegateSyncVoidImpl : public CAmDelegateSync
     {
         TInvocation mInvocation;
     public:
@@ -959,16 +1078,10 @@ class CAmSerializer
         {
         }
 
-        CallType call(int *pipe)
+        CallType call()
         {
             mInvocation();
-            ssize_t result(-1);
-            result = write(pipe[1], this, sizeof(this));
-            if (result == -1)
-            {
-                logError("CAmSerializer: Problem writing into pipe! Error No:", errno);
-            }
-
+            complete();
             return (SyncCallType);
         }
 
@@ -976,44 +1089,307 @@ class CAmSerializer
 
     typedef CAmDelegate *CAmDelegagePtr;         //!< pointer to a delegate
 
-    void sendSync(CAmDelegagePtr pDelegate)
+    void sendSync(CAmDelegateSync &delegate)
     {
-        send(pDelegate);
-        int             numReads;
-        CAmDelegagePtr *p = NULL;
-        if ((numReads = read(mReturnPipe[0], &p, sizeof(p))) == -1)
+        if (isMainloopThread())
         {
-            logError("CAmSerializer::doSyncCall could not read pipe!");
-            throw std::runtime_error("CAmSerializer Could not read pipe!");
+            // waiting here would wait for the own dispatch
+            delegate.call();
+            return;
         }
+
+        send(&delegate);
+        delegate.wait();
+    }
+
+    bool isMainloopThread() const
+    {
+        return (std::this_thread::get_id() == mMainloopThread.load(std::memory_order_relaxed));
     }
 
     /**
-     * rings the line of the pipe and adds the delegate pointer to the queue
+     * creates an async delegate, big bindings or an exhausted pool fall back to the heap
+     */
+    template<class TDelegate, class TFunc>
+    TDelegate *createAsync(TFunc &&invocation)
+    {
+        void *pMemory = mPool.allocate(sizeof(TDelegate), alignof(TDelegate));
+        return (pMemory ? new (pMemory) TDelegate(std::forward<TFunc>(invocation))
+                        : new TDelegate(std::forward<TFunc>(invocation)));
+    }
+
+    static uint64_t now()
+    {
+        timespec time;
+        clock_gettime(CLOCK_MONOTONIC, &time);
+        return (static_cast<uint64_t>(time.tv_sec) * 1000000000ull + time.tv_nsec);
+    }
+
+    /**
+     * adds the delegate pointer to the ring
      * @param p delegate pointer
+     * @param block if true, a full ring puts the caller to sleep until the mainloop made room, like a full pipe would do.
+     *              The mainloop itself can not wait, there the call fails.
+     * @return false if the ring was full and the caller could not wait
      */
-    inline void send(CAmDelegagePtr p)
+    inline bool send(CAmDelegagePtr p, const bool block = true)
     {
-        if (write(mPipe[1], &p, sizeof(p)) == -1)
+        p->mEnqueueTime = now();
+        if (!mRing.push(p))
         {
-            throw std::runtime_error("could not write to pipe !");
+            if (!block)
+            {
+                return (false);
+            }
+
+            if (isMainloopThread())
+            {
+                AM_LOG_ERROR("CAmSerializer::send the queue is full, a call from the mainloop is dropped");
+                return (false);
+            }
+
+            waitForRoom(p);
         }
+
+        queued();
+        return (true);
     }
 
-    int                        mPipe[2];       //!< the pipe
-    int                        mReturnPipe[2]; //!< pipe handling returns
-    sh_pollHandle_t            mHandle;
-    CAmSocketHandler          *mpSocketHandler;
-    std::deque<CAmDelegagePtr> mListDelegatePointers;         //!< intermediate queue to store the pipe results
+    /**
+     * sleeps until the delegate pointer could be pushed. The fence pairs with the one in the dispatcher, either the
+     * dispatcher sees the waiter or the waiter sees the room which was made.
+     * @param p delegate pointer
+     */
+    void waitForRoom(CAmDelegagePtr p)
+    {
+        std::unique_lock<std::mutex> lock(mRoomMutex);
+        mNumWaiting.fetch_add(1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        while (!mRing.push(p))
+        {
+            mRoomCondition.wait(lock);
+        }
+
+        mNumWaiting.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    /**
+     * accounts a new queued delegate and rings the doorbell if the queue was empty before
+     */
+    inline void queued()
+    {
+        mEnqueued.fetch_add(1, std::memory_order_relaxed);
+        const ssize_t numQueued     = mNumQueued.fetch_add(1, std::memory_order_acq_rel) + 1;
+        uint64_t      highWaterMark = mHighWaterMark.load(std::memory_order_relaxed);
+        while ((numQueued > static_cast<ssize_t>(highWaterMark))
+               && !mHighWaterMark.compare_exchange_weak(highWaterMark, numQueued, std::memory_order_relaxed))
+        {
+        }
+
+        if (numQueued == 1)
+        {
+            uint64_t doorbell = 1;
+            if (write(mEventFd, &doorbell, sizeof(doorbell)) == -1)
+            {
+                throw std::runtime_error("could not write to eventfd !");
+            }
+        }
+    }
+
+    /**
+     * queues an async delegate according to the overflow policy
+     * @param p delegate pointer
+     */
+    inline void sendAsync(CAmDelegagePtr p)
+    {
+        if (!send(p, mOverflowPolicy.load(std::memory_order_relaxed) != OVERFLOW_DROP))
+        {
+            destroy(p);
+            mDropped.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * queues an async delegate with a coalescing key. While calls are parked or the parked calls are called, new calls
+     * with a key are parked as well, so a parked call is never overtaken by a newer call with the same key.
+     * The decision is made under the lock. The first parked call records the ring position, the parked calls are only
+     * called after all ring entries before it, which holds the older calls of the same keys.
+     * @param key the coalescing key
+     * @param p delegate pointer
+     */
+    inline void sendCoalesced(const uint64_t key, CAmDelegagePtr p)
+    {
+        if (mOverflowPolicy.load(std::memory_order_relaxed) != OVERFLOW_COALESCE)
+        {
+            sendAsync(p);
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(mParkedMutex);
+        if (mParked.empty() && !mDispatchingParked && send(p, false))
+        {
+            return;
+        }
+
+        if (mParked.empty())
+        {
+            mParkedBarrier = mRing.enqueued();
+        }
+
+        p->mEnqueueTime = now();
+        std::map<uint64_t, CAmDelegagePtr>::iterator it = mParked.find(key);
+        if (it != mParked.end())
+        {
+            destroy(it->second);
+            it->second = p;
+            mCoalesced.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        mParked[key] = p;
+        queued();
+    }
+
+    /**
+     * calls a delegate from the mainloop
+     * @param p delegate pointer
+     */
+    inline void dispatch(CAmDelegagePtr p)
+    {
+        mLatency.add(now() - p->mEnqueueTime);
+        if (p->call())
+        {
+            destroy(p);
+        }
+    }
+
+    /**
+     * calls the parked delegates once all ring entries before the first of them were called, from the mainloop
+     * @return the number of called delegates
+     */
+    ssize_t dispatchParked()
+    {
+        std::map<uint64_t, CAmDelegagePtr> parked;
+        {
+            std::lock_guard<std::mutex> lock(mParkedMutex);
+            if (mParked.empty() || (static_cast<ssize_t>(mRing.dequeued() - mParkedBarrier) < 0))
+            {
+                return (0);
+            }
+
+            parked.swap(mParked);
+            mDispatchingParked = true;
+        }
+
+        for (std::map<uint64_t, CAmDelegagePtr>::iterator it = parked.begin(); it != parked.end(); ++it)
+        {
+            dispatch(it->second);
+        }
+
+        std::lock_guard<std::mutex> lock(mParkedMutex);
+        mDispatchingParked = false;
+        return (static_cast<ssize_t>(parked.size()));
+    }
+
+    /**
+     * destroys an async delegate after it was called and gives its memory back to where it came from
+     * @param p delegate pointer
+     */
+    inline void destroy(CAmDelegagePtr p)
+    {
+        if (mPool.owns(p))
+        {
+            p->~CAmDelegate();
+            mPool.release(p);
+        }
+        else
+        {
+            delete p;
+        }
+    }
+
+    static const size_t POOL_BLOCK_SIZE = 128; //!< async delegates up to this size are taken from the pool
+
+    int                                mEventFd;        //!< the doorbell, only signalled when the ring gets non-empty
+    sh_pollHandle_t                    mHandle;
+    CAmSocketHandler                  *mpSocketHandler;
+    TAmMpscRing<CAmDelegagePtr>        mRing;           //!< the queued delegates
+    std::atomic<ssize_t>               mNumQueued;      //!< delegates pushed and not yet called, can get negative for a moment
+    CAmFixedBlockPool                  mPool;           //!< storage for the async delegates, so no heap is needed for small ones
+    std::atomic<overflow_policy_e>     mOverflowPolicy;
+    std::mutex                         mParkedMutex;
+    std::map<uint64_t, CAmDelegagePtr> mParked;         //!< coalesced calls which did not fit into the ring, by key
+    size_t                             mParkedBarrier;  //!< the ring position when the first call was parked
+    bool                               mDispatchingParked; //!< the dispatcher calls parked calls, new calls with a key are parked
+    std::atomic<uint64_t>              mEnqueued;
+    std::atomic<uint64_t>              mDispatched;
+    std::atomic<uint64_t>              mDropped;
+    std::atomic<uint64_t>              mCoalesced;
+    std::atomic<uint64_t>              mHighWaterMark;
+    CAmSocketHandler::sh_statistic_s   mLatency;        //!< only touched in the mainloop
+    std::mutex                         mRoomMutex;
+    std::condition_variable            mRoomCondition;  //!< signalled by the dispatcher when it made room for waiters
+    std::atomic<uint32_t>              mNumWaiting;     //!< callers waiting for room in the ring
+    std::atomic<std::thread::id>       mMainloopThread; //!< the thread which dispatches, it must never wait for room
 
 public:
 
     /**
-     * get the size of delegate pointers
+     * get the number of queued delegates
      */
     size_t getListDelegatePointers()
     {
-        return mListDelegatePointers.size();
+        const ssize_t numQueued = mNumQueued.load(std::memory_order_acquire);
+        return ((numQueued > 0) ? static_cast<size_t>(numQueued) : 0);
+    }
+
+    /**
+     * @return the number of calls which fit into the queue
+     */
+    size_t getCapacity() const
+    {
+        return (mRing.capacity());
+    }
+
+    /**
+     * sets what happens with asynchronous calls when the queue is full, can be called from any thread
+     * @param policy
+     */
+    void setOverflowPolicy(const overflow_policy_e policy)
+    {
+        mOverflowPolicy.store(policy, std::memory_order_relaxed);
+    }
+
+    overflow_policy_e getOverflowPolicy() const
+    {
+        return (mOverflowPolicy.load(std::memory_order_relaxed));
+    }
+
+    /**
+     * get the counters, the latency histogram must only be read in the mainloop context
+     * @param statistics
+     */
+    void getStatistics(statistic_s &statistics) const
+    {
+        statistics.enqueued      = mEnqueued.load(std::memory_order_relaxed);
+        statistics.dispatched    = mDispatched.load(std::memory_order_relaxed);
+        statistics.dropped       = mDropped.load(std::memory_order_relaxed);
+        statistics.coalesced     = mCoalesced.load(std::memory_order_relaxed);
+        statistics.highWaterMark = mHighWaterMark.load(std::memory_order_relaxed);
+        statistics.latency       = mLatency;
+    }
+
+    /**
+     * resets the counters, must only be called in the mainloop context
+     */
+    void resetStatistics()
+    {
+        mEnqueued.store(0, std::memory_order_relaxed);
+        mDispatched.store(0, std::memory_order_relaxed);
+        mDropped.store(0, std::memory_order_relaxed);
+        mCoalesced.store(0, std::memory_order_relaxed);
+        mHighWaterMark.store(0, std::memory_order_relaxed);
+        mLatency = CAmSocketHandler::sh_statistic_s();
     }
 
     /**
@@ -1030,11 +1406,35 @@ public:
     {
         static_assert(std::is_bind_expression<TFunc>::value, "The type is not produced by std::bind");
         typedef CAmDelegateAsyncImpl<TFunc> AsyncDelegate;
-        AsyncDelegate *pImp = new AsyncDelegate(std::forward<TFunc>(invocation));
-        send(pImp);
+        sendAsync(createAsync<AsyncDelegate>(std::forward<TFunc>(invocation)));
         // Do not delete the pointer. It will be deleted automatically later.
     }
 
+    /**
+     * calls a function with variadic arguments threadsafe. With the policy OVERFLOW_COALESCE, only the latest
+     * call per key is kept while the queue is full, which fits notifications that carry a complete state.
+     * @param key the coalescing key, calls with the same key replace each other
+     * @param invocation is a type is produced by std::bind
+     * \section ex Example:
+     * @code
+     * CAmSerializer serial(&Sockethandler);
+     * serial.asyncCoalescedInvocation(sinkID, std::bind(&AClass::volumeChanged, &anInstance, sinkID, volume));
+     * @endcode
+     */
+    template<class TFunc>
+    void asyncCoalescedInvocation(const uint64_t key, TFunc invocation)
+    {
+        static_assert(std::is_bind_expression<TFunc>::value, "The type is not produced by std::bind");
+        typedef CAmDelegateAsyncImpl<TFunc> AsyncDelegate;
+        sendCoalesced(key, createAsync<AsyncDelegate>(std::forward<TFunc>(invocation)));
+    }
+
+    template<class TClass, class TMeth, class... TArgs>
+    void asyncCoalescedCall(const uint64_t key, TClass *instance, TMeth method, TArgs && ... arguments)
+    {
+        asyncCoalescedInvocation(key, std::bind(method, instance, std::forward<TArgs>(arguments) ...));
+    }
+
     /**
      * calls a function with variadic arguments threadsafe
      * @param instance the instance of the class that shall be called
@@ -1068,6 +1468,52 @@ public:
         asyncInvocation(invocation);
     }
 
+    /**
+     * calls a function with variadic arguments threadsafe without waiting for the result
+     * @param invocation is a type is produced by std::bind
+     * @return a future which gets the result when the mainloop made the call
+     * \section ex Example:
+     * @code
+     * CAmSerializer serial(&Sockethandler);
+     * std::future<int> result = serial.asyncInvocationWithResult(std::bind([]()->int{return 1;}));
+     * @endcode
+     */
+    template<class TFunc>
+    std::future<typename std::result_of<TFunc()>::type> asyncInvocationWithResult(TFunc invocation)
+    {
+        static_assert(std::is_bind_expression<TFunc>::value, "The type is not produced by std::bind");
+        typedef typename std::result_of<TFunc()>::type      TRet;
+        typedef CAmDelegateFutureImpl<TFunc, TRet>          FutureDelegate;
+        FutureDelegate     *pImp   = createAsync<FutureDelegate>(std::forward<TFunc>(invocation));
+        std::future<TRet>   future = pImp->mPromise.get_future();
+        sendAsync(pImp);
+        return (future);
+    }
+
+    /**
+     * calls a function with variadic arguments threadsafe without waiting for the result
+     * @param instance the instance of the class that shall be called
+     * @param function the function that shall be called as member function pointer.
+     * @return a future which gets the result when the mainloop made the call
+     * \section ex Example:
+     * @code
+     * class AClass
+     * {
+     * public:
+     *      int instanceMethod(int x);
+     * }
+     * CAmSerializer serial(&Sockethandler);
+     * AClass anInstance;
+     * std::future<int> result = serial.asyncCallWithResult(&anInstance, &AClass::instanceMethod, 100);
+     * @endcode
+     */
+    template<class TClass, class TMeth, class... TArgs>
+    auto asyncCallWithResult(TClass *instance, TMeth method, TArgs && ... arguments)
+        -> decltype(asyncInvocationWithResult(std::bind(method, instance, std::forward<TArgs>(arguments) ...)))
+    {
+        return (asyncInvocationWithResult(std::bind(method, instance, std::forward<TArgs>(arguments) ...)));
+    }
+
     /**
      * calls a function with variadic arguments threadsafe
      * @param invocation is a type is produced by std::bind
@@ -1086,10 +1532,8 @@ public:
 
         typedef CAmDelegateSyncImpl<TFunc, TRet> SyncDelegate;
 
-        SyncDelegate *pImp = new SyncDelegate(std::forward<TFunc>(invocation), std::forward<TRet>(result));
-        sendSync(pImp);
-        // Delete the pointer.
-        delete pImp;
+        SyncDelegate delegate(std::forward<TFunc>(invocation), std::forward<TRet>(result));
+        sendSync(delegate);
     }
 
     /**
@@ -1108,10 +1552,8 @@ public:
 
         typedef CAmDelegateSyncVoidImpl<TFunc> SyncDelegate;
 
-        SyncDelegate *pImp = new SyncDelegate(std::forward<TFunc>(invocation));
-        sendSync(pImp);
-        // Delete the pointer.
-        delete pImp;
+        SyncDelegate delegate(std::forward<TFunc>(invocation));
+        sendSync(delegate);
     }
 
     /**
@@ -1156,15 +1598,12 @@ public:
     {
         (void)handle;
         (void)userData;
-        int            numReads;
-        CAmDelegagePtr listPointers[3];
-        if ((numReads = read(pollfd.fd, &listPointers, sizeof(listPointers))) == -1)
+        uint64_t doorbell;
+        if ((read(pollfd.fd, &doorbell, sizeof(doorbell)) == -1) && (errno != EAGAIN))
         {
-            logError("CAmSerializer::receiverCallback could not read pipe!");
-            throw std::runtime_error("CAmSerializer Could not read pipe!");
+            logError("CAmSerializer::receiverCallback could not read eventfd!");
+            throw std::runtime_error("CAmSerializer Could not read eventfd!");
         }
-
-        mListDelegatePointers.assign(listPointers, listPointers + (numReads / sizeof(CAmDelegagePtr)));
     }
 
     /**
@@ -1174,34 +1613,40 @@ public:
     {
         (void)handle;
         (void)userData;
-        if (mListDelegatePointers.empty())
-        {
-            return (false);
-        }
-
-        return (true);
+        return (mNumQueued.load(std::memory_order_acquire) > 0);
     }
 
     /**
-     * dispatcher callback for sockethandling, for more, see CAmSocketHandler
+     * dispatcher callback for sockethandling, for more, see CAmSocketHandler.
+     * Calls all delegates which were queued when the pass started.
      */
     bool dispatcherCallback(const sh_pollHandle_t handle, void *userData)
     {
         (void)handle;
         (void)userData;
-        CAmDelegagePtr delegatePoiter = mListDelegatePointers.front();
-        mListDelegatePointers.pop_front();
-        if (delegatePoiter->call(mReturnPipe))
+        mMainloopThread.store(std::this_thread::get_id(), std::memory_order_relaxed);
+        const ssize_t  numQueued = mNumQueued.load(std::memory_order_acquire);
+        ssize_t        numCalled = 0;
+        CAmDelegagePtr delegatePoiter;
+        while ((numCalled < numQueued) && mRing.pop(delegatePoiter))
         {
-            delete delegatePoiter;
+            ++numCalled;
+            dispatch(delegatePoiter);
         }
 
-        if (mListDelegatePointers.empty())
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if ((numCalled != 0) && (mNumWaiting.load(std::memory_order_relaxed) != 0))
         {
-            return (false);
+            std::lock_guard<std::mutex> lock(mRoomMutex);
+            mRoomCondition.notify_all();
         }
 
-        return (true);
+        // the parked calls come after the older ring entries of their keys, until these are called they wait for the next pass
+        numCalled += dispatchParked();
+        mDispatched.fetch_add(numCalled, std::memory_order_relaxed);
+
+        // anything pushed meanwhile did not ring the doorbell, so it has to be dispatched now
+        return ((mNumQueued.fetch_sub(numCalled, std::memory_order_acq_rel) - numCalled) > 0);
     }
 
     TAmShPollFired<CAmSerializer>    receiverCallbackT;
@@ -1211,43 +1656,67 @@ public:
     /**
      * The constructor must be called in the mainthread context !
      * @param iSocketHandler pointer to the CAmSocketHandler
+     * @param capacity the max number of queued calls, see setOverflowPolicy for what happens when the queue is full
+     * @param poolSize the number of async calls which can be queued without using the heap
      */
-    CAmSerializer(CAmSocketHandler *iSocketHandler)
-        : mPipe()
-        , mReturnPipe()
+    CAmSerializer(CAmSocketHandler *iSocketHandler, const size_t capacity = 8192, const uint32_t poolSize = 256)
+        : mEventFd(-1)
         , mHandle()
         , mpSocketHandler(iSocketHandler)
-        , mListDelegatePointers()
+        , mRing(capacity)
+        , mNumQueued(0)
+        , mPool(POOL_BLOCK_SIZE, poolSize)
+        , mOverflowPolicy(OVERFLOW_BLOCK)
+        , mParkedMutex()
+        , mParked()
+        , mParkedBarrier(0)
+        , mDispatchingParked(false)
+        , mEnqueued(0)
+        , mDispatched(0)
+        , mDropped(0)
+        , mCoalesced(0)
+        , mHighWaterMark(0)
+        , mLatency()
+        , mRoomMutex()
+        , mRoomCondition()
+        , mNumWaiting(0)
+        , mMainloopThread(std::this_thread::get_id())
         , receiverCallbackT(this, &CAmSerializer::receiverCallback)
         , dispatcherCallbackT(this, &CAmSerializer::dispatcherCallback)
         , checkerCallbackT(this, &CAmSerializer::checkerCallback)
     {
         assert(NULL != iSocketHandler);
 
-        if (pipe(mPipe) == -1)
-        {
-            logError("CAmSerializer could not create pipe!");
-            throw std::runtime_error("CAmSerializer Could not open pipe!");
-        }
-
-        if (pipe(mReturnPipe) == -1)
+        mEventFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (mEventFd == -1)
         {
-            logError("CAmSerializer could not create mReturnPipe!");
-            throw std::runtime_error("CAmSerializer Could not open mReturnPipe!");
+            logError("CAmSerializer could not create eventfd!");
+            throw std::runtime_error("CAmSerializer Could not open eventfd!");
         }
 
         short event = 0;
         event |= POLLIN;
-        mpSocketHandler->addFDPoll(mPipe[0], event, NULL, &receiverCallbackT, &checkerCallbackT, &dispatcherCallbackT, NULL, mHandle);
+        mpSocketHandler->addFDPoll(mEventFd, event, NULL, &receiverCallbackT, &checkerCallbackT, &dispatcherCallbackT, NULL, mHandle);
     }
 
     ~CAmSerializer()
     {
         mpSocketHandler->removeFDPoll(mHandle);
-        close(mPipe[0]);
-        close(mPipe[1]);
-        close(mReturnPipe[0]);
-        close(mReturnPipe[1]);
+        close(mEventFd);
+        // the calls which were never dispatched give their memory back, the synchronous ones belong to their callers
+        CAmDelegagePtr delegatePoiter;
+        while (mRing.pop(delegatePoiter))
+        {
+            if (dynamic_cast<CAmDelegateSync *>(delegatePoiter) == NULL)
+            {
+                destroy(delegatePoiter);
+            }
+        }
+
+        for (std::map<uint64_t, CAmDelegagePtr>::iterator it = mParked.begin(); it != mParked.end(); ++it)
+        {
+            destroy(it->second);
+        }
     }
 
 };
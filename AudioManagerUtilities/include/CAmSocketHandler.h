@@ -23,10 +23,13 @@
 #include <sys/poll.h>
 #include <list>
 #include <map>
+#include <deque>
+#include <atomic>
 #include <set>
 #include <signal.h>
 #include <vector>
 #include <functional>
+#include <memory>
 #include <sys/signalfd.h>
 #include <audiomanagerconfig.h>
 #include "audiomanagertypes.h"
@@ -48,6 +51,8 @@ namespace am
 #define MAX_TIMERHANDLE UINT16_MAX
 #define MAX_POLLHANDLE  UINT16_MAX
 
+class CAmIoUring;
+
 typedef uint16_t        sh_pollHandle_t;  //!< this is a handle for a filedescriptor to be used with the SocketHandler
 typedef sh_pollHandle_t sh_timerHandle_t; //!< this is a handle for a timer to be used with the SocketHandler
 
@@ -231,13 +236,74 @@ public:
  */
 class CAmSocketHandler
 {
+public:
+    /**
+     * the ways to wait for the filedescriptors
+     */
+    typedef enum : uint8_t
+    {
+        BACKEND_PPOLL    = 0u, //!< ppoll, always available
+        BACKEND_IO_URING = 1u  //!< io_uring, only if built with WITH_IO_URING and supported by the kernel
+    } sh_backend_e;
+
+    /**
+     * the priority classes of the polls. Fired polls are serviced in the order of their priority,
+     * high priority polls are not limited by the dispatch budget.
+     */
+    typedef enum : uint8_t
+    {
+        PRIORITY_HIGH   = 0u,
+        PRIORITY_NORMAL = 1u,
+        PRIORITY_LOW    = 2u,
+        PRIORITY_MAX    = 3u
+    } sh_priority_e;
+
+    /**
+     * the callback stages of a poll which are measured by the statistics
+     */
+    typedef enum : uint8_t
+    {
+        STAT_PREPARE  = 0u,
+        STAT_FIRE     = 1u,
+        STAT_CHECK    = 2u,
+        STAT_DISPATCH = 3u,
+        STAT_MAX      = 4u
+    } sh_statistic_stage_e;
+
+    struct sh_statistic_s //!< execution time statistic, all values in nanoseconds
+    {
+        uint64_t count;
+        uint64_t sum;
+        uint64_t min;
+        uint64_t max;
+        uint32_t histogram[64]; //!< number of values per power of two, used for the percentiles
+        sh_statistic_s();
+        void add(const uint64_t value);
+        uint64_t average() const;
+        uint64_t percentile(const uint8_t percent) const;
+    };
+
+    struct sh_poll_statistic_s //!< statistics of all callback stages of a poll
+    {
+        sh_statistic_s stage[STAT_MAX];
+    };
+
+    struct sh_loop_statistic_s //!< statistics of the mainloop itself
+    {
+        sh_statistic_s iteration;  //!< time from the return of ppoll until it is called again
+        sh_statistic_s wait;       //!< time spent waiting in ppoll
+        sh_statistic_s timerDrift; //!< time between the expiry of a timer and the call of its callback
+    };
+
+private:
     typedef enum : uint8_t
     {
         ADD     = 0u, // new, uninitialized element which needs to be added to ppoll array
         UPDATE  = 1u, // update of event information therefore update ppoll array
         VALID   = 2u, // it is a valid element in ppoll array
         REMOVE  = 3u, // remove from ppoll array and internal map
-        INVALID = 4u  // uninit element requested to be removed from internal map only
+        INVALID = 4u, // uninit element requested to be removed from internal map only
+        FREE    = 5u  // unused slot which can be taken by a new element
     } poll_states_e;
 
     struct sh_poll_s //!< struct that holds information about polls
@@ -250,6 +316,8 @@ class CAmSocketHandler
         std::function<bool(const sh_pollHandle_t handle, void *userData)> dispatchCB;                   // dispatch callback
         void *userData;
         poll_states_e state;
+        sh_priority_e priority;                                                                         //!< the priority class of the poll
+        bool dispatchPending;                                                                           //!< dispatching was deferred to the next loop iteration
 
         sh_poll_s()
             : handle(0)
@@ -259,7 +327,9 @@ class CAmSocketHandler
             , checkCB()
             , dispatchCB()
             , userData(0)
-            , state(ADD)
+            , state(FREE)
+            , priority(PRIORITY_NORMAL)
+            , dispatchPending(false)
         {}
     };
 
@@ -274,6 +344,7 @@ class CAmSocketHandler
 #endif
         std::function<void(const sh_timerHandle_t handle, void *userData)> callback; // timer callback
         void *userData;
+        uint64_t expiry; //!< monotonic time in ns the timer is expected to expire, used for the statistics
         sh_timer_s()
             : handle(0)
 #ifdef WITH_TIMERFD
@@ -282,6 +353,7 @@ class CAmSocketHandler
             , countdown()
             , callback()
             , userData(0)
+            , expiry(0)
         {}
     };
 
@@ -297,6 +369,16 @@ class CAmSocketHandler
         {}
     };
 
+    struct sh_post_s //!< struct that holds a task posted from any thread
+    {
+        sh_post_s *next;
+        std::function<void()> task;
+        sh_post_s(std::function<void()> &&postedTask)
+            : next(NULL)
+            , task(std::move(postedTask))
+        {}
+    };
+
     struct sh_identifier_s
     {
         std::set<sh_pollHandle_t> pollHandles;
@@ -311,7 +393,8 @@ class CAmSocketHandler
 
     typedef std::reverse_iterator<sh_timer_s> rListTimerIter;         //!< typedef for reverseiterator on timer lists
     typedef std::vector<pollfd>               VectorPollfd_t;         //!< vector of filedescriptors
-    typedef std::map<int, sh_poll_s>          MapShPoll_t;            //!< list for the callbacks
+    typedef std::deque<sh_poll_s>             VectorShPoll_t;         //!< fd indexed slots for the callbacks, growing keeps the references valid
+    typedef std::vector<sh_poll_s *>          VectorShPollPtr_t;      //!< list of fired polls
     typedef std::vector<sh_signal_s>          VectorSignalHandlers_t; //!< list for the callbacks
 
     typedef enum : uint8_t
@@ -325,7 +408,10 @@ class CAmSocketHandler
     int                    mEventFd;
     int                    mSignalFd;
     bool                   mDispatchDone; // this starts / stops the mainloop
-    MapShPoll_t            mMapShPoll;    //!< list that holds all information for the ppoll
+    VectorShPoll_t         mShPollSlots;  //!< fd indexed slots that hold all information for the ppoll
+    VectorShPollPtr_t      mFiredPolls;   //!< polls which fired or still need to dispatch, reused to avoid allocations
+    uint64_t               mDispatchTimeBudget; //!< max time in ns spent dispatching per loop iteration, 0 for unlimited
+    uint32_t               mDispatchCallBudget; //!< max dispatch calls per loop iteration, 0 for unlimited
 
     sh_identifier_s        mSetPollKeys;  //! A set of all used ppoll keys
     sh_identifier_s        mSetTimerKeys; //! A set of all used timer keys
@@ -336,16 +422,31 @@ class CAmSocketHandler
     sh_identifier_s        mSetSignalhandlerKeys; //! A set of all used signal handler keys
     VectorSignalHandlers_t mSignalHandlers;
     internal_codes_t       mInternalCodes;
+    std::atomic<sh_post_s *> mPostedTasks; //!< lock free stack of posted tasks, the newest one on top
+    bool                   mStatisticsEnabled;     //!< measure the callbacks, checked before any time is taken
+    sh_timerHandle_t       mStatisticsDumpTimer;   //!< timer for the periodic dump, 0 if not used
+    sh_loop_statistic_s    mLoopStatistics;
+    std::map<sh_pollHandle_t, sh_poll_statistic_s> mPollStatistics;
+    std::map<sh_timerHandle_t, sh_statistic_s>     mTimerStatistics;
 #ifndef WITH_TIMERFD
     timespec               mStartTime; //!< here the actual time is saved for timecorrection
 #endif
+#ifdef WITH_IO_URING
+    std::unique_ptr<CAmIoUring> mIoUring; //!< the io_uring backend, NULL if ppoll is used
+#endif
 
 private:
     bool fdIsValid(const int fd) const;
     void wakeupWorker(const std::string &func, const uint64_t value = 1u);
+    void runPostedTasks();
 
     timespec *insertTime(timespec &buffertime);
 
+    /**
+     * waits for the filedescriptors with the selected backend, semantics of ppoll
+     */
+    inline int waitForEvents(VectorPollfd_t &fdPollingArray, const timespec *timeout);
+
 #ifdef WITH_TIMERFD
     am_Error_e createTimeFD(const itimerspec &timeouts, int &fd);
 
@@ -454,35 +555,68 @@ private:
      * @param a
      * @return
      */
-    inline static void prepare(sh_poll_s &row);
+    inline void prepare(sh_poll_s &row);
 
     /**
      * functor to return all fired events
      * @param a
      * @return
      */
-    inline static void fire(const sh_poll_s &a);
+    inline void fire(const sh_poll_s &a);
 
     /**
      * functor to help find the items that do not need dispatching
      * @param a
      * @return
      */
-    inline static bool noDispatching(const sh_poll_s *a);
+    inline bool noDispatching(const sh_poll_s *a);
 
     /**
      * checks if dispatching is already finished
      * @param a
      * @return
      */
-    inline static bool dispatchingFinished(const sh_poll_s *a);
+    inline bool dispatchingFinished(const sh_poll_s *a);
+
+    /**
+     * removes all fired polls the predicate returns true for, without reallocation
+     * @param predicate
+     */
+    void compactFiredPolls(bool (CAmSocketHandler::*predicate)(const sh_poll_s *), const size_t first = 0);
+
+    /**
+     * stage 3, dispatches the fired polls in the order of their priority until all are finished or the budget is used up.
+     * The ones left are marked as pending and continued in the next loop iteration.
+     */
+    void dispatchFiredPolls();
+
+    /**
+     * drops pending polls which were removed or replaced since the last loop iteration
+     */
+    void dropStalePendingPolls();
 
     /**
      * timer fire callback
      * @param a
      * @return
      */
-    inline static void callTimer(sh_timer_s &a);
+    inline void callTimer(sh_timer_s &a);
+
+    /**
+     * returns the current monotonic time in ns if the statistics are enabled, 0 otherwise
+     */
+    inline uint64_t statisticsTime() const;
+
+    /**
+     * adds the time between start and end to the statistic, if both were taken
+     */
+    inline void addStatistic(sh_statistic_s &statistic, const uint64_t start, const uint64_t end);
+    inline void addPollStatistic(const sh_pollHandle_t handle, const sh_statistic_stage_e stage, const uint64_t start);
+    void addTimerStatistic(const sh_timerHandle_t handle, const uint64_t start, const uint64_t drift);
+    void createStatistics();
+#ifdef WITH_TIMERFD
+    uint64_t timerDrift(const sh_timerHandle_t handle, const uint64_t now);
+#endif
 
     /**
      * next handle id
@@ -507,6 +641,8 @@ public:
     am_Error_e addFDPoll(const int fd, const short event, IAmShPollPrepare *prepare, IAmShPollFired *fired, IAmShPollCheck *check, IAmShPollDispatch *dispatch, void *userData, sh_pollHandle_t &handle);
     am_Error_e removeFDPoll(const sh_pollHandle_t handle);
     am_Error_e updateEventFlags(const sh_pollHandle_t handle, const short events);
+    am_Error_e setPollPriority(const sh_pollHandle_t handle, const sh_priority_e priority);
+    void setDispatchBudget(const timespec &timeBudget, const uint32_t callBudget = 0);
     am_Error_e addSignalHandler(std::function<void(const sh_pollHandle_t handle, const signalfd_siginfo &info, void *userData)> callback, sh_pollHandle_t &handle, void *userData);
     am_Error_e removeSignalHandler(const sh_pollHandle_t handle);
 
@@ -528,12 +664,38 @@ public:
     am_Error_e restartTimer(const sh_timerHandle_t handle);
     am_Error_e updateTimer(const sh_timerHandle_t handle, const timespec &timeouts);
     am_Error_e stopTimer(const sh_timerHandle_t handle);
+
+    /**
+     * hands a task over to the mainloop. This is the only method that may be called from any thread.
+     */
+    am_Error_e post(std::function<void()> task);
+    am_Error_e postDelayed(const timespec &delay, std::function<void()> task);
+
     void start_listenting();
     void stop_listening();
     void exit_mainloop();
 
     bool fatalErrorOccurred();
 
+    /**
+     * selects how the mainloop waits for the filedescriptors. Must not be called while the mainloop runs.
+     * @param backend
+     * @return E_OK on success, E_NOT_POSSIBLE if the backend is not available, the current one is kept then
+     */
+    am_Error_e setBackend(const sh_backend_e backend);
+    sh_backend_e getBackend() const;
+
+    /**
+     * statistics of the callback execution times, disabled by default.
+     * If disabled, the only overhead is a check of a flag per callback.
+     */
+    void enableStatistics(const bool enable, const timespec &dumpInterval = timespec());
+    void resetStatistics();
+    void dumpStatistics();
+    void getLoopStatistics(sh_loop_statistic_s &statistics) const;
+    am_Error_e getPollStatistics(const sh_pollHandle_t handle, sh_poll_statistic_s &statistics) const;
+    am_Error_e getTimerStatistics(const sh_timerHandle_t handle, sh_statistic_s &statistics) const;
+
 };
 
 } /* namespace am */
@@ -0,0 +1,111 @@
+/**
+ * SPDX license identifier: MPL-2.0
+ *
+ * Copyright (C) 2012, BMW AG
+ *
+ * This file is part of GENIVI Project AudioManager.
+ *
+ * Contributions are licensed to the GENIVI Alliance under one or more
+ * Contribution License Agreements.
+ *
+ * \copyright
+ * This Source Code Form is subject to the terms of the
+ * Mozilla Public License, v. 2.0. If a  copy of the MPL was not distributed with
+ * this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ *
+ * \file CAmStartupProfiler.h
+ * For further information see http://www.genivi.org/.
+ *
+ */
+
+#ifndef CAMSTARTUPPROFILER_H_
+#define CAMSTARTUPPROFILER_H_
+
+#include <stdint.h>
+#include <chrono>
+#include <string>
+#include <vector>
+#include "CAmSocketHandler.h"
+
+namespace am
+{
+
+#ifdef UNIT_TEST
+class CAmStartupProfilerTest;
+#endif
+
+/**
+ * Records where the startup time of the daemon goes. The startup sequence is a chain of steps, each step ends when
+ * the next one starts. Phases that run beside the steps, like the ready handshake of a plugin, are begun and ended
+ * on their own. The timestamps are taken from the monotonic clock, relative to the creation of the profiler.
+ * When the daemon is ready and all phases have ended, a summary is logged and, if a file is set, a Chrome trace
+ * (chrome://tracing or Perfetto) is written. A plugin that never gets ready does not hold the report back for longer
+ * than the deadline, the phases that still run are reported as open.
+ * The profiler is used by the mainloop thread only.
+ */
+class CAmStartupProfiler
+{
+public:
+    static CAmStartupProfiler *instance();
+
+    /**
+     * ends the running step and starts the next one
+     * @param name the name of the step
+     */
+    void step(const std::string &name);
+
+    /**
+     * starts a phase that runs beside the steps
+     * @param name the name of the phase
+     * @return the phase, to be passed to end
+     */
+    uint32_t begin(const std::string &name);
+    void end(const uint32_t phase);
+
+    /**
+     * @param filename the file the Chrome trace is written to, empty for none (default)
+     */
+    void setTraceFile(const std::string &filename);
+
+    /**
+     * ends the last step, the report is done as soon as no phase is running any more
+     * @param socketHandler the socket handler of the mainloop, needed for the deadline
+     * @param deadline the time in ms after which the report is done with the running phases marked as open,
+     *                 0 waits for all phases
+     */
+    void ready(CAmSocketHandler *socketHandler = NULL, const uint32_t deadline = 0);
+
+private:
+#ifdef UNIT_TEST
+    friend class CAmStartupProfilerTest;
+#endif
+
+    struct phase_s
+    {
+        std::string name;
+        uint64_t    start; //!< in us since the creation of the profiler
+        uint64_t    end;   //!< in us since the creation of the profiler, 0 while the phase runs
+        bool        step;  //!< true for the steps of the startup sequence
+    };
+
+    CAmStartupProfiler();
+    uint64_t now() const;
+    void report();
+    void deadlineCallback(sh_timerHandle_t handle, void *userData);
+    bool writeTrace(const uint64_t reportTime) const;
+
+    std::chrono::steady_clock::time_point mStart;
+    std::vector<phase_s>                  mPhases;
+    uint32_t                              mRunningStep;   //!< the index of the running step + 1, 0 if none runs
+    uint32_t                              mRunningPhases; //!< the phases that were begun and not ended
+    bool                                  mReady;         //!< true after ready was called
+    bool                                  mReported;      //!< the report is done once
+    std::string                           mTraceFile;
+    CAmSocketHandler                     *mpSocketHandler;
+    sh_timerHandle_t                      mDeadlineTimer; //!< 0 if no deadline is pending
+    TAmShTimerCallBack<CAmStartupProfiler> mDeadlineCallbackT;
+};
+
+} /* namespace am */
+#endif /* CAMSTARTUPPROFILER_H_ */
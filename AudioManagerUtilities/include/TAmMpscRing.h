@@ -0,0 +1,160 @@
+/**
+ * SPDX license identifier: MPL-2.0
+ *
+ * Copyright (C) 2012, BMW AG
+ *
+ * This file is part of GENIVI Project AudioManager.
+ *
+ * Contributions are licensed to the GENIVI Alliance under one or more
+ * Contribution License Agreements.
+ *
+ * \copyright
+ * This Source Code Form is subject to the terms of the
+ * Mozilla Public License, v. 2.0. If a  copy of the MPL was not distributed with
+ * this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ *
+ * \file TAmMpscRing.h
+ * For further information see http://www.genivi.org/.
+ *
+ */
+
+#ifndef MPSCRING_H_
+#define MPSCRING_H_
+
+#include <atomic>
+#include <memory>
+#include <stdint.h>
+
+namespace am
+{
+
+/**
+ * A bounded lock free ring with many producers and one consumer.
+ * Every cell carries a sequence number, a producer claims a cell by increasing the enqueue position and publishes
+ * the value by setting the sequence. The consumer only takes published cells, so no locks are needed on either side.
+ * @tparam T the type of the elements, should be cheap to copy
+ */
+template<class T>
+class TAmMpscRing
+{
+public:
+    /**
+     * @param capacity the number of elements, rounded up to the next power of two
+     */
+    explicit TAmMpscRing(const size_t capacity)
+        : mMask(roundUp(capacity) - 1)
+        , mCells(new cell_s[mMask + 1])
+        , mEnqueuePos(0)
+        , mPadding()
+        , mDequeuePos(0)
+    {
+        for (size_t i = 0; i <= mMask; ++i)
+        {
+            mCells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * adds an element, can be called from any thread
+     * @param value
+     * @return false if the ring is full
+     */
+    bool push(const T &value)
+    {
+        size_t  pos = mEnqueuePos.load(std::memory_order_relaxed);
+        cell_s *cell;
+        for (;;)
+        {
+            cell = &mCells[pos & mMask];
+            const size_t   sequence = cell->sequence.load(std::memory_order_acquire);
+            const intptr_t diff     = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+            if (diff == 0)
+            {
+                if (mEnqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                {
+                    break;
+                }
+            }
+            else if (diff < 0)
+            {
+                return (false);
+            }
+            else
+            {
+                pos = mEnqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+
+        cell->value = value;
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        return (true);
+    }
+
+    /**
+     * takes the oldest published element, must only be called from the consumer thread
+     * @param value
+     * @return false if there is nothing published
+     */
+    bool pop(T &value)
+    {
+        cell_s *cell = &mCells[mDequeuePos & mMask];
+        if (cell->sequence.load(std::memory_order_acquire) != mDequeuePos + 1)
+        {
+            return (false);
+        }
+
+        value = cell->value;
+        cell->sequence.store(mDequeuePos + mMask + 1, std::memory_order_release);
+        ++mDequeuePos;
+        return (true);
+    }
+
+    size_t capacity() const
+    {
+        return (mMask + 1);
+    }
+
+    /**
+     * @return the number of elements pushed so far, the elements of pushes which did not return yet may be counted
+     */
+    size_t enqueued() const
+    {
+        return (mEnqueuePos.load(std::memory_order_relaxed));
+    }
+
+    /**
+     * @return the number of elements popped so far, must only be called from the consumer thread
+     */
+    size_t dequeued() const
+    {
+        return (mDequeuePos);
+    }
+
+private:
+    struct cell_s
+    {
+        std::atomic<size_t> sequence;
+        T                   value;
+    };
+
+    static size_t roundUp(const size_t capacity)
+    {
+        size_t size = 2;
+        while (size < capacity)
+        {
+            size <<= 1;
+        }
+
+        return (size);
+    }
+
+    const size_t              mMask;
+    std::unique_ptr<cell_s[]> mCells;
+    std::atomic<size_t>       mEnqueuePos; //!< shared by the producers
+    char                      mPadding[64 - sizeof(std::atomic<size_t>)]; //!< keeps the consumer position off the cache line of the producers
+    size_t                    mDequeuePos; //!< only touched by the consumer
+};
+
+} /* namespace am */
+#endif /* MPSCRING_H_ */
@@ -26,6 +26,16 @@
 
 #include <dlfcn.h>
 #include <libgen.h>
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
 #include "CAmDltWrapper.h"
 
 namespace am
@@ -130,6 +140,170 @@ T *getDestroyFunction(const std::string &libname, void *libraryHandle)
     return (destroyFunction);
 }
 
+/**
+ * searches the shared libraries in the directories
+ * @param listOfDirectories the directories with absolute path
+ * @return the libraries with full path, sorted so the plugins are always loaded in the same order
+ */
+inline std::vector<std::string> findPluginLibraries(const std::vector<std::string> &listOfDirectories)
+{
+    std::vector<std::string> listLibraries;
+    for (const std::string &directoryName : listOfDirectories)
+    {
+        logInfo("findPluginLibraries : Searching for plugins in", directoryName);
+        DIR *directory = opendir(directoryName.c_str());
+        if (!directory)
+        {
+            logError("findPluginLibraries : Error opening directory", directoryName);
+            continue;
+        }
+
+        struct dirent *itemInDirectory = 0;
+        while ((itemInDirectory = readdir(directory)))
+        {
+            unsigned char entryType = itemInDirectory->d_type;
+            std::string   entryName = itemInDirectory->d_name;
+            std::string   fullName  = directoryName + "/" + entryName;
+
+            bool regularFile        = (entryType == DT_REG || entryType == DT_LNK);
+            bool sharedLibExtension = ("so" == entryName.substr(entryName.find_last_of(".") + 1));
+
+            // Handle cases where readdir() could not determine the file type
+            if (entryType == DT_UNKNOWN)
+            {
+                struct stat buf;
+                if (stat(fullName.c_str(), &buf))
+                {
+                    logInfo("findPluginLibraries : Failed to stat file:", entryName, errno);
+                    continue;
+                }
+
+                regularFile = S_ISREG(buf.st_mode);
+            }
+
+            if (regularFile && sharedLibExtension)
+            {
+                listLibraries.push_back(fullName);
+            }
+            else
+            {
+                logInfo("findPluginLibraries : ignoring file", entryName);
+            }
+        }
+
+        closedir(directory);
+    }
+
+    std::sort(listLibraries.begin(), listLibraries.end());
+    return (listLibraries);
+}
+
+/**
+ * a library that was opened by openPluginLibraries
+ */
+template<class I>
+struct pluginLibrary_s
+{
+    std::string libname;       //!< the full path to the library
+    void       *libraryHandle; //!< NULL if the library could not be opened
+    I *(*createFunction)();    //!< NULL if the library or its entry point could not be loaded
+    uint64_t    loadTime;      //!< the time in us it took to load the plugin so far
+};
+
+/**
+ * reads a library into the page cache, so the following dlopen does not wait for the disk
+ * @param libname the full path to the library
+ */
+inline void prefetchPluginLibrary(const std::string &libname)
+{
+    int fd = open(libname.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd == -1)
+    {
+        return;
+    }
+
+    struct stat buf;
+    if (fstat(fd, &buf) == 0)
+    {
+        // blocks until the file is read, a failure only costs the overlap
+        (void)readahead(fd, 0, buf.st_size);
+    }
+
+    close(fd);
+}
+
+/**
+ * opens the libraries and looks up their entry points. A pool of threads reads the files ahead, the libraries are
+ * opened on the calling thread in the order of listLibraries. dlopen runs the static initializers of a library,
+ * which may register DLT contexts or do other work that was never required to be thread safe.
+ * @param listLibraries the libraries with full path
+ * @param numThreads the size of the pool, 0 uses one thread per core
+ * @return the libraries in the order of listLibraries
+ */
+template<class I>
+std::vector<pluginLibrary_s<I> > openPluginLibraries(const std::vector<std::string> &listLibraries, unsigned numThreads = 0)
+{
+    std::vector<pluginLibrary_s<I> > listOpened(listLibraries.size());
+    std::atomic<size_t>              next(0);
+    auto                             worker = [&]() {
+            for (size_t i = next++; i < listLibraries.size(); i = next++)
+            {
+                std::chrono::steady_clock::time_point start(std::chrono::steady_clock::now());
+                prefetchPluginLibrary(listLibraries[i]);
+                listOpened[i].loadTime = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+            }
+        };
+
+    if (numThreads == 0)
+    {
+        numThreads = std::thread::hardware_concurrency();
+    }
+
+    // the calling thread is one of the pool
+    numThreads = std::max(1u, std::min(numThreads, static_cast<unsigned>(listLibraries.size())));
+    std::vector<std::thread> listThreads;
+    for (unsigned i = 1; i < numThreads; i++)
+    {
+        listThreads.emplace_back(worker);
+    }
+
+    worker();
+    for (std::thread &thread : listThreads)
+    {
+        thread.join();
+    }
+
+    for (size_t i = 0; i < listLibraries.size(); i++)
+    {
+        std::chrono::steady_clock::time_point start(std::chrono::steady_clock::now());
+        pluginLibrary_s<I>                   &library(listOpened[i]);
+        library.libname        = listLibraries[i];
+        library.libraryHandle  = NULL;
+        library.createFunction = getCreateFunction<I *()>(library.libname, library.libraryHandle);
+        library.loadTime      += std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    return (listOpened);
+}
+
+/**
+ * calls the entry point of an opened library, the time it takes is added to the load time
+ * @return the plugin, NULL if the library has no entry point or the entry point failed
+ */
+template<class I>
+I *createPlugin(pluginLibrary_s<I> &library)
+{
+    if (!library.createFunction)
+    {
+        return (NULL);
+    }
+
+    std::chrono::steady_clock::time_point start(std::chrono::steady_clock::now());
+    I                                    *plugin = library.createFunction();
+    library.loadTime += std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+    return (plugin);
+}
+
 }
 
 #endif /* PLUGINTEMPLATE_H_ */
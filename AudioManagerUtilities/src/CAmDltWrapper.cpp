@@ -22,12 +22,18 @@
  *
  */
 
+#include <algorithm>
 #include <string>
 #include <iostream>
 #include <string.h>
 #include <chrono>
 #include <ctime>
 #include <sys/types.h>
+#include <sys/eventfd.h>
+#include <fcntl.h>
+#include <iomanip>
+#include <type_traits>
+#include <poll.h>
 #include <unistd.h>
 #include "CAmDltWrapper.h"
 
@@ -36,6 +42,280 @@ namespace am
 CAmDltWrapper  *CAmDltWrapper::mpDLTWrapper = NULL;
 pthread_mutex_t CAmDltWrapper::mMutex       = PTHREAD_MUTEX_INITIALIZER;
 
+/**
+ * A buffer of records with one producer, the thread it belongs to, and one consumer, the background thread.
+ * Each record is a header followed by the binary encoded arguments, padded to the header alignment. A record never
+ * wraps around the end, the remaining space is skipped with a header of size 0 instead.
+ */
+struct CAmDltWrapper::logThreadBuffer_s
+{
+    struct header_s
+    {
+        uint32_t        size;    //!< the size including the header, 0 to skip to the start of the buffer
+        uint32_t        length;  //!< the length of the encoded arguments
+        DltLogLevelType level;
+        DltContext     *context;
+    };
+
+    explicit logThreadBuffer_s(const size_t capacity)
+        : data(new char[capacity])
+        , capacity(capacity)
+        , head(0)
+        , tail(0)
+        , abandoned(false)
+    {
+    }
+
+    /**
+     * @return false if the record does not fit
+     */
+    bool push(const DltLogLevelType recordLevel, DltContext *recordContext, const std::string &arguments)
+    {
+        const size_t size     = (sizeof(header_s) + arguments.size() + sizeof(header_s) - 1) / sizeof(header_s) * sizeof(header_s);
+        const size_t position = tail.load(std::memory_order_relaxed);
+        const size_t offset   = position % capacity;
+        const size_t skip     = (capacity - offset < size) ? capacity - offset : 0;
+        if (position + skip + size - head.load(std::memory_order_acquire) > capacity)
+        {
+            return (false);
+        }
+
+        if (skip)
+        {
+            reinterpret_cast<header_s *>(data.get() + offset)->size = 0;
+        }
+
+        header_s *header = reinterpret_cast<header_s *>(data.get() + (position + skip) % capacity);
+        header->size    = size;
+        header->length  = arguments.size();
+        header->level   = recordLevel;
+        header->context = recordContext;
+        memcpy(header + 1, arguments.data(), arguments.size());
+        tail.store(position + skip + size, std::memory_order_release);
+        return (true);
+    }
+
+    /**
+     * calls write for each record, must only be called from the background thread
+     * @return the number of records
+     */
+    template<class TWrite>
+    size_t drain(TWrite write)
+    {
+        size_t       num      = 0;
+        size_t       position = head.load(std::memory_order_relaxed);
+        const size_t end      = tail.load(std::memory_order_acquire);
+        while (position != end)
+        {
+            const header_s *header = reinterpret_cast<const header_s *>(data.get() + position % capacity);
+            if (header->size == 0)
+            {
+                position += capacity - position % capacity;
+                continue;
+            }
+
+            write(*header, reinterpret_cast<const char *>(header + 1));
+            position += header->size;
+            ++num;
+        }
+
+        head.store(position, std::memory_order_release);
+        return (num);
+    }
+
+    bool empty() const
+    {
+        return (head.load(std::memory_order_acquire) == tail.load(std::memory_order_acquire));
+    }
+
+    std::unique_ptr<char[]> data;
+    const size_t            capacity;  //!< a multiple of the header size
+    std::atomic<size_t>     head;      //!< read position, only written by the background thread
+    std::atomic<size_t>     tail;      //!< write position, only written by the owning thread
+    std::atomic<bool>       abandoned; //!< the thread ended, the buffer is deleted once it is empty
+};
+
+/**
+ * The ring of the flight recorder. It is a ring of records of a fixed size, a writer reserves the next one with an
+ * atomic increment, so the threads that log do not wait for each other. The sequence of a record is 0 while it is
+ * written and the number of the record plus 1 once it is complete, a reader skips records that are incomplete or that
+ * were overwritten while it copied them. Arguments that do not fit into a record are cut off.
+ */
+struct CAmDltWrapper::flightRecorder_s
+{
+    static const size_t RECORD_SIZE = 256;
+
+    struct entry_s
+    {
+        uint32_t        length;  //!< the length of the encoded arguments
+        DltLogLevelType level;
+        DltContext     *context;
+        uint64_t        time;    //!< ms since the epoch
+        char            arguments[RECORD_SIZE - 4 * sizeof(uint64_t)];
+    };
+
+    struct record_s
+    {
+        std::atomic<uint64_t> sequence;
+        entry_s               entry;
+    };
+
+    explicit flightRecorder_s(const size_t size)
+        : numRecords(std::max<size_t>(size / sizeof(record_s), 2))
+        , records(new record_s[numRecords])
+        , next(0)
+    {
+        for (size_t i = 0; i < numRecords; i++)
+        {
+            records[i].sequence.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    void push(const DltLogLevelType recordLevel, DltContext *recordContext, const std::string &arguments)
+    {
+        // the coarse clock is read without a system call, milliseconds are all the dump shows
+        timespec now;
+        clock_gettime(CLOCK_REALTIME_COARSE, &now);
+        const uint64_t number = next.fetch_add(1, std::memory_order_relaxed);
+        record_s      &record(records[number % numRecords]);
+        record.sequence.store(0, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        record.entry.length  = std::min(arguments.size(), sizeof(record.entry.arguments));
+        record.entry.level   = recordLevel;
+        record.entry.context = recordContext;
+        record.entry.time    = static_cast<uint64_t>(now.tv_sec) * 1000 + now.tv_nsec / 1000000;
+        memcpy(record.entry.arguments, arguments.data(), record.entry.length);
+        record.sequence.store(number + 1, std::memory_order_release);
+    }
+
+    /**
+     * calls write with a copy of each complete record from the oldest to the newest, without locking and allocating
+     */
+    template<class TWrite>
+    void forEach(TWrite write) const
+    {
+        const uint64_t end = next.load(std::memory_order_acquire);
+        entry_s        entry;
+        for (uint64_t number = (end > numRecords) ? end - numRecords : 0; number < end; number++)
+        {
+            const record_s &record(records[number % numRecords]);
+            if (record.sequence.load(std::memory_order_acquire) != number + 1)
+            {
+                continue;
+            }
+
+            memcpy(&entry, &record.entry, sizeof(entry));
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (record.sequence.load(std::memory_order_relaxed) != number + 1)
+            {
+                continue;
+            }
+
+            entry.length = std::min<uint32_t>(entry.length, sizeof(entry.arguments));
+            write(entry);
+        }
+    }
+
+    const size_t                numRecords;
+    std::unique_ptr<record_s[]> records;
+    std::atomic<uint64_t>       next;       //!< the number of the next record
+};
+
+namespace
+{
+/**
+ * gives the buffer free when the thread ends
+ */
+struct logThreadBufferOwner_s
+{
+    CAmDltWrapper::logThreadBuffer_s *pBuffer = NULL;
+    ~logThreadBufferOwner_s()
+    {
+        if (pBuffer)
+        {
+            pBuffer->abandoned.store(true, std::memory_order_release);
+        }
+    }
+};
+
+/**
+ * a record that is encoded in binary form, for the background thread or the flight recorder
+ */
+struct encodedRecord_s
+{
+    std::string     arguments;
+    DltLogLevelType level;
+    DltContext     *context;
+    bool            output;   //!< the record is written
+    bool            recorded; //!< the record is kept by the flight recorder
+};
+
+thread_local logThreadBufferOwner_s tlsBuffer;
+thread_local encodedRecord_s        tlsRecord;
+thread_local encodedRecord_s       *tlsCurrent = NULL; //!< the record that is encoded at the moment, NULL if the values are written directly
+
+/**
+ * the type tags of the binary records, each argument is the tag followed by the raw value
+ */
+enum argTag_e : uint8_t
+{
+    ARG_INT8,
+    ARG_UINT8,
+    ARG_INT16,
+    ARG_UINT16,
+    ARG_INT32,
+    ARG_UINT32,
+    ARG_INT64,
+    ARG_UINT64,
+    ARG_BOOL,
+    ARG_STRING,        //!< uint32_t length followed by the characters
+    ARG_STATIC_STRING, //!< pointer to a string that lives as long as the program
+    ARG_POINTER,       //!< uint64_t
+    ARG_RAW            //!< uint32_t length followed by the bytes
+};
+
+/**
+ * @return false if the record is not encoded
+ */
+template<class T>
+bool encode(const argTag_e tag, const T value)
+{
+    if (!tlsCurrent)
+    {
+        return (false);
+    }
+
+    tlsCurrent->arguments.push_back(static_cast<char>(tag));
+    tlsCurrent->arguments.append(reinterpret_cast<const char *>(&value), sizeof(value));
+    return (true);
+}
+
+bool encodeBytes(const argTag_e tag, const void *data, const uint32_t length)
+{
+    if (!encode(tag, length))
+    {
+        return (false);
+    }
+
+    tlsCurrent->arguments.append(static_cast<const char *>(data), length);
+    return (true);
+}
+
+bool encodeRaw(const std::vector<uint8_t> &data)
+{
+    return (encodeBytes(ARG_RAW, data.data(), data.size()));
+}
+
+template<class T>
+T decodeValue(const char *&data)
+{
+    T value;
+    memcpy(&value, data, sizeof(value));
+    data += sizeof(value);
+    return (value);
+}
+}
+
 const std::vector<const char *> CAmDltWrapper::mStr_error =
 {
     "E_OK",
@@ -136,15 +416,6 @@ const std::vector<const char *> CAmDltWrapper::mStr_NotificationStatus =
     "NS_MAX"
 };
 
-std::string CAmDltWrapper::now()
-{
-    std::time_t t(std::chrono::system_clock::to_time_t(std::chrono::system_clock::now()));
-    struct tm  *timeinfo(localtime(&t));
-    char        buffer[80];
-    std::strftime(buffer, 80, "%D %T ", timeinfo);
-    return (std::string(buffer));
-}
-
 CAmDltWrapper *CAmDltWrapper::instanctiateOnce(const char *appid, const char *description, const bool debugEnabled, const logDestination logDest, const std::string Filename, bool onlyError)
 {
     if (!mpDLTWrapper)
@@ -369,11 +640,24 @@ CAmDltWrapper::CAmDltWrapper(const char *appid, const char *description, const b
     ,                                //
     mlogDestination(logDest)
     ,                             //
-    mFilename(NULL)
+    mFileSink()
     ,                    //
     mOnlyError(onlyError)
     ,                          //
     mLogOn(true)
+    , mAsync(false)
+    , mAsyncBufferSize(0)
+    , mAsyncMutex()
+    , mAsyncBuffers()
+    , mAsyncThread()
+    , mAsyncEventFd(-1)
+    , mAsyncSleeping(false)
+    , mAsyncStop(false)
+    , mAsyncDropped(0)
+    , mAsyncPasses(0)
+    , mRateLimits()
+    , mpFlightRecorder(NULL)
+    , mFlightRecorderLevel(DLT_LOG_DEFAULT)
 {
     if (mDebugEnabled && mlogDestination == logDestination::DAEMON)
     {
@@ -389,13 +673,12 @@ CAmDltWrapper::CAmDltWrapper(const char *appid, const char *description, const b
         }
         else
         {
-            mFilename.open(Filename, std::ofstream::out | std::ofstream::trunc);
-            if (!mFilename.is_open())
+            if (!mFileSink.open(Filename))
             {
                 throw std::runtime_error("Cannot open file for logging");
             }
 
-            mFilename << now() << "[DLT] Registering AppID " << appid << " , " << description << std::endl;
+            mFileSink.write(std::string("[DLT] Registering AppID ") + appid + " , " + description);
         }
     }
 }
@@ -407,9 +690,9 @@ CAmDltWrapper::~CAmDltWrapper()
         mpDLTWrapper->unregisterContext(mDltContext);
         delete mpDLTWrapper;
     }
-    else if (mpDLTWrapper && mDebugEnabled && mlogDestination == logDestination::COMMAND_LINE)
+    else if (mpDLTWrapper && mDebugEnabled && mlogDestination == logDestination::FILE_OUT)
     {
-        mFilename.close();
+        mFileSink.close();
     }
 }
 
@@ -423,6 +706,7 @@ void CAmDltWrapper::unregisterContext(DltContext &handle)
 
 void CAmDltWrapper::deinit()
 {
+    enableAsyncLogging(false);
     if (mDebugEnabled)
     {
         unregisterContext(mDltContext);
@@ -438,6 +722,7 @@ void CAmDltWrapper::registerContext(DltContext &handle, const char *contextid, c
     else if (mDebugEnabled)
     {
         mMapContext.emplace(&handle, std::string(contextid));
+        strncpy(handle.contextID, contextid, sizeof(handle.contextID)); // for the dump of the flight recorder
 
         if (mlogDestination == logDestination::COMMAND_LINE)
         {
@@ -445,7 +730,7 @@ void CAmDltWrapper::registerContext(DltContext &handle, const char *contextid, c
         }
         else
         {
-            mFilename << now() << "[DLT] Registering Context " << contextid << " , " << description << std::endl;
+            mFileSink.write(std::string("[DLT] Registering Context ") + contextid + " , " + description);
         }
     }
 }
@@ -459,6 +744,7 @@ void CAmDltWrapper::registerContext(DltContext &handle, const char *contextid, c
     else if (mDebugEnabled)
     {
         mMapContext.emplace(&handle, std::string(contextid));
+        strncpy(handle.contextID, contextid, sizeof(handle.contextID)); // for the dump of the flight recorder
 
         if (mlogDestination == logDestination::COMMAND_LINE)
         {
@@ -466,12 +752,12 @@ void CAmDltWrapper::registerContext(DltContext &handle, const char *contextid, c
         }
         else
         {
-            mFilename << now() << " [DLT] Registering Context " << contextid << " , " << description << std::endl;
+            mFileSink.write(std::string(" [DLT] Registering Context ") + contextid + " , " + description);
         }
     }
 }
 
-bool CAmDltWrapper::init(DltLogLevelType loglevel, DltContext *context)
+bool CAmDltWrapper::initSync(DltLogLevelType loglevel, DltContext *context)
 {
     pthread_mutex_lock(&mMutex);
     if (mlogDestination == logDestination::DAEMON)
@@ -495,7 +781,7 @@ bool CAmDltWrapper::init(DltLogLevelType loglevel, DltContext *context)
     return true;
 }
 
-void CAmDltWrapper::send()
+void CAmDltWrapper::sendSync(const bool flushLine)
 {
     if (mlogDestination == logDestination::DAEMON)
     {
@@ -505,11 +791,15 @@ void CAmDltWrapper::send()
     {
         if (mlogDestination == logDestination::COMMAND_LINE && mLogOn)
         {
-            std::cout << mNoDltContextData.buffer.str().c_str() << std::endl;
+            std::cout << mNoDltContextData.buffer.str().c_str() << '\n';
+            if (flushLine)
+            {
+                std::cout.flush();
+            }
         }
         else if (mLogOn)
         {
-            mFilename << now() << mNoDltContextData.buffer.str().c_str() << std::endl;
+            mFileSink.write(mNoDltContextData.buffer.str());
         }
 
         mNoDltContextData.buffer.str("");
@@ -521,6 +811,11 @@ void CAmDltWrapper::send()
 
 void CAmDltWrapper::append(const int8_t value)
 {
+    if (encode(ARG_INT8, value))
+    {
+        return;
+    }
+
     if (mlogDestination == logDestination::DAEMON)
     {
         dlt_user_log_write_int8(&mDltContextData, value);
@@ -533,6 +828,11 @@ void CAmDltWrapper::append(const int8_t value)
 
 void CAmDltWrapper::append(const uint8_t value)
 {
+    if (encode(ARG_UINT8, value))
+    {
+        return;
+    }
+
     if (mlogDestination == logDestination::DAEMON)
     {
         dlt_user_log_write_uint8(&mDltContextData, value);
@@ -545,6 +845,11 @@ void CAmDltWrapper::append(const uint8_t value)
 
 void CAmDltWrapper::append(const int16_t value)
 {
+    if (encode(ARG_INT16, value))
+    {
+        return;
+    }
+
     if (mlogDestination == logDestination::DAEMON)
     {
         dlt_user_log_write_int16(&mDltContextData, value);
@@ -557,6 +862,11 @@ void CAmDltWrapper::append(const int16_t value)
 
 void CAmDltWrapper::append(const uint16_t value)
 {
+    if (encode(ARG_UINT16, value))
+    {
+        return;
+    }
+
     if (mlogDestination == logDestination::DAEMON)
     {
         dlt_user_log_write_uint16(&mDltContextData, value);
@@ -569,6 +879,11 @@ void CAmDltWrapper::append(const uint16_t value)
 
 void CAmDltWrapper::append(const int32_t value)
 {
+    if (encode(ARG_INT32, value))
+    {
+        return;
+    }
+
     if (mlogDestination == logDestination::DAEMON)
     {
         dlt_user_log_write_int32(&mDltContextData, value);
@@ -581,6 +896,11 @@ void CAmDltWrapper::append(const int32_t value)
 
 void CAmDltWrapper::append(const uint32_t value)
 {
+    if (encode(ARG_UINT32, value))
+    {
+        return;
+    }
+
     if (mlogDestination == logDestination::DAEMON)
     {
         dlt_user_log_write_uint32(&mDltContextData, value);
@@ -598,6 +918,11 @@ void CAmDltWrapper::append(const std::string &value)
 
 void CAmDltWrapper::append(const bool value)
 {
+    if (encode(ARG_BOOL, value))
+    {
+        return;
+    }
+
     if (mlogDestination == logDestination::DAEMON)
     {
         dlt_user_log_write_bool(&mDltContextData, static_cast<uint8_t>(value));
@@ -610,6 +935,11 @@ void CAmDltWrapper::append(const bool value)
 
 void CAmDltWrapper::append(const int64_t value)
 {
+    if (encode(ARG_INT64, value))
+    {
+        return;
+    }
+
     if (mlogDestination == logDestination::DAEMON)
     {
         dlt_user_log_write_int64(&mDltContextData, value);
@@ -622,6 +952,11 @@ void CAmDltWrapper::append(const int64_t value)
 
 void CAmDltWrapper::append(const uint64_t value)
 {
+    if (encode(ARG_UINT64, value))
+    {
+        return;
+    }
+
     if (mlogDestination == logDestination::DAEMON)
     {
         dlt_user_log_write_uint64(&mDltContextData, value);
@@ -634,6 +969,11 @@ void CAmDltWrapper::append(const uint64_t value)
 
 void CAmDltWrapper::append(const std::vector<uint8_t> &data)
 {
+    if (encodeRaw(data))
+    {
+        return;
+    }
+
     if (mlogDestination == logDestination::DAEMON)
     {
         dlt_user_log_write_raw(&mDltContextData, (void *)data.data(), data.size());
@@ -651,11 +991,24 @@ CAmDltWrapper::CAmDltWrapper(const char *appid, const char *description, const b
     ,                                //
     mlogDestination(logDest)
     ,                             //
-    mFilename(NULL)
+    mFileSink()
     ,                    //
     mOnlyError(onlyError)
     ,                          //
     mLogOn(true)
+    , mAsync(false)
+    , mAsyncBufferSize(0)
+    , mAsyncMutex()
+    , mAsyncBuffers()
+    , mAsyncThread()
+    , mAsyncEventFd(-1)
+    , mAsyncSleeping(false)
+    , mAsyncStop(false)
+    , mAsyncDropped(0)
+    , mAsyncPasses(0)
+    , mRateLimits()
+    , mpFlightRecorder(NULL)
+    , mFlightRecorderLevel(DLT_LOG_DEFAULT)
 {
     if (logDest == logDestination::DAEMON)
     {
@@ -671,22 +1024,21 @@ CAmDltWrapper::CAmDltWrapper(const char *appid, const char *description, const b
         }
         else
         {
-            mFilename.open(Filename, std::ofstream::out | std::ofstream::trunc);
-            if (!mFilename.is_open())
+            if (!mFileSink.open(Filename))
             {
                 throw std::runtime_error("Cannot open file for logging");
             }
 
-            mFilename << now() << "[DLT] Registering AppID " << appid << " , " << description << std::endl;
+            mFileSink.write(std::string("[DLT] Registering AppID ") + appid + " , " + description);
         }
     }
 }
 
 CAmDltWrapper::~CAmDltWrapper()
 {
-    if (mpDLTWrapper && mDebugEnabled && mlogDestination == logDestination::COMMAND_LINE)
+    if (mpDLTWrapper && mDebugEnabled && mlogDestination == logDestination::FILE_OUT)
     {
-        mFilename.close();
+        mFileSink.close();
     }
 }
 
@@ -696,6 +1048,7 @@ void CAmDltWrapper::unregisterContext(DltContext &handle)
 
 void CAmDltWrapper::deinit()
 {
+    enableAsyncLogging(false);
 }
 
 void CAmDltWrapper::registerContext(DltContext &handle, const char *contextid, const char *description)
@@ -703,6 +1056,7 @@ void CAmDltWrapper::registerContext(DltContext &handle, const char *contextid, c
     if (mDebugEnabled)
     {
         mMapContext.emplace(&handle, std::string(contextid));
+        strncpy(handle.contextID, contextid, sizeof(handle.contextID)); // for the dump of the flight recorder
 
         if (mlogDestination == logDestination::COMMAND_LINE)
         {
@@ -710,7 +1064,7 @@ void CAmDltWrapper::registerContext(DltContext &handle, const char *contextid, c
         }
         else
         {
-            mFilename << now() << "[DLT] Registering Context " << contextid << " , " << description << std::endl;
+            mFileSink.write(std::string("[DLT] Registering Context ") + contextid + " , " + description);
         }
     }
 }
@@ -720,6 +1074,7 @@ void CAmDltWrapper::registerContext(DltContext &handle, const char *contextid, c
     if (mDebugEnabled)
     {
         mMapContext.emplace(&handle, std::string(contextid));
+        strncpy(handle.contextID, contextid, sizeof(handle.contextID)); // for the dump of the flight recorder
 
         if (mlogDestination == logDestination::COMMAND_LINE)
         {
@@ -727,26 +1082,30 @@ void CAmDltWrapper::registerContext(DltContext &handle, const char *contextid, c
         }
         else
         {
-            mFilename << now() << " [DLT] Registering Context " << contextid << " , " << description << std::endl;
+            mFileSink.write(std::string(" [DLT] Registering Context ") + contextid + " , " + description);
         }
     }
 }
 
-bool CAmDltWrapper::init(DltLogLevelType loglevel, DltContext *context)
+bool CAmDltWrapper::initSync(DltLogLevelType loglevel, DltContext *context)
 {
     pthread_mutex_lock(&mMutex);
     return initNoDlt(loglevel, context);
 }
 
-void CAmDltWrapper::send()
+void CAmDltWrapper::sendSync(const bool flushLine)
 {
     if (mlogDestination == logDestination::COMMAND_LINE && mLogOn)
     {
-        std::cout << mNoDltContextData.buffer.str().c_str() << std::endl;
+        std::cout << mNoDltContextData.buffer.str().c_str() << '\n';
+        if (flushLine)
+        {
+            std::cout.flush();
+        }
     }
     else if (mLogOn)
     {
-        mFilename << now() << mNoDltContextData.buffer.str().c_str() << std::endl;
+        mFileSink.write(mNoDltContextData.buffer.str());
     }
 
     mNoDltContextData.buffer.str("");
@@ -756,31 +1115,61 @@ void CAmDltWrapper::send()
 
 void CAmDltWrapper::append(const int8_t value)
 {
+    if (encode(ARG_INT8, value))
+    {
+        return;
+    }
+
     appendNoDLT(value);
 }
 
 void CAmDltWrapper::append(const uint8_t value)
 {
+    if (encode(ARG_UINT8, value))
+    {
+        return;
+    }
+
     appendNoDLT(value);
 }
 
 void CAmDltWrapper::append(const int16_t value)
 {
+    if (encode(ARG_INT16, value))
+    {
+        return;
+    }
+
     appendNoDLT(value);
 }
 
 void CAmDltWrapper::append(const uint16_t value)
 {
+    if (encode(ARG_UINT16, value))
+    {
+        return;
+    }
+
     appendNoDLT(value);
 }
 
 void CAmDltWrapper::append(const int32_t value)
 {
+    if (encode(ARG_INT32, value))
+    {
+        return;
+    }
+
     appendNoDLT(value);
 }
 
 void CAmDltWrapper::append(const uint32_t value)
 {
+    if (encode(ARG_UINT32, value))
+    {
+        return;
+    }
+
     appendNoDLT(value);
 }
 
@@ -791,23 +1180,773 @@ void CAmDltWrapper::append(const std::string &value)
 
 void CAmDltWrapper::append(const bool value)
 {
+    if (encode(ARG_BOOL, value))
+    {
+        return;
+    }
+
     appendNoDLT(value);
 }
 
 void CAmDltWrapper::append(const int64_t value)
 {
+    if (encode(ARG_INT64, value))
+    {
+        return;
+    }
+
     appendNoDLT(value);
 }
 
 void CAmDltWrapper::append(const uint64_t value)
 {
+    if (encode(ARG_UINT64, value))
+    {
+        return;
+    }
+
     appendNoDLT(value);
 }
 
 void CAmDltWrapper::append(const std::vector<uint8_t> &data)
 {
+    if (encodeRaw(data))
+    {
+        return;
+    }
+
     mNoDltContextData.buffer << data.data();
 }
 
 }
 #endif // WITH_DLT
+
+namespace am
+{
+
+bool CAmDltWrapper::init(DltLogLevelType loglevel, DltContext *context, const bool output)
+{
+    const bool recorded = isRecorded(loglevel);
+    if (recorded || (output && mAsync.load(std::memory_order_acquire)))
+    {
+        return (initEncoded(loglevel, context, output, recorded));
+    }
+
+    if (!output)
+    {
+        return (false);
+    }
+
+    return (initSync(loglevel, context));
+}
+
+void CAmDltWrapper::send()
+{
+    if (tlsCurrent)
+    {
+        sendEncoded();
+        return;
+    }
+
+    sendSync();
+}
+
+bool CAmDltWrapper::encodeString(const char *value, const bool isStatic)
+{
+    // a dump of the flight recorder can be read by another process, so it gets the text
+    if (isStatic && tlsCurrent && !tlsCurrent->recorded)
+    {
+        return (encode(ARG_STATIC_STRING, value));
+    }
+
+    return (encodeBytes(ARG_STRING, value, strlen(value)));
+}
+
+bool CAmDltWrapper::encodePointer(const void *value)
+{
+    return (encode(ARG_POINTER, static_cast<uint64_t>(reinterpret_cast<uintptr_t>(value))));
+}
+
+void CAmDltWrapper::appendStatic(const char *value)
+{
+    if (!encodeString(value, true))
+    {
+        append(value);
+    }
+}
+
+void CAmDltWrapper::decode(const char *data, const size_t length)
+{
+    const char *end = data + length;
+    while (data < end)
+    {
+        const argTag_e tag = static_cast<argTag_e>(*data++);
+        switch (tag)
+        {
+        case ARG_INT8:
+            append(decodeValue<int8_t>(data));
+            break;
+        case ARG_UINT8:
+            append(decodeValue<uint8_t>(data));
+            break;
+        case ARG_INT16:
+            append(decodeValue<int16_t>(data));
+            break;
+        case ARG_UINT16:
+            append(decodeValue<uint16_t>(data));
+            break;
+        case ARG_INT32:
+            append(decodeValue<int32_t>(data));
+            break;
+        case ARG_UINT32:
+            append(decodeValue<uint32_t>(data));
+            break;
+        case ARG_INT64:
+            append(decodeValue<int64_t>(data));
+            break;
+        case ARG_UINT64:
+            append(decodeValue<uint64_t>(data));
+            break;
+        case ARG_BOOL:
+            append(decodeValue<bool>(data));
+            break;
+        case ARG_STRING:
+        {
+            const uint32_t    size = decodeValue<uint32_t>(data);
+            const std::string value(data, size);
+            data += size;
+            append(value.c_str());
+            break;
+        }
+        case ARG_STATIC_STRING:
+            append(decodeValue<const char *>(data));
+            break;
+        case ARG_POINTER:
+            append(reinterpret_cast<void *>(static_cast<uintptr_t>(decodeValue<uint64_t>(data))));
+            break;
+        case ARG_RAW:
+        {
+            const uint32_t             size = decodeValue<uint32_t>(data);
+            const std::vector<uint8_t> value(data, data + size);
+            data += size;
+            append(value);
+            break;
+        }
+        default:
+            // the record is corrupt, the rest of it cannot be interpreted
+            return;
+        }
+    }
+}
+
+CAmDltWrapper::logThreadBuffer_s *CAmDltWrapper::threadBuffer()
+{
+    if (!tlsBuffer.pBuffer)
+    {
+        std::lock_guard<std::mutex> lock(mAsyncMutex);
+        const size_t capacity = (mAsyncBufferSize + sizeof(logThreadBuffer_s::header_s) - 1) / sizeof(logThreadBuffer_s::header_s) * sizeof(logThreadBuffer_s::header_s);
+        tlsBuffer.pBuffer = new logThreadBuffer_s(capacity);
+        mAsyncBuffers.push_back(tlsBuffer.pBuffer);
+    }
+
+    return (tlsBuffer.pBuffer);
+}
+
+bool CAmDltWrapper::initEncoded(DltLogLevelType loglevel, DltContext *context, const bool output, const bool recorded)
+{
+    tlsCurrent           = &tlsRecord;
+    tlsCurrent->level    = loglevel;
+    tlsCurrent->context  = context;
+    tlsCurrent->output   = output;
+    tlsCurrent->recorded = recorded;
+    tlsCurrent->arguments.clear();
+    return (true);
+}
+
+void CAmDltWrapper::sendEncoded()
+{
+    encodedRecord_s *pRecord = tlsCurrent;
+    tlsCurrent = NULL;
+    if (pRecord->recorded)
+    {
+        mpFlightRecorder->push(pRecord->level, pRecord->context, pRecord->arguments);
+    }
+
+    if (!pRecord->output)
+    {
+        return;
+    }
+
+    if (mAsync.load(std::memory_order_acquire))
+    {
+        sendAsync(pRecord->level, pRecord->context, pRecord->arguments);
+    }
+    else if (initSync(pRecord->level, pRecord->context))
+    {
+        decode(pRecord->arguments.data(), pRecord->arguments.size());
+        sendSync();
+    }
+}
+
+void CAmDltWrapper::sendAsync(DltLogLevelType loglevel, DltContext *context, const std::string &arguments)
+{
+    if (threadBuffer()->push(loglevel, context, arguments))
+    {
+        // pairs with the fence of the background thread, either it sees the record or we see it sleeping
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (mAsyncSleeping.load(std::memory_order_relaxed) && mAsyncSleeping.exchange(false))
+        {
+            uint64_t wakeup = 1;
+            if (write(mAsyncEventFd, &wakeup, sizeof(wakeup)) == -1)
+            {
+                // the background thread also wakes up periodically
+            }
+        }
+    }
+    else
+    {
+        mAsyncDropped.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+size_t CAmDltWrapper::drainAsync()
+{
+    std::vector<logThreadBuffer_s *> buffers;
+    {
+        std::lock_guard<std::mutex> lock(mAsyncMutex);
+        buffers = mAsyncBuffers;
+    }
+
+    size_t num   = 0;
+    auto   write = [this](const logThreadBuffer_s::header_s &header, const char *arguments) {
+            if (initSync(header.level, header.context))
+            {
+                decode(arguments, header.length);
+                sendSync(false);
+            }
+        };
+
+    for (logThreadBuffer_s *pBuffer : buffers)
+    {
+        num += pBuffer->drain(write);
+    }
+
+    const uint64_t dropped = mAsyncDropped.exchange(0, std::memory_order_relaxed);
+    if (dropped && initSync(DLT_LOG_WARN, NULL))
+    {
+        std::ostringstream text;
+        text << "[DLT] " << dropped << " log records dropped, the buffer was full";
+        append(text.str());
+        sendSync(false);
+    }
+
+    if ((num || dropped) && (mlogDestination == logDestination::COMMAND_LINE))
+    {
+        std::cout.flush();
+    }
+
+    // the buffers of ended threads are freed once they are empty
+    std::lock_guard<std::mutex> lock(mAsyncMutex);
+    for (std::vector<logThreadBuffer_s *>::iterator it = mAsyncBuffers.begin(); it != mAsyncBuffers.end();)
+    {
+        if ((*it)->abandoned.load(std::memory_order_acquire) && (*it)->empty())
+        {
+            delete *it;
+            it = mAsyncBuffers.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+
+    return (num);
+}
+
+void CAmDltWrapper::asyncThread()
+{
+    pthread_setname_np(pthread_self(), "AudioManagerLog");
+    while (!mAsyncStop.load(std::memory_order_acquire))
+    {
+        const size_t num = drainAsync();
+        mAsyncPasses.fetch_add(1, std::memory_order_release);
+        if (num)
+        {
+            continue;
+        }
+
+        mAsyncSleeping.store(true);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const size_t numBeforeSleep = drainAsync();
+        mAsyncPasses.fetch_add(1, std::memory_order_release);
+        if (numBeforeSleep == 0)
+        {
+            pollfd pfd = { mAsyncEventFd, POLLIN, 0 };
+            poll(&pfd, 1, 100);
+        }
+
+        mAsyncSleeping.store(false);
+        uint64_t wakeup;
+        if (read(mAsyncEventFd, &wakeup, sizeof(wakeup)) == -1)
+        {
+            // nothing was signalled
+        }
+    }
+
+    drainAsync();
+}
+
+void CAmDltWrapper::enableAsyncLogging(const bool enable, const size_t threadBufferSize)
+{
+    if (enable == mAsync.load())
+    {
+        return;
+    }
+
+    if (enable)
+    {
+        if (!mDebugEnabled)
+        {
+            return;
+        }
+
+        mAsyncEventFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (mAsyncEventFd == -1)
+        {
+            std::cerr << "CAmDltWrapper::enableAsyncLogging could not create eventfd, logging stays synchronous" << std::endl;
+            return;
+        }
+
+        mAsyncBufferSize = threadBufferSize;
+        mAsyncStop.store(false);
+        mAsyncThread = std::thread(&CAmDltWrapper::asyncThread, this);
+        mAsync.store(true, std::memory_order_release);
+    }
+    else
+    {
+        mAsync.store(false, std::memory_order_release);
+        mAsyncStop.store(true, std::memory_order_release);
+        uint64_t wakeup = 1;
+        if (write(mAsyncEventFd, &wakeup, sizeof(wakeup)) == -1)
+        {
+            // the thread wakes up periodically anyway
+        }
+
+        mAsyncThread.join();
+        close(mAsyncEventFd);
+        mAsyncEventFd = -1;
+    }
+}
+
+void CAmDltWrapper::flush()
+{
+    // a pass that started after this call has written everything logged before it
+    const uint64_t passes = mAsyncPasses.load(std::memory_order_acquire);
+    while (mAsync.load(std::memory_order_acquire) && (mAsyncPasses.load(std::memory_order_acquire) < passes + 2))
+    {
+        uint64_t wakeup = 1;
+        if (write(mAsyncEventFd, &wakeup, sizeof(wakeup)) == -1)
+        {
+            // the thread wakes up periodically anyway
+        }
+
+        usleep(1000);
+    }
+}
+
+bool CAmDltWrapper::configureLogFile(const size_t segmentSize, const unsigned numFiles, const CAmLogFileSink::syncPolicy_e syncPolicy)
+{
+    pthread_mutex_lock(&mMutex);
+    const bool ok = mFileSink.configure(segmentSize, numFiles, syncPolicy);
+    pthread_mutex_unlock(&mMutex);
+    return (ok);
+}
+
+void CAmDltWrapper::setRateLimit(DltContext *context, const DltLogLevelType logLevel, const uint32_t burst, const uint32_t perSecond)
+{
+    if (burst == 0)
+    {
+        mRateLimits.erase(std::make_pair(context, logLevel));
+        return;
+    }
+
+    // the tokens have to fit into 32 bit
+    rateLimit_s limit = { std::min(burst, 1000000u), perSecond };
+    mRateLimits[std::make_pair(context, logLevel)] = limit;
+}
+
+bool CAmDltWrapper::takeRateToken(logSite_s &site, DltContext *context, const DltLogLevelType logLevel, uint32_t &suppressed)
+{
+    std::map<std::pair<DltContext *, DltLogLevelType>, rateLimit_s>::const_iterator it = mRateLimits.find(std::make_pair(context, logLevel));
+    if (it == mRateLimits.end())
+    {
+        return (true);
+    }
+
+    const uint64_t maxTokens = it->second.burst * 1000ull;
+    const uint32_t now       = static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count());
+    uint64_t       state  = site.state.load(std::memory_order_relaxed);
+    bool           pass;
+    uint64_t       tokens;
+    do
+    {
+        tokens = maxTokens;
+        if (state != UINT64_MAX)
+        {
+            // the time wraps around after 49 days, the difference is still right
+            const uint32_t elapsed = now - static_cast<uint32_t>(state);
+            tokens = std::min(maxTokens, (state >> 32) + static_cast<uint64_t>(elapsed) * it->second.perSecond);
+        }
+
+        pass = (tokens >= 1000);
+        if (pass)
+        {
+            tokens -= 1000;
+        }
+    }
+    while (!site.state.compare_exchange_weak(state, (tokens << 32) | now, std::memory_order_relaxed));
+
+    if (!pass)
+    {
+        site.suppressed.fetch_add(1, std::memory_order_relaxed);
+        return (false);
+    }
+
+    suppressed = site.suppressed.exchange(0, std::memory_order_relaxed);
+    return (true);
+}
+
+void CAmDltWrapper::enableFlightRecorder(const size_t size, const DltLogLevelType logLevel)
+{
+    if (size == 0)
+    {
+        mFlightRecorderLevel.store(DLT_LOG_DEFAULT);
+        return;
+    }
+
+    // the ring is kept once it was created, other threads might still write into it
+    if (!mpFlightRecorder)
+    {
+        mpFlightRecorder = new flightRecorder_s(size);
+    }
+
+    mFlightRecorderLevel.store(logLevel);
+}
+
+std::string CAmDltWrapper::contextName(DltContext *context)
+{
+    if (!context)
+    {
+        return ("DEF");
+    }
+
+    if (mlogDestination == logDestination::DAEMON)
+    {
+        return (std::string(context->contextID, strnlen(context->contextID, sizeof(context->contextID))));
+    }
+
+    std::map<DltContext *, std::string>::const_iterator it = mMapContext.find(context);
+    return ((it != mMapContext.end()) ? it->second : std::string("???"));
+}
+
+namespace
+{
+/**
+ * a line of a dump of the flight recorder, formatted without locale and heap, so it can be used in signal handlers
+ */
+class dumpLine
+{
+public:
+    dumpLine()
+        : mLength(0)
+    {
+    }
+
+    void append(const char *text, const size_t length)
+    {
+        const size_t num = std::min(length, sizeof(mBuffer) - mLength);
+        memcpy(mBuffer + mLength, text, num);
+        mLength += num;
+    }
+
+    void append(const char *text)
+    {
+        append(text, strnlen(text, sizeof(mBuffer)));
+    }
+
+    void append(const char c)
+    {
+        append(&c, 1);
+    }
+
+    void appendNumber(uint64_t value, const unsigned base = 10, const unsigned width = 1)
+    {
+        char     digits[24];
+        unsigned num = 0;
+        do
+        {
+            digits[num++] = "0123456789abcdef"[value % base];
+            value        /= base;
+        }
+        while (value != 0);
+
+        while (num < width && num < sizeof(digits))
+        {
+            digits[num++] = '0';
+        }
+
+        while (num > 0)
+        {
+            append(digits[--num]);
+        }
+    }
+
+    void appendNumber(const int64_t value)
+    {
+        if (value < 0)
+        {
+            append('-');
+            appendNumber(0 - static_cast<uint64_t>(value));
+        }
+        else
+        {
+            appendNumber(static_cast<uint64_t>(value));
+        }
+    }
+
+    /**
+     * appends the time in the format MM/DD/YY HH:MM:SS.mmm, in UTC since the time zone can not be read in a signal handler
+     */
+    void appendTime(const uint64_t ms)
+    {
+        // the civil date of the days since the epoch, see http://howardhinnant.github.io/date_algorithms.html
+        const uint64_t seconds = ms / 1000;
+        const int64_t  days    = seconds / 86400 + 719468;
+        const int64_t  era     = days / 146097;
+        const int64_t  doe     = days - era * 146097;
+        const int64_t  yoe     = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+        const int64_t  doy     = doe - (365 * yoe + yoe / 4 - yoe / 100);
+        const int64_t  mp      = (5 * doy + 2) / 153;
+        const int64_t  day     = doy - (153 * mp + 2) / 5 + 1;
+        const int64_t  month   = (mp < 10) ? mp + 3 : mp - 9;
+        const int64_t  year    = yoe + era * 400 + ((month <= 2) ? 1 : 0);
+        appendNumber(month, 10, 2);
+        append('/');
+        appendNumber(day, 10, 2);
+        append('/');
+        appendNumber(year % 100, 10, 2);
+        append(' ');
+        appendNumber(seconds % 86400 / 3600, 10, 2);
+        append(':');
+        appendNumber(seconds % 3600 / 60, 10, 2);
+        append(':');
+        appendNumber(seconds % 60, 10, 2);
+        append('.');
+        appendNumber(ms % 1000, 10, 3);
+    }
+
+    /**
+     * appends the binary encoded arguments, stops at the first one that is cut off
+     */
+    void appendArguments(const char *data, const size_t length)
+    {
+        const char *end = data + length;
+        while (data < end)
+        {
+            append(' ');
+            switch (static_cast<argTag_e>(*data++))
+            {
+            case ARG_INT8:
+                data = appendValue<int8_t>(data, end);
+                break;
+            case ARG_UINT8:
+                data = appendValue<uint8_t>(data, end);
+                break;
+            case ARG_INT16:
+                data = appendValue<int16_t>(data, end);
+                break;
+            case ARG_UINT16:
+                data = appendValue<uint16_t>(data, end);
+                break;
+            case ARG_INT32:
+                data = appendValue<int32_t>(data, end);
+                break;
+            case ARG_UINT32:
+                data = appendValue<uint32_t>(data, end);
+                break;
+            case ARG_INT64:
+                data = appendValue<int64_t>(data, end);
+                break;
+            case ARG_UINT64:
+                data = appendValue<uint64_t>(data, end);
+                break;
+            case ARG_BOOL:
+                data = appendValue<bool>(data, end);
+                break;
+            case ARG_STRING:
+            {
+                // the string the record was cut off in is shown as far as it is there
+                uint32_t size;
+                if (!take(data, end, size))
+                {
+                    return;
+                }
+
+                append(data, std::min<size_t>(size, end - data));
+                data += std::min<size_t>(size, end - data);
+                break;
+            }
+            case ARG_STATIC_STRING:
+            {
+                const char *text;
+                if (!take(data, end, text))
+                {
+                    return;
+                }
+
+                append(text);
+                break;
+            }
+            case ARG_POINTER:
+            {
+                uint64_t pointer;
+                if (!take(data, end, pointer))
+                {
+                    return;
+                }
+
+                append("0x");
+                appendNumber(pointer, 16);
+                break;
+            }
+            case ARG_RAW:
+            {
+                uint32_t size;
+                if (!take(data, end, size) || (size > static_cast<size_t>(end - data)))
+                {
+                    return;
+                }
+
+                for (uint32_t i = 0; i < size; i++)
+                {
+                    appendNumber(static_cast<uint8_t>(data[i]), 16, 2);
+                }
+
+                data += size;
+                break;
+            }
+            default:
+                return;
+            }
+
+            if (data == NULL)
+            {
+                return;
+            }
+        }
+    }
+
+    const char *data() const
+    {
+        return (mBuffer);
+    }
+
+    size_t length() const
+    {
+        return (mLength);
+    }
+
+private:
+    template<class T>
+    static bool take(const char *&data, const char *end, T &value)
+    {
+        if (static_cast<size_t>(end - data) < sizeof(value))
+        {
+            return (false);
+        }
+
+        value = decodeValue<T>(data);
+        return (true);
+    }
+
+    /**
+     * @return the position after the value, NULL if it is cut off
+     */
+    template<class T>
+    const char *appendValue(const char *data, const char *end)
+    {
+        T value;
+        if (!take(data, end, value))
+        {
+            return (NULL);
+        }
+
+        if (std::is_signed<T>::value)
+        {
+            appendNumber(static_cast<int64_t>(value));
+        }
+        else
+        {
+            appendNumber(static_cast<uint64_t>(value));
+        }
+
+        return (data);
+    }
+
+    char   mBuffer[1024];
+    size_t mLength;
+};
+}
+
+void CAmDltWrapper::dumpFlightRecorder(const int fd)
+{
+    static const char *levelNames[] = { "[Off ]", "[Fatl]", "[Erro]", "[Warn]", "[Info]", "[Dbug]", "[Verb]" };
+    if (!mpFlightRecorder)
+    {
+        return;
+    }
+
+    mpFlightRecorder->forEach([fd](const flightRecorder_s::entry_s &entry) {
+            dumpLine line;
+            line.appendTime(entry.time);
+            line.append(" [");
+            if (entry.context)
+            {
+                line.append(entry.context->contextID, strnlen(entry.context->contextID, sizeof(entry.context->contextID)));
+            }
+            else
+            {
+                line.append("DEF");
+            }
+
+            line.append("] ");
+            line.append(((entry.level >= DLT_LOG_OFF) && (entry.level <= DLT_LOG_VERBOSE)) ? levelNames[entry.level] : "[Defa]");
+            line.appendArguments(entry.arguments, entry.length);
+            line.append('\n');
+            if (::write(fd, line.data(), line.length()) == -1)
+            {
+                // nothing to do about it
+            }
+        });
+}
+
+bool CAmDltWrapper::dumpFlightRecorder(const std::string &filename)
+{
+    if (!mpFlightRecorder)
+    {
+        return (false);
+    }
+
+    const int fd = open(filename.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
+    if (fd == -1)
+    {
+        return (false);
+    }
+
+    dumpFlightRecorder(fd);
+    close(fd);
+    return (true);
+}
+
+}
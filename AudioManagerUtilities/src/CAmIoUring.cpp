@@ -0,0 +1,324 @@
+/**
+ * SPDX license identifier: MPL-2.0
+ *
+ * Copyright (C) 2012, BMW AG
+ *
+ * This file is part of GENIVI Project AudioManager.
+ *
+ * Contributions are licensed to the GENIVI Alliance under one or more
+ * Contribution License Agreements.
+ *
+ * \copyright
+ * This Source Code Form is subject to the terms of the
+ * Mozilla Public License, v. 2.0. If a  copy of the MPL was not distributed with
+ * this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ *
+ * \file CAmIoUring.cpp
+ * For further information see http://www.genivi.org/.
+ *
+ */
+
+#include "CAmIoUring.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <linux/io_uring.h>
+#include "CAmDltWrapper.h"
+
+#define REMOVE_USER_DATA UINT64_MAX
+
+namespace am
+{
+
+CAmIoUring::CAmIoUring()
+    : mRingFd(-1)
+    , mSqRing(MAP_FAILED)
+    , mSqRingSize(0)
+    , mCqRing(MAP_FAILED)
+    , mCqRingSize(0)
+    , mSqes(static_cast<io_uring_sqe *>(MAP_FAILED))
+    , mSqesSize(0)
+    , mSqHead(NULL)
+    , mSqTail(NULL)
+    , mSqMask(NULL)
+    , mSqEntries(NULL)
+    , mSqArray(NULL)
+    , mCqHead(NULL)
+    , mCqTail(NULL)
+    , mCqMask(NULL)
+    , mCqes(NULL)
+    , mSqLocalTail(0)
+    , mToSubmit(0)
+    , mIteration(0)
+    , mArmed()
+{
+}
+
+CAmIoUring::~CAmIoUring()
+{
+    if (mSqes != MAP_FAILED)
+    {
+        munmap(mSqes, mSqesSize);
+    }
+
+    if ((mCqRing != MAP_FAILED) && (mCqRing != mSqRing))
+    {
+        munmap(mCqRing, mCqRingSize);
+    }
+
+    if (mSqRing != MAP_FAILED)
+    {
+        munmap(mSqRing, mSqRingSize);
+    }
+
+    if (mRingFd >= 0)
+    {
+        close(mRingFd);
+    }
+}
+
+bool CAmIoUring::init(const unsigned entries)
+{
+    io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    mRingFd = syscall(__NR_io_uring_setup, entries, &params);
+    if (mRingFd < 0)
+    {
+        logInfo("CAmIoUring::init io_uring not available:", static_cast<const char *>(std::strerror(errno)));
+        return (false);
+    }
+
+    // the timeout of the wait and a completion queue that never drops are needed
+    if (!(params.features & IORING_FEAT_EXT_ARG) || !(params.features & IORING_FEAT_NODROP))
+    {
+        logInfo("CAmIoUring::init io_uring features missing", params.features);
+        return (false);
+    }
+
+    mSqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    mCqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    if (params.features & IORING_FEAT_SINGLE_MMAP)
+    {
+        mSqRingSize = mCqRingSize = std::max(mSqRingSize, mCqRingSize);
+    }
+
+    mSqRing = mmap(NULL, mSqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, mRingFd, IORING_OFF_SQ_RING);
+    if (mSqRing == MAP_FAILED)
+    {
+        logError("CAmIoUring::init could not map the submission queue", static_cast<const char *>(std::strerror(errno)));
+        return (false);
+    }
+
+    if (params.features & IORING_FEAT_SINGLE_MMAP)
+    {
+        mCqRing = mSqRing;
+    }
+    else
+    {
+        mCqRing = mmap(NULL, mCqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, mRingFd, IORING_OFF_CQ_RING);
+        if (mCqRing == MAP_FAILED)
+        {
+            logError("CAmIoUring::init could not map the completion queue", static_cast<const char *>(std::strerror(errno)));
+            return (false);
+        }
+    }
+
+    mSqesSize = params.sq_entries * sizeof(io_uring_sqe);
+    mSqes     = static_cast<io_uring_sqe *>(mmap(NULL, mSqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, mRingFd, IORING_OFF_SQES));
+    if (mSqes == MAP_FAILED)
+    {
+        logError("CAmIoUring::init could not map the submission queue entries", static_cast<const char *>(std::strerror(errno)));
+        return (false);
+    }
+
+    char *sqRing = static_cast<char *>(mSqRing);
+    char *cqRing = static_cast<char *>(mCqRing);
+    mSqHead      = reinterpret_cast<unsigned *>(sqRing + params.sq_off.head);
+    mSqTail      = reinterpret_cast<unsigned *>(sqRing + params.sq_off.tail);
+    mSqMask      = reinterpret_cast<unsigned *>(sqRing + params.sq_off.ring_mask);
+    mSqEntries   = reinterpret_cast<unsigned *>(sqRing + params.sq_off.ring_entries);
+    mSqArray     = reinterpret_cast<unsigned *>(sqRing + params.sq_off.array);
+    mCqHead      = reinterpret_cast<unsigned *>(cqRing + params.cq_off.head);
+    mCqTail      = reinterpret_cast<unsigned *>(cqRing + params.cq_off.tail);
+    mCqMask      = reinterpret_cast<unsigned *>(cqRing + params.cq_off.ring_mask);
+    mCqes        = reinterpret_cast<io_uring_cqe *>(cqRing + params.cq_off.cqes);
+    mSqLocalTail = *mSqTail;
+    return (true);
+}
+
+int CAmIoUring::wait(std::vector<pollfd> &fds, const timespec *timeout)
+{
+    ++mIteration;
+
+    // arm the new fds and the ones that fired since the last wait
+    for (size_t i = 0; i < fds.size(); ++i)
+    {
+        pollfd &elem = fds[i];
+        elem.revents = 0;
+        if (elem.fd < 0)
+        {
+            continue;
+        }
+
+        if (static_cast<size_t>(elem.fd) >= mArmed.size())
+        {
+            mArmed.resize(elem.fd + 1);
+        }
+
+        armed_s &armed = mArmed[elem.fd];
+        armed.iteration = mIteration;
+        armed.index     = i;
+        if (armed.armed && (armed.events != elem.events))
+        {
+            queueRemove(elem.fd, armed);
+        }
+
+        if (!armed.armed)
+        {
+            queuePoll(elem.fd, armed, elem.events);
+        }
+    }
+
+    // remove the polls of fds which are not in the polling array anymore
+    for (size_t fd = 0; fd < mArmed.size(); ++fd)
+    {
+        if (mArmed[fd].armed && (mArmed[fd].iteration != mIteration))
+        {
+            queueRemove(fd, mArmed[fd]);
+        }
+    }
+
+    const int ret   = enter(1, timeout);
+    const int error = errno;
+    const int num   = reap(fds);
+    if (num > 0)
+    {
+        return (num);
+    }
+
+    if ((ret < 0) && (error != ETIME) && (error != EBUSY) && (error != EAGAIN))
+    {
+        errno = error;
+        return (-1);
+    }
+
+    return (0);
+}
+
+void CAmIoUring::rearm(const int fd)
+{
+    if ((fd >= 0) && (static_cast<size_t>(fd) < mArmed.size()) && mArmed[fd].armed)
+    {
+        queueRemove(fd, mArmed[fd]);
+    }
+}
+
+io_uring_sqe *CAmIoUring::getSqe()
+{
+    if (mSqLocalTail - __atomic_load_n(mSqHead, __ATOMIC_ACQUIRE) >= *mSqEntries)
+    {
+        // the queue is full, hand over what we have without waiting
+        enter(0, NULL);
+    }
+
+    const unsigned index = mSqLocalTail & *mSqMask;
+    io_uring_sqe  *sqe   = &mSqes[index];
+    memset(sqe, 0, sizeof(*sqe));
+    mSqArray[index] = index;
+    ++mSqLocalTail;
+    ++mToSubmit;
+    __atomic_store_n(mSqTail, mSqLocalTail, __ATOMIC_RELEASE);
+    return (sqe);
+}
+
+void CAmIoUring::queuePoll(const int fd, armed_s &armed, const short events)
+{
+    ++armed.generation;
+    armed.events = events;
+    armed.armed  = true;
+
+    io_uring_sqe *sqe = getSqe();
+    sqe->opcode        = IORING_OP_POLL_ADD;
+    sqe->fd            = fd;
+    sqe->poll32_events = static_cast<uint16_t>(events);
+    sqe->user_data     = (static_cast<uint64_t>(armed.generation) << 32) | static_cast<uint32_t>(fd);
+}
+
+void CAmIoUring::queueRemove(const int fd, armed_s &armed)
+{
+    armed.armed = false;
+
+    io_uring_sqe *sqe = getSqe();
+    sqe->opcode    = IORING_OP_POLL_REMOVE;
+    sqe->fd        = -1;
+    sqe->addr      = (static_cast<uint64_t>(armed.generation) << 32) | static_cast<uint32_t>(fd);
+    sqe->user_data = REMOVE_USER_DATA;
+}
+
+int CAmIoUring::enter(const unsigned minComplete, const timespec *timeout)
+{
+    __kernel_timespec      ts;
+    io_uring_getevents_arg arg;
+    memset(&arg, 0, sizeof(arg));
+    if (timeout)
+    {
+        ts.tv_sec  = timeout->tv_sec;
+        ts.tv_nsec = timeout->tv_nsec;
+        arg.ts     = reinterpret_cast<uint64_t>(&ts);
+    }
+
+    unsigned flags = IORING_ENTER_EXT_ARG;
+    if (minComplete)
+    {
+        flags |= IORING_ENTER_GETEVENTS;
+    }
+
+    const int ret = syscall(__NR_io_uring_enter, mRingFd, mToSubmit, minComplete, flags, &arg, sizeof(arg));
+
+    // entries which were not taken by the kernel are handed over with the next call
+    mToSubmit = mSqLocalTail - __atomic_load_n(mSqHead, __ATOMIC_ACQUIRE);
+    return (ret);
+}
+
+int CAmIoUring::reap(std::vector<pollfd> &fds)
+{
+    int      num  = 0;
+    unsigned head = *mCqHead;
+    unsigned tail = __atomic_load_n(mCqTail, __ATOMIC_ACQUIRE);
+    for (; head != tail; ++head)
+    {
+        const io_uring_cqe &cqe = mCqes[head & *mCqMask];
+        if (cqe.user_data == REMOVE_USER_DATA)
+        {
+            continue;
+        }
+
+        const uint32_t fd         = static_cast<uint32_t>(cqe.user_data);
+        const uint32_t generation = static_cast<uint32_t>(cqe.user_data >> 32);
+        if ((fd >= mArmed.size()) || !mArmed[fd].armed || (mArmed[fd].generation != generation))
+        {
+            // completion of a poll that was removed already
+            continue;
+        }
+
+        // one shot, it is armed again on the next wait
+        armed_s &armed = mArmed[fd];
+        armed.armed = false;
+        if ((armed.iteration != mIteration) || (armed.index >= fds.size()) || (fds[armed.index].fd != static_cast<int>(fd)))
+        {
+            continue;
+        }
+
+        fds[armed.index].revents = (cqe.res < 0) ? POLLNVAL : static_cast<short>(cqe.res);
+        ++num;
+    }
+
+    __atomic_store_n(mCqHead, head, __ATOMIC_RELEASE);
+    return (num);
+}
+
+} /* namespace am */
@@ -0,0 +1,247 @@
+/**
+ * SPDX license identifier: MPL-2.0
+ *
+ * Copyright (C) 2012, BMW AG
+ *
+ * This file is part of GENIVI Project AudioManager.
+ *
+ * Contributions are licensed to the GENIVI Alliance under one or more
+ * Contribution License Agreements.
+ *
+ * \copyright
+ * This Source Code Form is subject to the terms of the
+ * Mozilla Public License, v. 2.0. If a  copy of the MPL was not distributed with
+ * this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ *
+ * \file CAmLogFileSink.cpp
+ * For further information see http://www.genivi.org/.
+ *
+ */
+
+#include "CAmLogFileSink.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <iostream>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace am
+{
+
+static const size_t MIN_SEGMENT_SIZE = 4096;
+
+CAmLogFileSink::CAmLogFileSink()
+    : mFilename()
+    , mSegmentSize(0)
+    , mNumFiles(1)
+    , mSyncPolicy(SYNC_ON_ROTATE)
+    , mFd(-1)
+    , mpSegment(NULL)
+    , mUsed(0)
+    , mPrefixMs(0)
+    , mPrefixSecond(0)
+    , mPrefix()
+    , mPrefixLength(0)
+{
+}
+
+CAmLogFileSink::~CAmLogFileSink()
+{
+    close();
+}
+
+bool CAmLogFileSink::open(const std::string &filename, const size_t segmentSize, const unsigned numFiles, const syncPolicy_e syncPolicy)
+{
+    close();
+    mFilename    = filename;
+    mSegmentSize = std::max(segmentSize, MIN_SEGMENT_SIZE);
+    mNumFiles    = std::max(numFiles, 1u);
+    mSyncPolicy  = syncPolicy;
+    return (openSegment(false));
+}
+
+bool CAmLogFileSink::configure(const size_t segmentSize, const unsigned numFiles, const syncPolicy_e syncPolicy)
+{
+    if (!isOpen())
+    {
+        return (false);
+    }
+
+    closeSegment();
+    mSegmentSize = std::max(segmentSize, MIN_SEGMENT_SIZE);
+    mNumFiles    = std::max(numFiles, 1u);
+    mSyncPolicy  = syncPolicy;
+    return (openSegment(true));
+}
+
+void CAmLogFileSink::close()
+{
+    if (isOpen())
+    {
+        closeSegment();
+    }
+}
+
+bool CAmLogFileSink::isOpen() const
+{
+    return (mpSegment != NULL);
+}
+
+bool CAmLogFileSink::openSegment(const bool keep)
+{
+    mFd = ::open(mFilename.c_str(), O_RDWR | O_CREAT | O_CLOEXEC | (keep ? 0 : O_TRUNC), S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
+    if (mFd == -1)
+    {
+        std::cerr << "CAmLogFileSink::openSegment could not open " << mFilename << ": " << std::strerror(errno) << std::endl;
+        return (false);
+    }
+
+    struct stat status;
+    mUsed = (keep && (fstat(mFd, &status) == 0)) ? status.st_size : 0;
+    if (mUsed >= mSegmentSize)
+    {
+        ::close(mFd);
+        mFd = -1;
+        rotate();
+        return (isOpen());
+    }
+
+    // preallocate the blocks, so writing into the mapping cannot fail for lack of space
+    if ((posix_fallocate(mFd, 0, mSegmentSize) != 0) && (ftruncate(mFd, mSegmentSize) != 0))
+    {
+        std::cerr << "CAmLogFileSink::openSegment could not allocate " << mFilename << ": " << std::strerror(errno) << std::endl;
+        ::close(mFd);
+        mFd = -1;
+        return (false);
+    }
+
+    void *pSegment = mmap(NULL, mSegmentSize, PROT_READ | PROT_WRITE, MAP_SHARED, mFd, 0);
+    if (pSegment == MAP_FAILED)
+    {
+        std::cerr << "CAmLogFileSink::openSegment could not map " << mFilename << ": " << std::strerror(errno) << std::endl;
+        ::close(mFd);
+        mFd = -1;
+        return (false);
+    }
+
+    mpSegment = static_cast<char *>(pSegment);
+    return (true);
+}
+
+void CAmLogFileSink::closeSegment()
+{
+    munmap(mpSegment, mSegmentSize);
+    mpSegment = NULL;
+
+    // the preallocated rest is cut off, so the file ends with the last line
+    if (ftruncate(mFd, mUsed) != 0)
+    {
+        std::cerr << "CAmLogFileSink::closeSegment could not truncate " << mFilename << ": " << std::strerror(errno) << std::endl;
+    }
+
+    if (mSyncPolicy != SYNC_NEVER)
+    {
+        fdatasync(mFd);
+    }
+
+    ::close(mFd);
+    mFd = -1;
+}
+
+void CAmLogFileSink::rotate()
+{
+    if (isOpen())
+    {
+        closeSegment();
+    }
+
+    for (unsigned i = mNumFiles - 1; i > 0; --i)
+    {
+        const std::string from = (i == 1) ? mFilename : mFilename + "." + std::to_string(i - 1);
+        const std::string to   = mFilename + "." + std::to_string(i);
+        if ((rename(from.c_str(), to.c_str()) != 0) && (errno != ENOENT))
+        {
+            std::cerr << "CAmLogFileSink::rotate could not rename " << from << ": " << std::strerror(errno) << std::endl;
+        }
+    }
+
+    openSegment(false);
+}
+
+void CAmLogFileSink::updatePrefix()
+{
+    timespec now;
+    clock_gettime(CLOCK_REALTIME, &now);
+    const uint64_t ms = static_cast<uint64_t>(now.tv_sec) * 1000 + now.tv_nsec / 1000000;
+    if (ms == mPrefixMs)
+    {
+        return;
+    }
+
+    if (now.tv_sec != mPrefixSecond)
+    {
+        struct tm timeinfo;
+        localtime_r(&now.tv_sec, &timeinfo);
+        mPrefixLength = std::strftime(mPrefix, sizeof(mPrefix), "%D %T", &timeinfo);
+        mPrefixSecond = now.tv_sec;
+    }
+
+    // only the milliseconds change within the second
+    std::snprintf(mPrefix + mPrefixLength, sizeof(mPrefix) - mPrefixLength, ".%03u ", static_cast<unsigned>(ms % 1000));
+    mPrefixMs = ms;
+}
+
+void CAmLogFileSink::write(const char *text, const size_t length)
+{
+    if (!isOpen())
+    {
+        return;
+    }
+
+    updatePrefix();
+    const size_t prefixLength = mPrefixLength + 5;
+    if (mUsed + prefixLength + length + 1 > mSegmentSize)
+    {
+        rotate();
+        if (!isOpen())
+        {
+            return;
+        }
+    }
+
+    const size_t textLength = std::min(length, mSegmentSize - mUsed - prefixLength - 1);
+    const size_t start      = mUsed;
+    memcpy(mpSegment + mUsed, mPrefix, prefixLength);
+    mUsed += prefixLength;
+    memcpy(mpSegment + mUsed, text, textLength);
+    mUsed += textLength;
+    mpSegment[mUsed++] = '\n';
+
+    if (mSyncPolicy == SYNC_ALWAYS)
+    {
+        const size_t pageSize = sysconf(_SC_PAGESIZE);
+        const size_t pageStart = start / pageSize * pageSize;
+        msync(mpSegment + pageStart, mUsed - pageStart, MS_SYNC);
+    }
+}
+
+void CAmLogFileSink::write(const std::string &text)
+{
+    write(text.c_str(), text.size());
+}
+
+void CAmLogFileSink::sync()
+{
+    if (isOpen())
+    {
+        msync(mpSegment, mUsed, MS_SYNC);
+    }
+}
+
+} /* namespace am */
@@ -39,18 +39,29 @@
 #ifdef WITH_TIMERFD
 # include <sys/timerfd.h>
 #endif
+#ifdef WITH_IO_URING
+# include "CAmIoUring.h"
+#endif
 
 #define END_EVENT (UINT64_MAX >> 1)
 
 namespace am
 {
 
+static inline uint64_t toNanoseconds(const timespec &time)
+{
+    return (static_cast<uint64_t>(time.tv_sec) * 1000000000ULL + static_cast<uint64_t>(time.tv_nsec));
+}
+
 CAmSocketHandler::CAmSocketHandler()
     : mEventFd(-1)
     , mSignalFd(-1)
     , mDispatchDone(true)
+    , mShPollSlots()
+    , mFiredPolls()
+    , mDispatchTimeBudget(0)
+    , mDispatchCallBudget(0)
     , mSetPollKeys(MAX_POLLHANDLE)
-    , mMapShPoll()
     , mSetTimerKeys(MAX_TIMERHANDLE)
     , mListTimer()
     ,
@@ -61,9 +72,18 @@ CAmSocketHandler::CAmSocketHandler()
     mSetSignalhandlerKeys(MAX_POLLHANDLE)
     , mSignalHandlers()
     , mInternalCodes(internal_codes_e::NO_ERROR)
+    , mPostedTasks(NULL)
+    , mStatisticsEnabled(false)
+    , mStatisticsDumpTimer(0)
+    , mLoopStatistics()
+    , mPollStatistics()
+    , mTimerStatistics()
 #ifndef WITH_TIMERFD
     , mStartTime()
 #endif
+#ifdef WITH_IO_URING
+    , mIoUring()
+#endif
 {
 
     auto actionPoll = [this](const pollfd pollfd, const sh_pollHandle_t, void *){
@@ -74,18 +94,20 @@ CAmSocketHandler::CAmSocketHandler()
             {
                 if (events >= END_EVENT)
                 {
-                    for (auto &elem : mMapShPoll)
+                    for (auto &elem : mShPollSlots)
                     {
-                        if (elem.second.state == poll_states_e::UPDATE ||
-                            elem.second.state == poll_states_e::VALID)
+                        if (elem.state == poll_states_e::UPDATE ||
+                            elem.state == poll_states_e::VALID)
                         {
-                            elem.second.state = poll_states_e::ADD;
+                            elem.state = poll_states_e::ADD;
                         }
                     }
 
                     mDispatchDone = true;
                 }
 
+                // a post rings the bell only once until the tasks are taken, so run them in any case
+                runPostedTasks();
                 return;
             }
 
@@ -112,9 +134,20 @@ CAmSocketHandler::CAmSocketHandler()
 
 CAmSocketHandler::~CAmSocketHandler()
 {
-    for (const auto &it : mMapShPoll)
+    sh_post_s *post = mPostedTasks.exchange(NULL);
+    while (post)
     {
-        close(it.second.pollfdValue.fd);
+        sh_post_s *next = post->next;
+        delete post;
+        post = next;
+    }
+
+    for (const auto &elem : mShPollSlots)
+    {
+        if (elem.state != poll_states_e::FREE)
+        {
+            close(elem.pollfdValue.fd);
+        }
     }
 }
 
@@ -130,20 +163,25 @@ void CAmSocketHandler::start_listenting()
     clock_gettime(CLOCK_MONOTONIC, &mStartTime);
 #endif
     timespec buffertime;
+    uint64_t iterationStart = 0;
 
     VectorPollfd_t fdPollingArray; //!< the polling array for ppoll
 
     while (!mDispatchDone)
     {
-        /* Iterate all times through map and synchronize the polling array accordingly.
-         * In case a new element in map appears the polling array will be extended and
-         * in case an element gets removed the map and the polling array needs to be adapted.
+        dropStalePendingPolls();
+
+        /* Iterate all times through the slots and synchronize the polling array accordingly.
+         * In case a new element in the slots appears the polling array will be extended and
+         * in case an element gets removed the slot is freed and the polling array needs to be adapted.
          */
-        auto fdPollIt = fdPollingArray.begin();
-        for (auto it = mMapShPoll.begin(); it != mMapShPoll.end(); )
+        auto   fdPollIt = fdPollingArray.begin();
+        size_t numValid = 0;
+        for (size_t fd = 0; fd < mShPollSlots.size(); )
         {
             // NOTE: The order of the switch/case statement reflects the state flow
-            auto &elem = it->second;
+            // NOTE: Index based, because the prepare callback may add a new fd which grows the slots
+            auto &elem = mShPollSlots[fd];
             switch (elem.state)
             {
             case poll_states_e::ADD:
@@ -153,15 +191,22 @@ void CAmSocketHandler::start_listenting()
 
             case poll_states_e::UPDATE:
                 elem.state = poll_states_e::VALID;
-                CAmSocketHandler::prepare(elem);
+                prepare(elem);
                 *fdPollIt = elem.pollfdValue;
+#ifdef WITH_IO_URING
+                if (mIoUring)
+                {
+                    mIoUring->rearm(fd);
+                }
+#endif
                 break;
 
             case poll_states_e::VALID:
                 // check for multi-thread access
                 assert(fdPollIt != fdPollingArray.end());
                 ++fdPollIt;
-                ++it;
+                ++fd;
+                ++numValid;
                 break;
 
             case poll_states_e::REMOVE:
@@ -170,57 +215,81 @@ void CAmSocketHandler::start_listenting()
                 break;
 
             case poll_states_e::INVALID:
-                it = mMapShPoll.erase(it);
+                elem = sh_poll_s();
+                break;
+
+            case poll_states_e::FREE:
+                ++fd;
                 break;
             }
         }
 
-        if (fdPollingArray.size() != mMapShPoll.size())
+        if (fdPollingArray.size() != numValid)
         {
             mInternalCodes |= internal_codes_e::MT_ERROR;
             logError("CAmSocketHandler::start_listenting is NOT multi-thread safe!");
             return;
         }
 
+        // the list of fired polls can never be longer than the polling array
+        mFiredPolls.reserve(fdPollingArray.size());
+
 #ifndef WITH_TIMERFD
         timerCorrection();
 #endif
 
+        const uint64_t waitStart = statisticsTime();
+        addStatistic(mLoopStatistics.iteration, iterationStart, waitStart);
+
         // block until something is on a file descriptor
-        int16_t pollStatus = ppoll(&fdPollingArray[0], fdPollingArray.size(), insertTime(buffertime), NULL);
+        int16_t pollStatus = waitForEvents(fdPollingArray, insertTime(buffertime));
+
+        iterationStart = statisticsTime();
+        addStatistic(mLoopStatistics.wait, waitStart, iterationStart);
         if (pollStatus > 0)
         {
-            // stage 0+1, call firedCB
-            std::list<sh_poll_s *> listPoll;
-            for (auto &it : fdPollingArray)
+            // stage 0+1, call firedCB, one pass per priority class so the high priority ones come first.
+            // Polls still pending from the last iteration are already on the list.
+            const size_t numPending = mFiredPolls.size();
+            for (uint8_t priority = PRIORITY_HIGH; priority < PRIORITY_MAX; ++priority)
             {
-                it.revents &= it.events;
-                if (it.revents == 0)
+                for (auto &it : fdPollingArray)
                 {
-                    continue;
-                }
+                    it.revents &= it.events;
+                    if (it.revents == 0)
+                    {
+                        continue;
+                    }
 
-                sh_poll_s &pollObj = mMapShPoll.at(it.fd);
-                if (pollObj.state != poll_states_e::VALID)
-                {
-                    continue;
-                }
+                    sh_poll_s &pollObj = mShPollSlots[it.fd];
+                    if (pollObj.state != poll_states_e::VALID)
+                    {
+                        it.revents = 0;
+                        continue;
+                    }
+
+                    if (pollObj.priority != priority)
+                    {
+                        continue;
+                    }
+
+                    // ensure to copy the revents fired in fdPollingArray
+                    pollObj.pollfdValue.revents = it.revents;
+                    if (!pollObj.dispatchPending)
+                    {
+                        mFiredPolls.push_back(&pollObj);
+                    }
 
-                // ensure to copy the revents fired in fdPollingArray
-                pollObj.pollfdValue.revents = it.revents;
-                listPoll.push_back(&pollObj);
-                CAmSocketHandler::fire(pollObj);
-                it.revents = 0;
+                    fire(pollObj);
+                    it.revents = 0;
+                }
             }
 
             // stage 2, lets ask around if some dispatching is necessary, the ones who need stay on the list
-            listPoll.remove_if(CAmSocketHandler::noDispatching);
+            compactFiredPolls(&CAmSocketHandler::noDispatching, numPending);
 
-            // stage 3, the ones left need to dispatch, we do this as long as there is something to dispatch..
-            do
-            {
-                listPoll.remove_if(CAmSocketHandler::dispatchingFinished);
-            } while (!listPoll.empty());
+            // stage 3, the ones left need to dispatch
+            dispatchFiredPolls();
         }
         else if ((pollStatus < 0) && (errno != EINTR))
         {
@@ -234,6 +303,8 @@ void CAmSocketHandler::start_listenting()
             // find out the timedifference to starttime
             timerUp();
 #endif
+            // continue the dispatching which was deferred in the last iteration
+            dispatchFiredPolls();
         }
     }
 }
@@ -282,6 +353,101 @@ void CAmSocketHandler::wakeupWorker(const std::string &func, const uint64_t valu
     }
 }
 
+/**
+ * hands a task over to the mainloop, where it is called in the order of posting.
+ * The task is put on a lock free stack, the event fd is only written if the stack was empty.
+ * This method is thread safe, in contrast to all others of this class.
+ * @param task the task to be called in the mainloop context
+ * @return E_OK on success, E_NOT_POSSIBLE if the task is empty
+ */
+am_Error_e CAmSocketHandler::post(std::function<void()> task)
+{
+    if (!task)
+    {
+        return (E_NOT_POSSIBLE);
+    }
+
+    sh_post_s *post = new sh_post_s(std::move(task));
+    post->next = mPostedTasks.load(std::memory_order_relaxed);
+    while (!mPostedTasks.compare_exchange_weak(post->next, post, std::memory_order_release, std::memory_order_relaxed))
+    {
+    }
+
+    if (post->next == NULL)
+    {
+        wakeupWorker("post");
+    }
+
+    return (E_OK);
+}
+
+/**
+ * hands a task over to the mainloop, where it is called after the given delay.
+ * Thread safe, the timer is created from within the mainloop.
+ * @param delay the time to wait before calling
+ * @param task the task to be called in the mainloop context
+ * @return E_OK on success, E_NOT_POSSIBLE if the task is empty
+ */
+am_Error_e CAmSocketHandler::postDelayed(const timespec &delay, std::function<void()> task)
+{
+    if ((delay.tv_sec == 0) && (delay.tv_nsec == 0))
+    {
+        return (post(std::move(task)));
+    }
+
+    if (!task)
+    {
+        return (E_NOT_POSSIBLE);
+    }
+
+    return (post([this, delay, task]() {
+               sh_timerHandle_t timerHandle;
+               auto callback = [this, task](const sh_timerHandle_t handle, void *) {
+                       task();
+                       removeTimer(handle);
+                   };
+               if (addTimer(delay, callback, timerHandle, NULL) != E_OK)
+               {
+                   logError("CAmSocketHandler::postDelayed could not add timer, task is dropped");
+               }
+           }));
+}
+
+/**
+ * takes all posted tasks and calls them in the order they were posted.
+ * Must be called in the mainloop context.
+ */
+void CAmSocketHandler::runPostedTasks()
+{
+    sh_post_s *post = mPostedTasks.exchange(NULL, std::memory_order_acquire);
+
+    // the stack holds the newest on top, reverse it to keep the posting order
+    sh_post_s *ordered = NULL;
+    while (post)
+    {
+        sh_post_s *next = post->next;
+        post->next = ordered;
+        ordered    = post;
+        post       = next;
+    }
+
+    while (ordered)
+    {
+        sh_post_s *next = ordered->next;
+        try
+        {
+            ordered->task();
+        }
+        catch (std::exception &e)
+        {
+            logError("CAmSocketHandler::runPostedTasks Exception caught", e.what());
+        }
+
+        delete ordered;
+        ordered = next;
+    }
+}
+
 bool CAmSocketHandler::fatalErrorOccurred()
 {
     return (mInternalCodes != internal_codes_e::NO_ERROR);
@@ -421,24 +587,26 @@ am_Error_e CAmSocketHandler::addFDPoll(const int fd,
         return E_NON_EXISTENT;
     }
 
-    const auto elem = mMapShPoll.find(fd);
-    if (elem != mMapShPoll.end())
+    if (static_cast<size_t>(fd) >= mShPollSlots.size())
     {
-        // The fd was already in map therefore we need to trigger an update instead
-        switch (elem->second.state)
-        {
-        case poll_states_e::REMOVE:
-            pollData.state = poll_states_e::UPDATE;
-            break;
+        mShPollSlots.resize(fd + 1);
+    }
 
-        case poll_states_e::INVALID:
-            pollData.state = poll_states_e::ADD;
-            break;
+    switch (mShPollSlots[fd].state)
+    {
+    case poll_states_e::FREE:
+    case poll_states_e::INVALID:
+        pollData.state = poll_states_e::ADD;
+        break;
 
-        default:
-            logError("CAmSocketHandler::addFDPoll fd", fd, "already registered!");
-            return E_ALREADY_EXISTS;
-        }
+    case poll_states_e::REMOVE:
+        // The fd was already in the slots therefore we need to trigger an update instead
+        pollData.state = poll_states_e::UPDATE;
+        break;
+
+    default:
+        logError("CAmSocketHandler::addFDPoll fd", fd, "already registered!");
+        return E_ALREADY_EXISTS;
     }
 
     // create a new handle for the poll
@@ -458,8 +626,13 @@ am_Error_e CAmSocketHandler::addFDPoll(const int fd,
     pollData.dispatchCB          = dispatch;
     pollData.userData            = userData;
 
-    // add new data to the list
-    mMapShPoll[fd] = pollData;
+    // add new data to the slots
+    mShPollSlots[fd] = pollData;
+    if (mStatisticsEnabled)
+    {
+        mPollStatistics.emplace(pollData.handle, sh_poll_statistic_s());
+    }
+
     wakeupWorker("addFDPoll");
 
     handle = pollData.handle;
@@ -521,13 +694,14 @@ am::am_Error_e CAmSocketHandler::addFDPoll(const int fd, const short event, IAmS
  */
 am_Error_e CAmSocketHandler::removeFDPoll(const sh_pollHandle_t handle)
 {
-    for (auto &it : mMapShPoll)
+    for (auto &elem : mShPollSlots)
     {
-        if (it.second.handle == handle)
+        if (elem.state != poll_states_e::FREE && elem.handle == handle)
         {
-            it.second.state = (it.second.state == poll_states_e::ADD ? poll_states_e::INVALID : poll_states_e::REMOVE);
+            elem.state = (elem.state == poll_states_e::ADD ? poll_states_e::INVALID : poll_states_e::REMOVE);
             wakeupWorker("removeFDPoll");
             mSetPollKeys.pollHandles.erase(handle);
+            mPollStatistics.erase(handle);
             return E_OK;
         }
     }
@@ -625,6 +799,11 @@ am_Error_e CAmSocketHandler::addTimer(const timespec &timeouts, std::function<vo
     timerItem.userData  = userData;
 
     timerItem.handle = handle;
+    timerItem.expiry = statisticsTime();
+    if (timerItem.expiry)
+    {
+        timerItem.expiry += toNanoseconds(timeouts);
+    }
 
     // we add here the time difference between startTime and currenttime, because this time will be substracted later on in timecorrection
     timespec currentTime;
@@ -634,6 +813,11 @@ am_Error_e CAmSocketHandler::addTimer(const timespec &timeouts, std::function<vo
         timerItem.countdown = timespecAdd(timeouts, timespecSub(currentTime, mStartTime));
     }
 
+    if (mStatisticsEnabled)
+    {
+        mTimerStatistics.emplace(handle, sh_statistic_s());
+    }
+
     mListActiveTimer.push_back(timerItem);
     mListActiveTimer.sort(compareCountdown);
     return (E_OK);
@@ -655,6 +839,12 @@ am_Error_e CAmSocketHandler::addTimer(const timespec &timeouts, std::function<vo
 
     timerItem.fd       = -1;
     timerItem.userData = userData;
+    timerItem.expiry   = statisticsTime();
+    if (timerItem.expiry)
+    {
+        timerItem.expiry += toNanoseconds(timeouts);
+    }
+
     am_Error_e err = createTimeFD(timerItem.countdown, timerItem.fd);
     if (err != E_OK)
     {
@@ -682,16 +872,26 @@ am_Error_e CAmSocketHandler::addTimer(const timespec &timeouts, std::function<vo
         };
 
     err = addFDPoll(timerItem.fd, POLLIN | POLLERR, NULL, actionPoll,
-            [callback](const sh_pollHandle_t handle, void *userData) -> bool {
+            [this, callback](const sh_pollHandle_t handle, void *userData) -> bool {
+                const uint64_t start = statisticsTime();
+                const uint64_t drift = start ? timerDrift(handle, start) : 0;
                 callback(handle, userData);
+                addTimerStatistic(handle, start, drift);
                 return false;
             },
             NULL, userData, handle);
 
     if (err == E_OK)
     {
+        // timers must not be starved by dispatching polls
+        setPollPriority(handle, PRIORITY_HIGH);
         timerItem.handle = handle;
         mListTimer.push_back(timerItem);
+        if (mStatisticsEnabled)
+        {
+            mTimerStatistics.emplace(handle, sh_statistic_s());
+        }
+
         return E_OK;
     }
 
@@ -724,6 +924,7 @@ am_Error_e CAmSocketHandler::removeTimer(const sh_timerHandle_t handle)
             am_Error_e err = removeFDPoll(handle);
             close(it->fd);
             mListTimer.erase(it);
+            mTimerStatistics.erase(handle);
             return err;
         }
 
@@ -740,6 +941,7 @@ am_Error_e CAmSocketHandler::removeTimer(const sh_timerHandle_t handle)
         {
             mListTimer.erase(it);
             mSetTimerKeys.pollHandles.erase(handle);
+            mTimerStatistics.erase(handle);
             return (E_OK);
         }
 
@@ -778,6 +980,11 @@ am_Error_e CAmSocketHandler::updateTimer(const sh_timerHandle_t handle, const ti
     }
 
     it->countdown.it_value = timeouts;
+    it->expiry             = statisticsTime();
+    if (it->expiry)
+    {
+        it->expiry += toNanoseconds(timeouts);
+    }
 
     if (!fdIsValid(it->fd))
     {
@@ -805,8 +1012,14 @@ am_Error_e CAmSocketHandler::updateTimer(const sh_timerHandle_t handle, const ti
         if (it->handle == handle)
         {
             it->countdown = timeouts;
-            timerItem     = *it;
-            found         = true;
+            it->expiry    = statisticsTime();
+            if (it->expiry)
+            {
+                it->expiry += toNanoseconds(timeouts);
+            }
+
+            timerItem = *it;
+            found     = true;
             break;
         }
     }
@@ -833,6 +1046,7 @@ am_Error_e CAmSocketHandler::updateTimer(const sh_timerHandle_t handle, const ti
         if (activeIt->handle == handle)
         {
             activeIt->countdown = timeoutsCorrected;
+            activeIt->expiry    = timerItem.expiry;
             found               = true;
             break;
         }
@@ -872,6 +1086,12 @@ am_Error_e CAmSocketHandler::restartTimer(const sh_timerHandle_t handle)
         return (E_NON_EXISTENT);
     }
 
+    it->expiry = statisticsTime();
+    if (it->expiry)
+    {
+        it->expiry += toNanoseconds(it->countdown.it_value);
+    }
+
     if (!fdIsValid(it->fd))
     {
         am_Error_e err = createTimeFD(it->countdown, it->fd);
@@ -897,8 +1117,14 @@ am_Error_e CAmSocketHandler::restartTimer(const sh_timerHandle_t handle)
     {
         if (it->handle == handle)
         {
-            timerItem = *it;
-            found     = true;
+            timerItem        = *it;
+            timerItem.expiry = statisticsTime();
+            if (timerItem.expiry)
+            {
+                timerItem.expiry += toNanoseconds(timerItem.countdown);
+            }
+
+            found = true;
             break;
         }
     }
@@ -924,6 +1150,7 @@ am_Error_e CAmSocketHandler::restartTimer(const sh_timerHandle_t handle)
         if (activeIt->handle == handle)
         {
             activeIt->countdown = timerItem.countdown;
+            activeIt->expiry    = timerItem.expiry;
             found               = true;
             break;
         }
@@ -991,10 +1218,9 @@ am_Error_e CAmSocketHandler::stopTimer(const sh_timerHandle_t handle)
  */
 am_Error_e CAmSocketHandler::updateEventFlags(const sh_pollHandle_t handle, const short events)
 {
-    for (auto &it : mMapShPoll)
+    for (auto &elem : mShPollSlots)
     {
-        auto &elem = it.second;
-        if (elem.handle != handle)
+        if (elem.state == poll_states_e::FREE || elem.handle != handle)
         {
             continue;
         }
@@ -1021,6 +1247,46 @@ am_Error_e CAmSocketHandler::updateEventFlags(const sh_pollHandle_t handle, cons
     return (E_UNKNOWN);
 }
 
+/**
+ * sets the priority class of a poll, new polls have PRIORITY_NORMAL
+ * @param handle
+ * @param priority
+ * @return E_OK on success, E_UNKNOWN if the handle was not found, E_NOT_POSSIBLE for an invalid priority
+ */
+am_Error_e CAmSocketHandler::setPollPriority(const sh_pollHandle_t handle, const sh_priority_e priority)
+{
+    if (priority >= PRIORITY_MAX)
+    {
+        return (E_NOT_POSSIBLE);
+    }
+
+    for (auto &elem : mShPollSlots)
+    {
+        if (elem.state == poll_states_e::FREE || elem.handle != handle)
+        {
+            continue;
+        }
+
+        elem.priority = priority;
+        return (E_OK);
+    }
+
+    return (E_UNKNOWN);
+}
+
+/**
+ * limits the dispatching per loop iteration. Dispatch callbacks of polls with a priority lower than PRIORITY_HIGH that
+ * still want to be called when the budget is used up are resumed in the next loop iteration, after the timers.
+ * At least one dispatch callback is called per iteration.
+ * @param timeBudget the max time spent in dispatch callbacks per iteration, zero for unlimited
+ * @param callBudget the max number of dispatch calls per iteration, 0 for unlimited
+ */
+void CAmSocketHandler::setDispatchBudget(const timespec &timeBudget, const uint32_t callBudget)
+{
+    mDispatchTimeBudget = toNanoseconds(timeBudget);
+    mDispatchCallBudget = callBudget;
+}
+
 /**
  * checks if a filedescriptor is validCAmShSubstractTime
  * @param fd the filedescriptor
@@ -1063,7 +1329,9 @@ void CAmSocketHandler::timerUp()
     mListActiveTimer.erase(mListActiveTimer.begin(), it);
 
     // call the callbacks for the timers
-    std::for_each(tempList.begin(), tempList.end(), CAmSocketHandler::callTimer);
+    std::for_each(tempList.begin(), tempList.end(), [this](sh_timer_s &t){
+            callTimer(t);
+        });
 }
 
 /**
@@ -1110,7 +1378,9 @@ void CAmSocketHandler::timerCorrection()
             mListActiveTimer.erase(mListActiveTimer.begin(), it);
 
             // call the callbacks for the timers
-            std::for_each(tempList.begin(), tempList.end(), CAmSocketHandler::callTimer);
+            std::for_each(tempList.begin(), tempList.end(), [this](sh_timer_s &t){
+                    callTimer(t);
+                });
         }
     }
 }
@@ -1126,6 +1396,8 @@ void CAmSocketHandler::prepare(am::CAmSocketHandler::sh_poll_s &row)
         return;
     }
 
+    const sh_pollHandle_t handle = row.handle;
+    const uint64_t        start  = statisticsTime();
     try
     {
         row.prepareCB(row.handle, row.userData);
@@ -1134,6 +1406,8 @@ void CAmSocketHandler::prepare(am::CAmSocketHandler::sh_poll_s &row)
     {
         logError("CAmSocketHandler::prepare Exception caught", e.what());
     }
+
+    addPollStatistic(handle, STAT_PREPARE, start);
 }
 
 /**
@@ -1141,6 +1415,8 @@ void CAmSocketHandler::prepare(am::CAmSocketHandler::sh_poll_s &row)
  */
 void CAmSocketHandler::fire(const sh_poll_s &a)
 {
+    const sh_pollHandle_t handle = a.handle;
+    const uint64_t        start  = statisticsTime();
     try
     {
         a.firedCB(a.pollfdValue, a.handle, a.userData);
@@ -1149,6 +1425,8 @@ void CAmSocketHandler::fire(const sh_poll_s &a)
     {
         logError("CAmSocketHandler::fire Exception caught", e.what());
     }
+
+    addPollStatistic(handle, STAT_FIRE, start);
 }
 
 /**
@@ -1162,7 +1440,11 @@ bool CAmSocketHandler::noDispatching(const sh_poll_s *a)
         return (true);
     }
 
-    return (!a->checkCB(a->handle, a->userData));
+    const sh_pollHandle_t handle = a->handle;
+    const uint64_t        start  = statisticsTime();
+    const bool            result = a->checkCB(a->handle, a->userData);
+    addPollStatistic(handle, STAT_CHECK, start);
+    return (!result);
 }
 
 /**
@@ -1176,7 +1458,129 @@ bool CAmSocketHandler::dispatchingFinished(const sh_poll_s *a)
         return (true);
     }
 
-    return (!a->dispatchCB(a->handle, a->userData));
+    const sh_pollHandle_t handle = a->handle;
+    const uint64_t        start  = statisticsTime();
+    const bool            result = a->dispatchCB(a->handle, a->userData);
+    addPollStatistic(handle, STAT_DISPATCH, start);
+    return (!result);
+}
+
+/**
+ * removes in place all fired polls for which the predicate returns true, keeping the order
+ * of the remaining ones. The list keeps its capacity, so no allocation is done.
+ * @param predicate the stage callback, true if the poll is finished
+ */
+void CAmSocketHandler::compactFiredPolls(bool (CAmSocketHandler::*predicate)(const sh_poll_s *), const size_t first)
+{
+    size_t numLeft = first;
+    for (size_t i = first; i < mFiredPolls.size(); ++i)
+    {
+        if (!(this->*predicate)(mFiredPolls[i]))
+        {
+            mFiredPolls[numLeft++] = mFiredPolls[i];
+        }
+    }
+
+    mFiredPolls.resize(numLeft);
+}
+
+void CAmSocketHandler::dispatchFiredPolls()
+{
+    if (mFiredPolls.empty())
+    {
+        return;
+    }
+
+    // stable insertion sort by priority, the list is short and mostly sorted already
+    for (size_t i = 1; i < mFiredPolls.size(); ++i)
+    {
+        sh_poll_s *poll = mFiredPolls[i];
+        size_t     j    = i;
+        for (; j > 0 && mFiredPolls[j - 1]->priority > poll->priority; --j)
+        {
+            mFiredPolls[j] = mFiredPolls[j - 1];
+        }
+
+        mFiredPolls[j] = poll;
+    }
+
+    timespec now;
+    uint64_t start = 0;
+    if (mDispatchTimeBudget)
+    {
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        start = toNanoseconds(now);
+    }
+
+    uint32_t numCalls     = 0;
+    bool     budgetUsedUp = false;
+    while (!mFiredPolls.empty())
+    {
+        size_t numLeft = 0;
+        size_t numDone = 0;
+        for (size_t i = 0; i < mFiredPolls.size(); ++i)
+        {
+            sh_poll_s *poll = mFiredPolls[i];
+            if (!budgetUsedUp && numCalls > 0)
+            {
+                budgetUsedUp = (mDispatchCallBudget && (numCalls >= mDispatchCallBudget));
+                if (!budgetUsedUp && mDispatchTimeBudget)
+                {
+                    clock_gettime(CLOCK_MONOTONIC, &now);
+                    budgetUsedUp = ((toNanoseconds(now) - start) >= mDispatchTimeBudget);
+                }
+            }
+
+            if (budgetUsedUp && (poll->priority != PRIORITY_HIGH))
+            {
+                mFiredPolls[numLeft++] = poll;
+                continue;
+            }
+
+            ++numCalls;
+            ++numDone;
+            if (dispatchingFinished(poll))
+            {
+                poll->dispatchPending = false;
+            }
+            else
+            {
+                mFiredPolls[numLeft++] = poll;
+            }
+        }
+
+        mFiredPolls.resize(numLeft);
+        if (numDone == 0)
+        {
+            break;
+        }
+    }
+
+    for (auto poll : mFiredPolls)
+    {
+        poll->dispatchPending = true;
+    }
+}
+
+void CAmSocketHandler::dropStalePendingPolls()
+{
+    size_t numLeft = 0;
+    for (size_t i = 0; i < mFiredPolls.size(); ++i)
+    {
+        sh_poll_s *poll = mFiredPolls[i];
+
+        // a slot which was taken by a new poll has no pending flag
+        if (!poll->dispatchPending || poll->state == poll_states_e::REMOVE ||
+            poll->state == poll_states_e::INVALID || poll->state == poll_states_e::FREE)
+        {
+            poll->dispatchPending = false;
+            continue;
+        }
+
+        mFiredPolls[numLeft++] = poll;
+    }
+
+    mFiredPolls.resize(numLeft);
 }
 
 /**
@@ -1186,6 +1590,14 @@ bool CAmSocketHandler::dispatchingFinished(const sh_poll_s *a)
  */
 inline timespec *CAmSocketHandler::insertTime(timespec &buffertime)
 {
+    // deferred dispatching is continued right after the fired fds and timers are serviced
+    if (!mFiredPolls.empty())
+    {
+        buffertime.tv_sec  = 0;
+        buffertime.tv_nsec = 0;
+        return (&buffertime);
+    }
+
 #ifndef WITH_TIMERFD
     if (!mListActiveTimer.empty())
     {
@@ -1199,6 +1611,17 @@ inline timespec *CAmSocketHandler::insertTime(timespec &buffertime)
     }
 }
 
+inline int CAmSocketHandler::waitForEvents(VectorPollfd_t &fdPollingArray, const timespec *timeout)
+{
+#ifdef WITH_IO_URING
+    if (mIoUring)
+    {
+        return (mIoUring->wait(fdPollingArray, timeout));
+    }
+#endif
+    return (ppoll(&fdPollingArray[0], fdPollingArray.size(), timeout, NULL));
+}
+
 #ifdef WITH_TIMERFD
 am_Error_e CAmSocketHandler::createTimeFD(const itimerspec &timeouts, int &fd)
 {
@@ -1223,6 +1646,7 @@ am_Error_e CAmSocketHandler::createTimeFD(const itimerspec &timeouts, int &fd)
 
 void CAmSocketHandler::callTimer(sh_timer_s &a)
 {
+    const uint64_t start = statisticsTime();
     try
     {
         a.callback(a.handle, a.userData);
@@ -1231,6 +1655,8 @@ void CAmSocketHandler::callTimer(sh_timer_s &a)
     {
         logError("CAmSocketHandler::callTimer() Exception caught", e.what());
     }
+
+    addTimerStatistic(a.handle, start, (a.expiry && start > a.expiry) ? start - a.expiry : 0);
 }
 
 bool CAmSocketHandler::nextHandle(sh_identifier_s &handle)
@@ -1256,4 +1682,336 @@ bool CAmSocketHandler::nextHandle(sh_identifier_s &handle)
     return (true);
 }
 
+CAmSocketHandler::sh_statistic_s::sh_statistic_s()
+    : count(0)
+    , sum(0)
+    , min(UINT64_MAX)
+    , max(0)
+    , histogram()
+{
+}
+
+void CAmSocketHandler::sh_statistic_s::add(const uint64_t value)
+{
+    ++count;
+    sum += value;
+    min  = std::min(min, value);
+    max  = std::max(max, value);
+    ++histogram[value ? 63 - __builtin_clzll(value) : 0];
+}
+
+uint64_t CAmSocketHandler::sh_statistic_s::average() const
+{
+    return (count ? sum / count : 0);
+}
+
+/**
+ * the percentile is taken from the histogram, so the result is the upper bound of the power of two
+ * bucket the value falls into, limited by the maximum
+ */
+uint64_t CAmSocketHandler::sh_statistic_s::percentile(const uint8_t percent) const
+{
+    if (count == 0)
+    {
+        return (0);
+    }
+
+    const uint64_t target = (count * std::min<uint64_t>(percent, 100) + 99) / 100;
+    uint64_t       seen   = 0;
+    for (uint8_t i = 0; i < 64; ++i)
+    {
+        seen += histogram[i];
+        if (seen >= target)
+        {
+            const uint64_t upper = (i < 63) ? (2ULL << i) - 1 : UINT64_MAX;
+            return (std::min(max, upper));
+        }
+    }
+
+    return (max);
+}
+
+inline uint64_t CAmSocketHandler::statisticsTime() const
+{
+    if (!mStatisticsEnabled)
+    {
+        return (0);
+    }
+
+    timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (toNanoseconds(now));
+}
+
+inline void CAmSocketHandler::addStatistic(sh_statistic_s &statistic, const uint64_t start, const uint64_t end)
+{
+    if (start && end)
+    {
+        statistic.add(end - start);
+    }
+}
+
+inline void CAmSocketHandler::addPollStatistic(const sh_pollHandle_t handle, const sh_statistic_stage_e stage, const uint64_t start)
+{
+    if (!start)
+    {
+        return;
+    }
+
+    auto it = mPollStatistics.find(handle);
+    if (it != mPollStatistics.end())
+    {
+        addStatistic(it->second.stage[stage], start, statisticsTime());
+    }
+}
+
+void CAmSocketHandler::addTimerStatistic(const sh_timerHandle_t handle, const uint64_t start, const uint64_t drift)
+{
+    if (!start)
+    {
+        return;
+    }
+
+    auto it = mTimerStatistics.find(handle);
+    if (it != mTimerStatistics.end())
+    {
+        addStatistic(it->second, start, statisticsTime());
+    }
+
+    mLoopStatistics.timerDrift.add(drift);
+}
+
+#ifdef WITH_TIMERFD
+/**
+ * calculates how late the timer fired and moves the expected expiry to the next interval
+ * @param handle the timer
+ * @param now the current monotonic time in ns
+ * @return the drift in ns
+ */
+uint64_t CAmSocketHandler::timerDrift(const sh_timerHandle_t handle, const uint64_t now)
+{
+    for (auto &elem : mListTimer)
+    {
+        if (elem.handle != handle)
+        {
+            continue;
+        }
+
+        const uint64_t interval = toNanoseconds(elem.countdown.it_interval);
+        uint64_t       drift    = 0;
+        if (elem.expiry && (now > elem.expiry))
+        {
+            drift = now - elem.expiry;
+        }
+
+        if (interval)
+        {
+            // timerfd keeps the period, so the next expiry is aligned to the original one
+            const uint64_t lateness = drift % interval;
+            drift       = lateness;
+            elem.expiry = now - lateness + interval;
+        }
+
+        return (drift);
+    }
+
+    return (0);
+}
+#endif // ifdef WITH_TIMERFD
+
+am_Error_e CAmSocketHandler::setBackend(const sh_backend_e backend)
+{
+    if (!mDispatchDone)
+    {
+        logError("CAmSocketHandler::setBackend not possible while the mainloop is running");
+        return (E_NOT_POSSIBLE);
+    }
+
+#ifdef WITH_IO_URING
+    if (backend == BACKEND_PPOLL)
+    {
+        mIoUring.reset();
+        return (E_OK);
+    }
+
+    if (mIoUring)
+    {
+        return (E_OK);
+    }
+
+    std::unique_ptr<CAmIoUring> ioUring(new CAmIoUring());
+    if (!ioUring->init(256))
+    {
+        logWarning("CAmSocketHandler::setBackend io_uring is not supported, staying with ppoll");
+        return (E_NOT_POSSIBLE);
+    }
+
+    mIoUring = std::move(ioUring);
+    return (E_OK);
+#else
+    return ((backend == BACKEND_PPOLL) ? E_OK : E_NOT_POSSIBLE);
+#endif
+}
+
+CAmSocketHandler::sh_backend_e CAmSocketHandler::getBackend() const
+{
+#ifdef WITH_IO_URING
+    if (mIoUring)
+    {
+        return (BACKEND_IO_URING);
+    }
+#endif
+    return (BACKEND_PPOLL);
+}
+
+/**
+ * enables or disables the statistics of the mainloop.
+ * @param enable true to start measuring, false to stop. The collected values are kept.
+ * @param dumpInterval if not zero, the statistics are logged periodically in this interval
+ */
+void CAmSocketHandler::enableStatistics(const bool enable, const timespec &dumpInterval)
+{
+    mStatisticsEnabled = enable;
+    if (enable)
+    {
+        createStatistics();
+    }
+
+    if (mStatisticsDumpTimer)
+    {
+        removeTimer(mStatisticsDumpTimer);
+        mStatisticsDumpTimer = 0;
+    }
+
+    if (!enable || ((dumpInterval.tv_sec == 0) && (dumpInterval.tv_nsec == 0)))
+    {
+        return;
+    }
+
+    auto dump = [this](const sh_timerHandle_t handle, void *){
+            (void)handle;
+            dumpStatistics();
+#ifndef WITH_TIMERFD
+            restartTimer(handle);
+#endif
+        };
+
+    if (addTimer(dumpInterval, dump, mStatisticsDumpTimer, NULL, true) != E_OK)
+    {
+        logError("CAmSocketHandler::enableStatistics could not add the dump timer");
+        mStatisticsDumpTimer = 0;
+    }
+}
+
+/**
+ * clears all collected statistics
+ */
+void CAmSocketHandler::resetStatistics()
+{
+    mLoopStatistics = sh_loop_statistic_s();
+    mPollStatistics.clear();
+    mTimerStatistics.clear();
+    if (mStatisticsEnabled)
+    {
+        createStatistics();
+    }
+}
+
+/**
+ * creates the statistics of the polls and timers that have none yet, so measuring does not allocate.
+ * They are erased when the poll or timer is removed.
+ */
+void CAmSocketHandler::createStatistics()
+{
+    for (const auto &elem : mShPollSlots)
+    {
+        if ((elem.state != poll_states_e::FREE) && (elem.state != poll_states_e::INVALID) && (elem.state != poll_states_e::REMOVE))
+        {
+            mPollStatistics.emplace(elem.handle, sh_poll_statistic_s());
+        }
+    }
+
+    for (const auto &elem : mListTimer)
+    {
+        mTimerStatistics.emplace(elem.handle, sh_statistic_s());
+    }
+}
+
+static void logStatistic(const char *name, const uint64_t handle, const CAmSocketHandler::sh_statistic_s &statistic)
+{
+    if (statistic.count == 0)
+    {
+        return;
+    }
+
+    logInfo("CAmSocketHandler statistic", name, handle, "count", statistic.count, "min", statistic.min, "avg", statistic.average(),
+        "max", statistic.max, "p99", statistic.percentile(99), "[ns]");
+}
+
+/**
+ * logs the collected statistics
+ */
+void CAmSocketHandler::dumpStatistics()
+{
+    static const char *stageNames[STAT_MAX] = { "prepare", "fire", "check", "dispatch" };
+
+    logStatistic("loop iteration", 0, mLoopStatistics.iteration);
+    logStatistic("loop wait", 0, mLoopStatistics.wait);
+    logStatistic("timer drift", 0, mLoopStatistics.timerDrift);
+
+    for (const auto &elem : mPollStatistics)
+    {
+        for (uint8_t stage = 0; stage < STAT_MAX; ++stage)
+        {
+            logStatistic(stageNames[stage], elem.first, elem.second.stage[stage]);
+        }
+    }
+
+    for (const auto &elem : mTimerStatistics)
+    {
+        logStatistic("timer", elem.first, elem.second);
+    }
+}
+
+void CAmSocketHandler::getLoopStatistics(sh_loop_statistic_s &statistics) const
+{
+    statistics = mLoopStatistics;
+}
+
+/**
+ * returns the statistics of a poll
+ * @param handle the poll handle
+ * @param statistics the statistics
+ * @return E_OK on success, E_NON_EXISTENT if the handle is removed or the statistics were not enabled since the last reset
+ */
+am_Error_e CAmSocketHandler::getPollStatistics(const sh_pollHandle_t handle, sh_poll_statistic_s &statistics) const
+{
+    auto it = mPollStatistics.find(handle);
+    if (it == mPollStatistics.end())
+    {
+        return (E_NON_EXISTENT);
+    }
+
+    statistics = it->second;
+    return (E_OK);
+}
+
+/**
+ * returns the statistics of a timer callback
+ * @param handle the timer handle
+ * @param statistics the statistics
+ * @return E_OK on success, E_NON_EXISTENT if the handle is removed or the statistics were not enabled since the last reset
+ */
+am_Error_e CAmSocketHandler::getTimerStatistics(const sh_timerHandle_t handle, sh_statistic_s &statistics) const
+{
+    auto it = mTimerStatistics.find(handle);
+    if (it == mTimerStatistics.end())
+    {
+        return (E_NON_EXISTENT);
+    }
+
+    statistics = it->second;
+    return (E_OK);
+}
+
 }
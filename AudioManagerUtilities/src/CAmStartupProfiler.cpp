@@ -0,0 +1,218 @@
+/**
+ * SPDX license identifier: MPL-2.0
+ *
+ * Copyright (C) 2012, BMW AG
+ *
+ * This file is part of GENIVI Project AudioManager.
+ *
+ * Contributions are licensed to the GENIVI Alliance under one or more
+ * Contribution License Agreements.
+ *
+ * \copyright
+ * This Source Code Form is subject to the terms of the
+ * Mozilla Public License, v. 2.0. If a  copy of the MPL was not distributed with
+ * this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ *
+ * \file CAmStartupProfiler.cpp
+ * For further information see http://www.genivi.org/.
+ *
+ */
+
+#include "CAmStartupProfiler.h"
+#include <algorithm>
+#include <fstream>
+#include <unistd.h>
+#include "CAmDltWrapper.h"
+
+namespace am
+{
+
+CAmStartupProfiler *CAmStartupProfiler::instance()
+{
+    static CAmStartupProfiler profiler;
+    return (&profiler);
+}
+
+CAmStartupProfiler::CAmStartupProfiler()
+    : mStart(std::chrono::steady_clock::now())
+    , mPhases()
+    , mRunningStep(0)
+    , mRunningPhases(0)
+    , mReady(false)
+    , mReported(false)
+    , mTraceFile()
+    , mpSocketHandler(NULL)
+    , mDeadlineTimer(0)
+    , mDeadlineCallbackT(this, &CAmStartupProfiler::deadlineCallback)
+{
+}
+
+uint64_t CAmStartupProfiler::now() const
+{
+    return (std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - mStart).count());
+}
+
+void CAmStartupProfiler::step(const std::string &name)
+{
+    const uint64_t time(now());
+    if (mRunningStep != 0)
+    {
+        mPhases[mRunningStep - 1].end = time;
+    }
+
+    mPhases.push_back(phase_s{ name, time, 0, true });
+    mRunningStep = mPhases.size();
+}
+
+uint32_t CAmStartupProfiler::begin(const std::string &name)
+{
+    mPhases.push_back(phase_s{ name, now(), 0, false });
+    mRunningPhases++;
+    return (mPhases.size() - 1);
+}
+
+void CAmStartupProfiler::end(const uint32_t phase)
+{
+    if ((phase >= mPhases.size()) || mPhases[phase].step || (mPhases[phase].end != 0))
+    {
+        return;
+    }
+
+    mPhases[phase].end = now();
+    mRunningPhases--;
+    if (mReported)
+    {
+        logInfo("CAmStartupProfiler:", mPhases[phase].name, "ended after the report, it took", mPhases[phase].end - mPhases[phase].start, "us");
+    }
+    else if (mReady && (mRunningPhases == 0))
+    {
+        report();
+    }
+}
+
+void CAmStartupProfiler::setTraceFile(const std::string &filename)
+{
+    mTraceFile = filename;
+}
+
+void CAmStartupProfiler::ready(CAmSocketHandler *socketHandler, const uint32_t deadline)
+{
+    if (mRunningStep != 0)
+    {
+        mPhases[mRunningStep - 1].end = now();
+        mRunningStep                  = 0;
+    }
+
+    mReady = true;
+    if (mRunningPhases == 0)
+    {
+        report();
+    }
+    else if ((socketHandler != NULL) && (deadline != 0))
+    {
+        logInfo("CAmStartupProfiler: the report waits for", mRunningPhases, "running phases, at most", deadline, "ms");
+        const timespec timeout = { static_cast<time_t>(deadline / 1000), static_cast<long>(deadline % 1000) * 1000000 };
+        mpSocketHandler = socketHandler;
+        if (mpSocketHandler->addTimer(timeout, &mDeadlineCallbackT, mDeadlineTimer, NULL) != E_OK)
+        {
+            logError("CAmStartupProfiler: could not add the deadline timer");
+            mDeadlineTimer = 0;
+        }
+    }
+    else
+    {
+        logInfo("CAmStartupProfiler: the report waits for", mRunningPhases, "running phases");
+    }
+}
+
+void CAmStartupProfiler::deadlineCallback(sh_timerHandle_t handle, void *userData)
+{
+    (void)handle;
+    (void)userData;
+    mDeadlineTimer = 0;
+    logWarning("CAmStartupProfiler: the deadline passed with", mRunningPhases, "running phases");
+    report();
+}
+
+void CAmStartupProfiler::report()
+{
+    if (mReported)
+    {
+        return;
+    }
+
+    mReported = true;
+    if (mDeadlineTimer != 0)
+    {
+        mpSocketHandler->removeTimer(mDeadlineTimer);
+        mDeadlineTimer = 0;
+    }
+
+    const uint64_t reportTime(now());
+    uint64_t       ready(0);
+    for (const phase_s &phase : mPhases)
+    {
+        if (phase.end == 0)
+        {
+            logWarning("CAmStartupProfiler:", phase.name, "started at", phase.start, "us and is still open after", reportTime - phase.start, "us");
+            ready = reportTime;
+            continue;
+        }
+
+        logInfo("CAmStartupProfiler:", phase.name, "started at", phase.start, "us and took", phase.end - phase.start, "us");
+        ready = std::max(ready, phase.end);
+    }
+
+    logInfo("CAmStartupProfiler: the AudioManager was ready after", ready, "us");
+    if (!mTraceFile.empty() && !writeTrace(reportTime))
+    {
+        logError("CAmStartupProfiler: could not write the trace to", mTraceFile);
+    }
+}
+
+/**
+ * escapes a string for JSON, the names are given by the code and the plugins
+ */
+static std::string escape(const std::string &text)
+{
+    std::string escaped;
+    for (char c : text)
+    {
+        if ((c == '"') || (c == '\\'))
+        {
+            escaped += '\\';
+        }
+
+        escaped += (static_cast<unsigned char>(c) < ' ') ? ' ' : c;
+    }
+
+    return (escaped);
+}
+
+bool CAmStartupProfiler::writeTrace(const uint64_t reportTime) const
+{
+    std::ofstream file(mTraceFile.c_str());
+    if (!file)
+    {
+        return (false);
+    }
+
+    // the steps are in one row, the phases beside them in another. Open phases last until the report.
+    const pid_t pid(getpid());
+    file << "{\"traceEvents\":[";
+    for (size_t i = 0; i < mPhases.size(); i++)
+    {
+        const phase_s &phase(mPhases[i]);
+        const bool     open(phase.end == 0);
+        file << ((i == 0) ? "" : ",") << "\n{\"name\":\"" << escape(phase.name) << "\",\"ph\":\"X\",\"ts\":" << phase.start
+             << ",\"dur\":" << (open ? reportTime : phase.end) - phase.start << ",\"pid\":" << pid << ",\"tid\":" << (phase.step ? 1 : 2)
+             << (open ? ",\"args\":{\"open\":true}}" : "}");
+    }
+
+    file << "\n],\"displayTimeUnit\":\"ms\"}\n";
+    file.close();
+    return (!file.fail());
+}
+
+} /* namespace am */
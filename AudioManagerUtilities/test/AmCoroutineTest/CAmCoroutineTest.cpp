@@ -0,0 +1,196 @@
+/**
+ * SPDX license identifier: MPL-2.0
+ *
+ * Copyright (C) 2012, BMW AG
+ *
+ * This file is part of GENIVI Project AudioManager.
+ *
+ * Contributions are licensed to the GENIVI Alliance under one or more
+ * Contribution License Agreements.
+ *
+ * \copyright
+ * This Source Code Form is subject to the terms of the
+ * Mozilla Public License, v. 2.0. If a  copy of the MPL was not distributed with
+ * this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ *
+ * For further information see http://www.genivi.org/.
+ *
+ */
+
+#include <unistd.h>
+#include <pthread.h>
+#include <stdexcept>
+#include "gtest/gtest.h"
+#include "CAmSocketHandler.h"
+#include "CAmSerializer.h"
+#include "CAmCoroutine.h"
+
+using namespace am;
+
+static uint64_t monotonicMs()
+{
+    timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (now.tv_sec * 1000ull + now.tv_nsec / 1000000);
+}
+
+TAmTask<int> sleepAndAdd(CAmSocketHandler &socketHandler, const int a, const int b)
+{
+    co_await awaitTimer(socketHandler, timespec{0, 20000000});
+    co_return (a + b);
+}
+
+TAmTask<> timerFlow(CAmSocketHandler &socketHandler, int &result, uint64_t &elapsed)
+{
+    const uint64_t start = monotonicMs();
+    result = co_await sleepAndAdd(socketHandler, 1, 2);
+    result += co_await sleepAndAdd(socketHandler, 3, 4);
+    elapsed = monotonicMs() - start;
+    socketHandler.stop_listening();
+}
+
+TEST(CAmCoroutineTest, awaitTimer)
+{
+    CAmSocketHandler myHandler;
+    int result = 0;
+    uint64_t elapsed = 0;
+    timerFlow(myHandler, result, elapsed).start();
+    myHandler.start_listenting();
+
+    EXPECT_EQ(result, 10);
+    EXPECT_GE(elapsed, 40u);
+}
+
+TAmTask<> readFlow(CAmSocketHandler &socketHandler, const int fd, std::string &received)
+{
+    for (int i = 0; i < 3; i++)
+    {
+        const short revents = co_await awaitFd(socketHandler, fd);
+        char c;
+        if ((revents & POLLIN) && (read(fd, &c, 1) == 1))
+        {
+            received += c;
+        }
+    }
+    socketHandler.stop_listening();
+}
+
+TEST(CAmCoroutineTest, awaitFd)
+{
+    CAmSocketHandler myHandler;
+    int fds[2];
+    ASSERT_EQ(pipe(fds), 0);
+    std::string received;
+    readFlow(myHandler, fds[0], received).start();
+
+    sh_timerHandle_t handle;
+    int written = 0;
+    myHandler.addTimer(timespec{0, 10000000}, [&](const sh_timerHandle_t handle, void *) {
+        const char c = 'a' + written++;
+        EXPECT_EQ(write(fds[1], &c, 1), 1);
+        if (written == 3)
+        {
+            myHandler.removeTimer(handle);
+        }
+    }, handle, NULL, true);
+    myHandler.start_listenting();
+
+    EXPECT_EQ(received, "abc");
+    close(fds[0]);
+    close(fds[1]);
+}
+
+struct MainloopHopData
+{
+    V2::CAmSerializer *pSerializer;
+    pthread_t mainThread;
+    pthread_t resumedOn;
+    CAmSocketHandler *pSocketHandler;
+};
+
+TAmTask<> hopFlow(MainloopHopData &data)
+{
+    co_await awaitMainloop(*data.pSerializer);
+    data.resumedOn = pthread_self();
+    data.pSocketHandler->stop_listening();
+}
+
+void* ptHop(void* data)
+{
+    hopFlow(*static_cast<MainloopHopData*>(data)).start();
+    return (NULL);
+}
+
+TEST(CAmCoroutineTest, awaitMainloop)
+{
+    CAmSocketHandler myHandler;
+    V2::CAmSerializer serializer(&myHandler);
+    MainloopHopData data{ &serializer, pthread_self(), 0, &myHandler };
+    pthread_t thread;
+    pthread_create(&thread, NULL, ptHop, &data);
+    myHandler.start_listenting();
+    pthread_join(thread, NULL);
+
+    EXPECT_TRUE(pthread_equal(data.resumedOn, data.mainThread));
+}
+
+TAmTask<am_Error_e> ackFlow(CAmHandleAwaiter &acks, std::vector<am_Error_e> &results)
+{
+    am_Handle_s connect{ H_CONNECT, 1 };
+    am_Handle_s volume{ H_SETSINKVOLUME, 1 };
+    results.push_back(co_await acks.ack(connect));
+    results.push_back(co_await acks.ack(volume));
+    co_return (E_OK);
+}
+
+TEST(CAmCoroutineTest, awaitAck)
+{
+    CAmHandleAwaiter acks;
+    std::vector<am_Error_e> results;
+    TAmTask<am_Error_e> task = ackFlow(acks, results);
+
+    // the volume ack arrives before it is awaited and is kept, the connect ack nobody expects is dropped
+    acks.expect(am_Handle_s{ H_SETSINKVOLUME, 1 });
+    EXPECT_FALSE(acks.complete(am_Handle_s{ H_SETSINKVOLUME, 1 }, E_ABORTED));
+    EXPECT_FALSE(acks.complete(am_Handle_s{ H_CONNECT, 1 }, E_ABORTED));
+    task.start();
+    EXPECT_TRUE(results.empty());
+    EXPECT_FALSE(acks.complete(am_Handle_s{ H_CONNECT, 2 }, E_NOT_POSSIBLE));
+    EXPECT_TRUE(acks.complete(am_Handle_s{ H_CONNECT, 1 }, E_OK));
+
+    ASSERT_EQ(results.size(), 2u);
+    EXPECT_EQ(results[0], E_OK);
+    EXPECT_EQ(results[1], E_ABORTED);
+}
+
+TAmTask<int> throwing()
+{
+    throw std::runtime_error("failed");
+    co_return (0);
+}
+
+TAmTask<> catchFlow(bool &caught)
+{
+    try
+    {
+        co_await throwing();
+    }
+    catch (std::runtime_error &)
+    {
+        caught = true;
+    }
+}
+
+TEST(CAmCoroutineTest, exception)
+{
+    bool caught = false;
+    catchFlow(caught).start();
+    EXPECT_TRUE(caught);
+}
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,355 @@
+/**
+ * SPDX license identifier: MPL-2.0
+ *
+ * Copyright (C) 2012, BMW AG
+ *
+ * This file is part of GENIVI Project AudioManager.
+ *
+ * Contributions are licensed to the GENIVI Alliance under one or more
+ * Contribution License Agreements.
+ *
+ * \copyright
+ * This Source Code Form is subject to the terms of the
+ * Mozilla Public License, v. 2.0. If a  copy of the MPL was not distributed with
+ * this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ *
+ * For further information see http://www.genivi.org/.
+ *
+ */
+
+#include <fstream>
+#include <pthread.h>
+#include <unistd.h>
+#include "gtest/gtest.h"
+#include "CAmDltWrapper.h"
+
+using namespace am;
+
+static const char *LOGFILE = "/tmp/AmDltWrapperTest.log";
+
+/**
+ * reads the lines that were written since the last call
+ */
+static std::vector<std::string> newLines()
+{
+    static size_t consumed = 0;
+    std::ifstream file(LOGFILE);
+    std::vector<std::string> lines;
+    std::string line;
+    // the preallocated rest of the file is zeroed
+    for (size_t i = 0; std::getline(file, line) && (line[0] != '\0'); i++)
+    {
+        if (i >= consumed)
+        {
+            lines.push_back(line);
+        }
+    }
+
+    consumed += lines.size();
+    return (lines);
+}
+
+struct LogThreadData
+{
+    uint32_t thread;
+    uint32_t numRecords;
+};
+
+void* ptLog(void* data)
+{
+    LogThreadData *pData = (LogThreadData*) data;
+    for (uint32_t i = 0; i < pData->numRecords; i++)
+    {
+        logInfo("thread", pData->thread, "record", i);
+    }
+    return (NULL);
+}
+
+TEST(CAmDltWrapperTest, asyncFromManyThreads)
+{
+    const uint32_t numThreads = 4;
+    const uint32_t numRecords = 1000;
+    newLines();
+
+    CAmDltWrapper::instance()->enableAsyncLogging(true, 1 << 20);
+    LogThreadData threadData[numThreads];
+    pthread_t threads[numThreads];
+    for (uint32_t i = 0; i < numThreads; i++)
+    {
+        threadData[i] = LogThreadData{ i, numRecords };
+        pthread_create(&threads[i], NULL, ptLog, &threadData[i]);
+    }
+
+    for (uint32_t i = 0; i < numThreads; i++)
+    {
+        pthread_join(threads[i], NULL);
+    }
+
+    CAmDltWrapper::instance()->flush();
+
+    // every record is there, in the order of its thread
+    std::vector<uint32_t> next(numThreads, 0);
+    for (const std::string &line : newLines())
+    {
+        uint32_t thread, record;
+        ASSERT_EQ(sscanf(line.c_str() + line.find("thread"), "thread %u record %u", &thread, &record), 2) << line;
+        ASSERT_LT(thread, numThreads);
+        EXPECT_EQ(record, next[thread]);
+        next[thread] = record + 1;
+    }
+
+    for (uint32_t i = 0; i < numThreads; i++)
+    {
+        EXPECT_EQ(next[i], numRecords);
+    }
+
+    CAmDltWrapper::instance()->enableAsyncLogging(false);
+}
+
+TEST(CAmDltWrapperTest, asyncDropsWhenFull)
+{
+    newLines();
+
+    // the buffer holds a few records only, so the producer outruns the background thread
+    CAmDltWrapper::instance()->enableAsyncLogging(true, 256);
+    LogThreadData data{ 0, 10000 };
+    pthread_t thread;
+    pthread_create(&thread, NULL, ptLog, &data);
+    pthread_join(thread, NULL);
+    CAmDltWrapper::instance()->enableAsyncLogging(false);
+
+    size_t records = 0;
+    bool droppedReported = false;
+    for (const std::string &line : newLines())
+    {
+        if (line.find("log records dropped") != std::string::npos)
+        {
+            droppedReported = true;
+        }
+        else if (line.find("record") != std::string::npos)
+        {
+            records++;
+        }
+    }
+
+    EXPECT_TRUE(droppedReported);
+    EXPECT_GT(records, 0u);
+    EXPECT_LT(records, 10000u);
+}
+
+static void logAllTypes()
+{
+    int value = 0;
+    std::string temporary("temporary");
+    logInfo("format", int8_t(-8), uint16_t(16), int64_t(-64), true, E_NOT_POSSIBLE, SS_ON, temporary, &value);
+}
+
+TEST(CAmDltWrapperTest, asyncFormatsLikeSync)
+{
+    newLines();
+    logAllTypes();
+    CAmDltWrapper::instance()->enableAsyncLogging(true);
+    logAllTypes();
+    CAmDltWrapper::instance()->enableAsyncLogging(false);
+
+    std::vector<std::string> lines = newLines();
+    ASSERT_EQ(lines.size(), 2u);
+    ASSERT_NE(lines[0].find("format"), std::string::npos);
+    EXPECT_EQ(lines[0].substr(lines[0].find("format")), lines[1].substr(lines[1].find("format")));
+}
+
+static int evaluated = 0;
+
+static int countEvaluation()
+{
+    return (++evaluated);
+}
+
+TEST(CAmDltWrapperTest, levelCheckedBeforeArguments)
+{
+    newLines();
+    EXPECT_TRUE(logLevelEnabled(DLT_LOG_ERROR));
+    EXPECT_EQ(logLevelEnabled(DLT_LOG_VERBOSE), AM_COMPILED_LOG_LEVEL >= DLT_LOG_VERBOSE);
+    AM_LOG_VERBOSE("evaluated", countEvaluation());
+    EXPECT_EQ(evaluated, logLevelEnabled(DLT_LOG_VERBOSE) ? 1 : 0);
+    EXPECT_EQ(newLines().size(), static_cast<size_t>(evaluated));
+}
+
+TEST(CAmDltWrapperTest, rateLimit)
+{
+    newLines();
+    CAmDltWrapper::instance()->setRateLimit(NULL, DLT_LOG_WARN, 3, 10);
+    auto stormSite = [](const uint32_t i) { AM_LOG_WARNING("storm", i); };
+    for (uint32_t i = 0; i < 10; i++)
+    {
+        stormSite(i);
+        AM_LOG_WARNING("other site");
+        logWarning("not limited");
+    }
+
+    usleep(150000);
+    stormSite(10);
+    CAmDltWrapper::instance()->setRateLimit(NULL, DLT_LOG_WARN, 0, 0);
+
+    // each call site gets its own bucket, records without a call site are not limited
+    std::vector<std::string> lines = newLines();
+    size_t storm = 0;
+    size_t other = 0;
+    size_t unlimited = 0;
+    for (const std::string &line : lines)
+    {
+        storm += (line.find("storm") != std::string::npos) ? 1 : 0;
+        other += (line.find("other site") != std::string::npos) ? 1 : 0;
+        unlimited += (line.find("not limited") != std::string::npos) ? 1 : 0;
+    }
+
+    EXPECT_EQ(storm, 4u);
+    EXPECT_EQ(other, 3u);
+    EXPECT_EQ(unlimited, 10u);
+    ASSERT_FALSE(lines.empty());
+    EXPECT_NE(lines.back().find("similar messages suppressed:7"), std::string::npos) << lines.back();
+}
+
+TEST(CAmDltWrapperTest, syncAfterAsync)
+{
+    newLines();
+    logInfo("synchronous", 1);
+
+    std::vector<std::string> lines = newLines();
+    ASSERT_EQ(lines.size(), 1u);
+    EXPECT_NE(lines[0].find("synchronous1"), std::string::npos);
+}
+
+TEST(CAmDltWrapperTest, flightRecorder)
+{
+    const std::string dumpFile("/tmp/AmDltWrapperTest.flightrecorder");
+    CAmDltWrapper::instance()->enableFlightRecorder(4096, DLT_LOG_DEBUG);
+    for (uint32_t i = 0; i < 1000; i++)
+    {
+        logDebug("recorded", i, E_NOT_POSSIBLE);
+    }
+
+    logVerbose("not recorded");
+    ASSERT_TRUE(CAmDltWrapper::instance()->dumpFlightRecorder(dumpFile));
+    CAmDltWrapper::instance()->enableFlightRecorder(0);
+    newLines();
+
+    // the ring keeps the newest records only
+    std::ifstream file(dumpFile);
+    std::string line;
+    std::vector<uint32_t> records;
+    while (std::getline(file, line))
+    {
+        EXPECT_NE(line.find("[DEF] [Dbug] recorded"), std::string::npos) << line;
+        EXPECT_NE(line.find("E_NOT_POSSIBLE"), std::string::npos) << line;
+        uint32_t record;
+        ASSERT_EQ(sscanf(line.c_str() + line.find("recorded"), "recorded %u", &record), 1) << line;
+        records.push_back(record);
+    }
+
+    ASSERT_GT(records.size(), 10u);
+    EXPECT_LT(records.size(), 1000u);
+    for (size_t i = 0; i < records.size(); i++)
+    {
+        EXPECT_EQ(records[i], 1000 - records.size() + i);
+    }
+}
+
+TEST(CAmDltWrapperTest, flightRecorderFromManyThreads)
+{
+    const std::string dumpFile("/tmp/AmDltWrapperTest.flightrecorder");
+    const uint32_t numThreads = 4;
+    CAmDltWrapper::instance()->enableFlightRecorder(4096, DLT_LOG_INFO);
+    LogThreadData threadData[numThreads];
+    pthread_t threads[numThreads];
+    for (uint32_t i = 0; i < numThreads; i++)
+    {
+        threadData[i] = LogThreadData{ i, 1000 };
+        pthread_create(&threads[i], NULL, ptLog, &threadData[i]);
+    }
+
+    for (uint32_t i = 0; i < numThreads; i++)
+    {
+        pthread_join(threads[i], NULL);
+    }
+
+    // a record that does not fit is cut off after the last complete argument
+    logInfo("long", std::string(1000, 'x'), "end");
+    ASSERT_TRUE(CAmDltWrapper::instance()->dumpFlightRecorder(dumpFile));
+    CAmDltWrapper::instance()->enableFlightRecorder(0);
+    newLines();
+
+    std::ifstream file(dumpFile);
+    std::string line;
+    std::vector<int64_t> last(numThreads, -1);
+    uint32_t numLines = 0;
+    while (std::getline(file, line))
+    {
+        numLines++;
+        if (line.find("long") != std::string::npos)
+        {
+            EXPECT_EQ(line.find("end"), std::string::npos) << line;
+            EXPECT_EQ(line.substr(line.size() - 10), std::string(10, 'x'));
+            continue;
+        }
+
+        uint32_t thread, record;
+        ASSERT_EQ(sscanf(line.c_str() + line.find("thread"), "thread %u record %u", &thread, &record), 2) << line;
+        ASSERT_LT(thread, numThreads);
+        EXPECT_GT(static_cast<int64_t>(record), last[thread]);
+        last[thread] = record;
+    }
+
+    EXPECT_GT(numLines, 10u);
+}
+
+TEST(CAmDltWrapperTest, fileRotation)
+{
+    const std::string filename("/tmp/AmLogFileSinkTest.log");
+    for (const char *suffix : { "", ".1", ".2", ".3" })
+    {
+        unlink((filename + suffix).c_str());
+    }
+
+    CAmLogFileSink sink;
+    ASSERT_TRUE(sink.open(filename, 4096, 3, CAmLogFileSink::SYNC_ON_ROTATE));
+    const std::string text(50, 'x');
+    for (uint32_t i = 0; i < 200; i++)
+    {
+        sink.write(std::to_string(i) + text);
+    }
+
+    sink.close();
+
+    // the oldest lines are gone, the newest are complete and in order
+    EXPECT_EQ(access((filename + ".3").c_str(), F_OK), -1);
+    std::vector<std::string> lines;
+    for (const char *suffix : { ".2", ".1", "" })
+    {
+        std::ifstream file(filename + suffix);
+        ASSERT_TRUE(file.is_open()) << suffix;
+        std::string line;
+        while (std::getline(file, line))
+        {
+            lines.push_back(line);
+        }
+    }
+
+    ASSERT_GT(lines.size(), 100u);
+    EXPECT_LT(lines.size(), 200u);
+    const size_t first = 200 - lines.size();
+    for (size_t i = 0; i < lines.size(); i++)
+    {
+        // date time.ms text
+        ASSERT_EQ(lines[i].substr(lines[i].find(' ', lines[i].find(' ') + 1) + 1), std::to_string(first + i) + text);
+        EXPECT_EQ(lines[i][17], '.');
+    }
+}
+
+int main(int argc, char **argv)
+{
+    CAmDltWrapper::instanctiateOnce("TEST", "CAmDltWrapperTest", true, CAmDltWrapper::FILE_OUT, LOGFILE);
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,122 @@
+/**
+ * SPDX license identifier: MPL-2.0
+ *
+ * Copyright (C) 2012, BMW AG
+ *
+ * This file is part of GENIVI Project AudioManager.
+ *
+ * Contributions are licensed to the GENIVI Alliance under one or more
+ * Contribution License Agreements.
+ *
+ * \copyright
+ * This Source Code Form is subject to the terms of the
+ * Mozilla Public License, v. 2.0. If a  copy of the MPL was not distributed with
+ * this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ *
+ * For further information see http://www.genivi.org/.
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "gtest/gtest.h"
+#include "TAmPluginTemplate.h"
+#include "CAmTestPlugin.h"
+
+using namespace am;
+using namespace testing;
+
+/**
+ * a plugin directory with the test plugins as links, a library which is not one and a file which is no library
+ */
+class CAmPluginTemplateTest : public ::testing::Test
+{
+public:
+    std::string mDirectory;
+    std::vector<std::string> mFiles;
+
+    void SetUp()
+    {
+        char directory[] = "/tmp/amPluginTestXXXXXX";
+        ASSERT_TRUE(mkdtemp(directory) != NULL);
+        mDirectory = directory;
+
+        // created out of order, readdir does not sort either
+        link("libTestPluginB.so", PLUGIN_DIRECTORY "/libTestPluginB.so");
+        link("libTestPluginA.so", PLUGIN_DIRECTORY "/libTestPluginA.so");
+        write("libBroken.so", "this is no shared library");
+        write("readme.txt", "this is no shared library either");
+    }
+
+    void TearDown()
+    {
+        for (const std::string &file : mFiles)
+        {
+            unlink(file.c_str());
+        }
+
+        rmdir(mDirectory.c_str());
+    }
+
+    void link(const std::string &name, const std::string &target)
+    {
+        mFiles.push_back(mDirectory + "/" + name);
+        ASSERT_EQ(symlink(target.c_str(), mFiles.back().c_str()), 0);
+    }
+
+    void write(const std::string &name, const std::string &content)
+    {
+        mFiles.push_back(mDirectory + "/" + name);
+        std::ofstream file(mFiles.back().c_str());
+        file << content;
+    }
+
+};
+
+TEST_F(CAmPluginTemplateTest, sortedOrder)
+{
+    std::vector<std::string> listLibraries(findPluginLibraries(std::vector<std::string>(1, mDirectory)));
+    std::vector<std::string> listExpected;
+    listExpected.push_back(mDirectory + "/libBroken.so");
+    listExpected.push_back(mDirectory + "/libTestPluginA.so");
+    listExpected.push_back(mDirectory + "/libTestPluginB.so");
+    EXPECT_EQ(listLibraries, listExpected);
+}
+
+TEST_F(CAmPluginTemplateTest, brokenLibraryIsSkipped)
+{
+    std::vector<std::string> listLibraries(findPluginLibraries(std::vector<std::string>(1, mDirectory)));
+    std::vector<pluginLibrary_s<IAmTestPlugin> > listOpened(openPluginLibraries<IAmTestPlugin>(listLibraries, 3));
+    ASSERT_EQ(listOpened.size(), 3u);
+
+    EXPECT_EQ(listOpened[0].libname, mDirectory + "/libBroken.so");
+    EXPECT_TRUE(listOpened[0].libraryHandle == NULL);
+    EXPECT_TRUE(listOpened[0].createFunction == NULL);
+    EXPECT_TRUE(createPlugin(listOpened[0]) == NULL);
+
+    // the static initializers ran on the calling thread and not in the pool
+    const char *names[] = { "TestPluginA", "TestPluginB" };
+    for (size_t i = 1; i < listOpened.size(); i++)
+    {
+        EXPECT_EQ(listOpened[i].libname, listLibraries[i]);
+        ASSERT_TRUE(listOpened[i].libraryHandle != NULL);
+        IAmTestPlugin *plugin = createPlugin(listOpened[i]);
+        ASSERT_TRUE(plugin != NULL);
+        EXPECT_EQ(plugin->getName(), names[i - 1]);
+        EXPECT_EQ(plugin->getLoadThread(), std::this_thread::get_id());
+        delete plugin;
+        dlclose(listOpened[i].libraryHandle);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,50 @@
+/**
+ * SPDX license identifier: MPL-2.0
+ *
+ * Copyright (C) 2012, BMW AG
+ *
+ * This file is part of GENIVI Project AudioManager.
+ *
+ * Contributions are licensed to the GENIVI Alliance under one or more
+ * Contribution License Agreements.
+ *
+ * \copyright
+ * This Source Code Form is subject to the terms of the
+ * Mozilla Public License, v. 2.0. If a  copy of the MPL was not distributed with
+ * this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ *
+ * For further information see http://www.genivi.org/.
+ *
+ */
+
+#include "CAmTestPlugin.h"
+
+#define STRINGIFY(name)       #name
+#define NAME(name)            STRINGIFY(name)
+#define CONCAT(first, second) first##second
+#define FACTORY(name)         CONCAT(name, Factory)
+
+using namespace am;
+
+static const std::thread::id loadThread(std::this_thread::get_id());
+
+class CAmTestPlugin : public IAmTestPlugin
+{
+public:
+    std::string getName() const
+    {
+        return (NAME(PLUGIN_NAME));
+    }
+
+    std::thread::id getLoadThread() const
+    {
+        return (loadThread);
+    }
+
+};
+
+extern "C" IAmTestPlugin *FACTORY(PLUGIN_NAME)()
+{
+    return (new CAmTestPlugin());
+}
@@ -0,0 +1,46 @@
+/**
+ * SPDX license identifier: MPL-2.0
+ *
+ * Copyright (C) 2012, BMW AG
+ *
+ * This file is part of GENIVI Project AudioManager.
+ *
+ * Contributions are licensed to the GENIVI Alliance under one or more
+ * Contribution License Agreements.
+ *
+ * \copyright
+ * This Source Code Form is subject to the terms of the
+ * Mozilla Public License, v. 2.0. If a  copy of the MPL was not distributed with
+ * this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ *
+ * For further information see http://www.genivi.org/.
+ *
+ */
+
+#ifndef TESTPLUGIN_H_
+#define TESTPLUGIN_H_
+
+#include <string>
+#include <thread>
+
+namespace am
+{
+
+/**
+ * the interface of the plugins which are loaded by the test
+ */
+class IAmTestPlugin
+{
+public:
+    virtual ~IAmTestPlugin()
+    {
+    }
+
+    virtual std::string getName() const = 0;
+    virtual std::thread::id getLoadThread() const = 0; //!< the thread which ran the static initializers
+};
+
+}
+
+#endif /* TESTPLUGIN_H_ */
@@ -21,6 +21,8 @@
  */
 
 #include <cstdio>
+#include <atomic>
+#include <thread>
 #include <sys/socket.h>
 #include <arpa/inet.h>
 #include <sys/ioctl.h>
@@ -33,6 +35,7 @@
 #include "CAmSocketHandler.h"
 #include "CAmSerializer.h"
 #include "CAmSerializerTest.h"
+#include "../CAmAllocationCounter.h"
 
 using namespace testing;
 using namespace am;
@@ -202,6 +205,505 @@ TEST(CAmSerializerTest, asyncTest)
     pthread_join(serThread, NULL);
 }
 
+struct SerializerBurstData
+{
+    V2::CAmSerializer *pSerializer;
+    uint32_t producer;
+    uint32_t numCalls;
+    std::vector<uint32_t> *pLastSequence;
+    uint32_t *pNumCalls;
+    bool *pInOrder;
+};
+
+void* ptSerializerBurst(void* data)
+{
+    SerializerBurstData *pData = (SerializerBurstData*) data;
+    for (uint32_t sequence = 1; sequence <= pData->numCalls; sequence++)
+    {
+        pData->pSerializer->asyncInvocation(std::bind([](SerializerBurstData *pBurst, const uint32_t sequence)
+        {
+            // runs in the mainloop, so no locking is needed
+            if ((*pBurst->pLastSequence)[pBurst->producer] + 1 != sequence)
+            {
+                *pBurst->pInOrder = false;
+            }
+            (*pBurst->pLastSequence)[pBurst->producer] = sequence;
+            (*pBurst->pNumCalls)++;
+        }, pData, sequence));
+    }
+    return (NULL);
+}
+
+TEST(CAmSerializerTest, burstFromManyThreads)
+{
+    const uint32_t numThreads = 4;
+    const uint32_t numCalls = 20000;
+
+    CAmSocketHandler myHandler;
+    // smaller than a burst, so the producers have to wait for the mainloop
+    V2::CAmSerializer serializer(&myHandler, 1024);
+
+    std::vector<uint32_t> lastSequence(numThreads, 0);
+    uint32_t calls = 0;
+    bool inOrder = true;
+    SerializerBurstData burstData[numThreads];
+    pthread_t threads[numThreads];
+    for (uint32_t i = 0; i < numThreads; i++)
+    {
+        burstData[i] = SerializerBurstData{ &serializer, i, numCalls, &lastSequence, &calls, &inOrder };
+        pthread_create(&threads[i], NULL, ptSerializerBurst, &burstData[i]);
+    }
+
+    sh_timerHandle_t handle;
+    myHandler.addTimer(timespec{0, 10000000}, [&](const sh_timerHandle_t handle, void *) {
+        if (calls == numThreads * numCalls)
+        {
+            myHandler.stop_listening();
+        }
+        else
+        {
+            myHandler.restartTimer(handle);
+        }
+    }, handle, NULL, true);
+
+    myHandler.start_listenting();
+
+    for (uint32_t i = 0; i < numThreads; i++)
+    {
+        pthread_join(threads[i], NULL);
+    }
+
+    EXPECT_EQ(calls, numThreads * numCalls);
+    EXPECT_TRUE(inOrder);
+    EXPECT_EQ(serializer.getListDelegatePointers(), 0u);
+}
+
+struct SerializerConcurrentData
+{
+    V2::CAmSerializer *pSerializer;
+    uint32_t producer;
+    uint32_t numCalls;
+    uint32_t *pSum;
+    bool failed;
+};
+
+void* ptSerializerConcurrentSync(void* data)
+{
+    SerializerConcurrentData *pData = (SerializerConcurrentData*) data;
+    for (uint32_t i = 0; i < pData->numCalls; i++)
+    {
+        const uint32_t value = pData->producer * pData->numCalls + i;
+        uint32_t result = 0;
+        pData->pSerializer->syncInvocation(std::bind([](uint32_t *pSum, const uint32_t value)
+        {
+            *pSum += value;
+            return (value * 2);
+        }, pData->pSum, value), result);
+
+        std::future<uint32_t> future = pData->pSerializer->asyncInvocationWithResult(std::bind([](const uint32_t value)
+        {
+            return (value + 1);
+        }, value));
+
+        if ((result != value * 2) || (future.get() != value + 1))
+        {
+            pData->failed = true;
+        }
+    }
+    return (NULL);
+}
+
+TEST(CAmSerializerTest, concurrentSyncCalls)
+{
+    const uint32_t numThreads = 8;
+    const uint32_t numCalls = 1000;
+
+    CAmSocketHandler myHandler;
+    V2::CAmSerializer serializer(&myHandler);
+    uint32_t sum = 0;
+    SerializerConcurrentData concurrentData[numThreads];
+    pthread_t threads[numThreads];
+    for (uint32_t i = 0; i < numThreads; i++)
+    {
+        concurrentData[i] = SerializerConcurrentData{ &serializer, i, numCalls, &sum, false };
+        pthread_create(&threads[i], NULL, ptSerializerConcurrentSync, &concurrentData[i]);
+    }
+
+    const uint32_t total = numThreads * numCalls;
+    sh_timerHandle_t handle;
+    myHandler.addTimer(timespec{0, 10000000}, [&](const sh_timerHandle_t handle, void *) {
+        if (sum == total * (total - 1) / 2)
+        {
+            myHandler.stop_listening();
+        }
+        else
+        {
+            myHandler.restartTimer(handle);
+        }
+    }, handle, NULL, true);
+
+    myHandler.start_listenting();
+
+    for (uint32_t i = 0; i < numThreads; i++)
+    {
+        pthread_join(threads[i], NULL);
+        EXPECT_FALSE(concurrentData[i].failed);
+    }
+}
+
+TEST(CAmSerializerTest, asyncCallWithResult)
+{
+    MockIAmSerializerCb serCb;
+    CAmSocketHandler myHandler;
+    V2::CAmSerializer serializer(&myHandler);
+
+    EXPECT_CALL(serCb,checkInt()).WillOnce(Return(100));
+    EXPECT_CALL(serCb,check()).Times(1);
+    std::future<int> intResult = serializer.asyncCallWithResult(&serCb, &MockIAmSerializerCb::checkInt);
+    std::future<void> voidResult = serializer.asyncCallWithResult(&serCb, &MockIAmSerializerCb::check);
+    EXPECT_EQ(intResult.wait_for(std::chrono::seconds(0)), std::future_status::timeout);
+
+    // the results are there once the mainloop dispatched the calls
+    serializer.asyncInvocation(std::bind([&]()
+    {   myHandler.stop_listening();}));
+    myHandler.start_listenting();
+
+    EXPECT_EQ(intResult.get(), 100);
+    voidResult.get();
+}
+
+TEST(CAmSerializerTest, overflowPolicies)
+{
+    CAmSocketHandler myHandler;
+    V2::CAmSerializer serializer(&myHandler, 4);
+    std::vector<uint32_t> called;
+    auto record = [](std::vector<uint32_t> *pCalled, const uint32_t value)
+    {
+        pCalled->push_back(value);
+    };
+    auto runOnce = [&]()
+    {
+        sh_timerHandle_t handle;
+        myHandler.addTimer(timespec{0, 10000000}, [&](const sh_timerHandle_t, void *) {
+            myHandler.stop_listening();
+        }, handle, NULL);
+        myHandler.start_listenting();
+    };
+
+    // the mainloop does not run, so the ring fills up
+    serializer.setOverflowPolicy(V2::CAmSerializer::OVERFLOW_DROP);
+    ASSERT_EQ(serializer.getCapacity(), 4u);
+    for (uint32_t i = 0; i < 10; i++)
+    {
+        serializer.asyncInvocation(std::bind(record, &called, i));
+    }
+    std::future<void> dropped = serializer.asyncInvocationWithResult(std::bind([]()
+    {}));
+    EXPECT_THROW(dropped.get(), std::future_error);
+
+    runOnce();
+    EXPECT_EQ(called, std::vector<uint32_t>({ 0, 1, 2, 3 }));
+
+    V2::CAmSerializer::statistic_s statistics;
+    serializer.getStatistics(statistics);
+    EXPECT_EQ(statistics.enqueued, 4u);
+    EXPECT_EQ(statistics.dispatched, 4u);
+    EXPECT_EQ(statistics.dropped, 7u);
+    EXPECT_EQ(statistics.highWaterMark, 4u);
+    EXPECT_EQ(statistics.latency.count, 4u);
+
+    // the latest call per key survives, a parked call is not overtaken by a newer one with the same key
+    serializer.resetStatistics();
+    serializer.setOverflowPolicy(V2::CAmSerializer::OVERFLOW_COALESCE);
+    called.clear();
+    for (uint32_t i = 0; i < 10; i++)
+    {
+        serializer.asyncCoalescedInvocation(i % 2, std::bind(record, &called, i));
+    }
+    serializer.asyncCoalescedInvocation(2, std::bind(record, &called, 100));
+
+    runOnce();
+    EXPECT_EQ(called, std::vector<uint32_t>({ 0, 1, 2, 3, 8, 9, 100 }));
+    serializer.getStatistics(statistics);
+    EXPECT_EQ(statistics.enqueued, 7u);
+    EXPECT_EQ(statistics.dispatched, 7u);
+    EXPECT_EQ(statistics.coalesced, 4u);
+    EXPECT_EQ(statistics.dropped, 0u);
+    EXPECT_EQ(statistics.highWaterMark, 7u);
+    EXPECT_EQ(serializer.getListDelegatePointers(), 0u);
+}
+
+TEST(CAmSerializerTest, coalescingFromManyThreads)
+{
+    const uint32_t numThreads = 4;
+    const uint32_t numKeys = 4;
+    const uint32_t numValues = 20000;
+
+    CAmSocketHandler myHandler;
+    V2::CAmSerializer serializer(&myHandler, 8);
+    serializer.setOverflowPolicy(V2::CAmSerializer::OVERFLOW_COALESCE);
+    std::vector<uint32_t> lastValue(numThreads * numKeys, 0);
+    uint32_t overtaken = 0;
+    // a slow mainloop lets the producers fill the ring again while it is emptied
+    auto record = [&](const uint32_t key, const uint32_t value)
+    {
+        usleep(20);
+        if (value < lastValue[key])
+        {
+            overtaken++;
+        }
+        lastValue[key] = value;
+    };
+
+    // every thread sends increasing values for keys of its own, so the order of each key is defined
+    std::atomic<uint32_t> finished(0);
+    std::vector<std::thread> producers;
+    for (uint32_t t = 0; t < numThreads; t++)
+    {
+        producers.emplace_back([&, t]()
+        {
+            for (uint32_t value = 0; value < numValues; value++)
+            {
+                const uint32_t key = t * numKeys + value % numKeys;
+                serializer.asyncCoalescedInvocation(key, std::bind(record, key, value));
+            }
+            finished++;
+        });
+    }
+
+    sh_timerHandle_t handle;
+    myHandler.addTimer(timespec{0, 1000000}, [&](const sh_timerHandle_t handle, void *) {
+        if ((finished == numThreads) && (serializer.getListDelegatePointers() == 0))
+        {
+            myHandler.stop_listening();
+        }
+        else
+        {
+            myHandler.restartTimer(handle);
+        }
+    }, handle, NULL, true);
+    myHandler.start_listenting();
+    for (std::thread &producer : producers)
+    {
+        producer.join();
+    }
+
+    EXPECT_EQ(overtaken, 0u);
+    for (uint32_t key = 0; key < numThreads * numKeys; key++)
+    {
+        EXPECT_EQ(lastValue[key], numValues - numKeys + key % numKeys) << "key " << key;
+    }
+}
+
+TEST(CAmSerializerTest, overflowBlocks)
+{
+    CAmSocketHandler myHandler;
+    V2::CAmSerializer serializer(&myHandler, 4);
+    std::atomic<uint32_t> called(0);
+    std::atomic<uint32_t> sent(0);
+    auto count = [](std::atomic<uint32_t> *pCalled)
+    {
+        (*pCalled)++;
+    };
+
+    // the mainloop can not wait for itself, the call is dropped and a sync call is made directly
+    for (uint32_t i = 0; i < 5; i++)
+    {
+        serializer.asyncInvocation(std::bind(count, &called));
+    }
+    serializer.syncInvocation(std::bind(count, &called));
+    EXPECT_EQ(called, 1u);
+
+    V2::CAmSerializer::statistic_s statistics;
+    serializer.getStatistics(statistics);
+    EXPECT_EQ(statistics.dropped, 1u);
+
+    // another thread sleeps until the mainloop made room
+    std::thread producer([&]()
+    {
+        for (uint32_t i = 0; i < 4; i++)
+        {
+            serializer.asyncInvocation(std::bind(count, &called));
+            sent++;
+        }
+    });
+    usleep(50000);
+    EXPECT_EQ(sent, 0u);
+
+    sh_timerHandle_t handle;
+    myHandler.addTimer(timespec{0, 1000000}, [&](const sh_timerHandle_t handle, void *) {
+        if (called == 9)
+        {
+            myHandler.stop_listening();
+        }
+        else
+        {
+            myHandler.restartTimer(handle);
+        }
+    }, handle, NULL, true);
+    myHandler.start_listenting();
+    producer.join();
+
+    EXPECT_EQ(sent, 4u);
+    EXPECT_EQ(called, 9u);
+    EXPECT_EQ(serializer.getListDelegatePointers(), 0u);
+}
+
+TEST(CAmSerializerTest, destroyQueuedCalls)
+{
+    CAmSocketHandler myHandler;
+    std::shared_ptr<uint32_t> captured = std::make_shared<uint32_t>(0);
+    {
+        // the mainloop does not run, the calls are still queued when the serializer goes
+        V2::CAmSerializer serializer(&myHandler, 16, 4);
+        for (uint32_t i = 0; i < 8; i++)
+        {
+            serializer.asyncInvocation(std::bind([](std::shared_ptr<uint32_t> pValue)
+            {
+                (*pValue)++;
+            }, captured));
+        }
+        EXPECT_EQ(captured.use_count(), 9);
+    }
+
+    EXPECT_EQ(captured.use_count(), 1);
+    EXPECT_EQ(*captured, 0u);
+}
+
+struct SerializerPoolData
+{
+    V2::CAmSerializer *pSerializer;
+    uint32_t numCalls;
+    uint32_t *pNumCalls;
+};
+
+void* ptSerializerPool(void* data)
+{
+    SerializerPoolData *pData = (SerializerPoolData*) data;
+    for (uint32_t i = 0; i < pData->numCalls; i++)
+    {
+        pData->pSerializer->asyncInvocation(std::bind([](uint32_t *pNumCalls, const uint32_t value)
+        {
+            (void) value;
+            (*pNumCalls)++;
+        }, pData->pNumCalls, i));
+    }
+    return (NULL);
+}
+
+TEST(CAmSerializerTest, noAllocationWithinPool)
+{
+    const uint32_t poolSize = 64;
+    const uint32_t numThreads = 4;
+    const uint32_t numRounds = 3;
+
+    CAmSocketHandler myHandler;
+    V2::CAmSerializer serializer(&myHandler, 1024, poolSize);
+    uint32_t calls = 0;
+    uint32_t expectedCalls = 0;
+    uint32_t round = 0;
+    uint64_t allocationsStart = 0;
+    uint64_t allocations[numRounds] = {};
+    SerializerPoolData poolData[numThreads];
+    pthread_t threads[numThreads];
+
+    // the rounds run inside the mainloop, so only the calls and their dispatch are counted.
+    // The pool blocks come back after the dispatch, so every round fits into the pool again.
+    sh_timerHandle_t handle;
+    myHandler.addTimer(timespec{0, 1000000}, [&](const sh_timerHandle_t handle, void *) {
+        if (calls != expectedCalls)
+        {
+            myHandler.restartTimer(handle);
+            return;
+        }
+
+        if (round != 0)
+        {
+            allocations[round - 1] = gAllocationCount - allocationsStart;
+        }
+
+        if (round == numRounds)
+        {
+            myHandler.stop_listening();
+            return;
+        }
+
+        round++;
+        expectedCalls += poolSize;
+        allocationsStart = gAllocationCount;
+        for (uint32_t i = 0; i < numThreads; i++)
+        {
+            poolData[i] = SerializerPoolData{ &serializer, poolSize / numThreads, &calls };
+            pthread_create(&threads[i], NULL, ptSerializerPool, &poolData[i]);
+        }
+
+        for (uint32_t i = 0; i < numThreads; i++)
+        {
+            pthread_join(threads[i], NULL);
+        }
+
+        myHandler.restartTimer(handle);
+    }, handle, NULL, true);
+
+    myHandler.start_listenting();
+
+    EXPECT_EQ(round, numRounds);
+    EXPECT_EQ(calls, poolSize * numRounds);
+    for (uint32_t i = 0; i < numRounds; i++)
+    {
+        EXPECT_EQ(allocations[i], 0u) << "round " << i;
+    }
+    EXPECT_EQ(serializer.getListDelegatePointers(), 0u);
+}
+
+TEST(CAmSerializerTest, throughput)
+{
+    const uint32_t totalCalls = 160000;
+    const uint32_t producers[] = { 1, 4, 16 };
+
+    for (const uint32_t numThreads : producers)
+    {
+        CAmSocketHandler myHandler;
+        V2::CAmSerializer serializer(&myHandler);
+        uint32_t calls = 0;
+        std::vector<SerializerPoolData> throughputData(numThreads);
+        std::vector<pthread_t> threads(numThreads);
+
+        sh_timerHandle_t handle;
+        myHandler.addTimer(timespec{0, 1000000}, [&](const sh_timerHandle_t handle, void *) {
+            if (calls == totalCalls)
+            {
+                myHandler.stop_listening();
+            }
+            else
+            {
+                myHandler.restartTimer(handle);
+            }
+        }, handle, NULL, true);
+
+        timespec start, end;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        for (uint32_t i = 0; i < numThreads; i++)
+        {
+            throughputData[i] = SerializerPoolData{ &serializer, totalCalls / numThreads, &calls };
+            pthread_create(&threads[i], NULL, ptSerializerPool, &throughputData[i]);
+        }
+
+        myHandler.start_listenting();
+        clock_gettime(CLOCK_MONOTONIC, &end);
+
+        for (uint32_t i = 0; i < numThreads; i++)
+        {
+            pthread_join(threads[i], NULL);
+        }
+
+        const double seconds = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+        std::cout << numThreads << " producer(s): " << static_cast<uint64_t>(totalCalls / seconds) << " calls/sec" << std::endl;
+        EXPECT_EQ(calls, totalCalls);
+        EXPECT_EQ(serializer.getListDelegatePointers(), 0u);
+    }
+}
+
 int main(int argc, char **argv)
 {
     ::testing::InitGoogleTest(&argc, argv);
@@ -34,6 +34,7 @@
 #include <sys/eventfd.h>
 #include "CAmDltWrapper.h"
 #include "CAmSocketHandler.h"
+#include "../CAmAllocationCounter.h"
 
 
 #undef ENABLED_SOCKETHANDLER_TEST_OUTPUT
@@ -83,7 +84,11 @@ CAmSocketHandlerTest::~CAmSocketHandlerTest()
 
 void CAmSocketHandlerTest::SetUp()
 {
-
+    CAmSocketHandler handler;
+    if (handler.setBackend(GetParam()) != E_OK)
+    {
+        GTEST_SKIP() << "the backend is not available";
+    }
 }
 
 void CAmSocketHandlerTest::TearDown()
@@ -312,7 +317,7 @@ void* threadCallbackUnixSocketAndTimers(void* data)
     return sendTestData(sock, (struct sockaddr*)&servAddr, sizeof(servAddr), 500000);
 }
 
-TEST(CAmSocketHandlerTest, stressTestUnixSocketAndTimers)
+TEST_P(CAmSocketHandlerTest, stressTestUnixSocketAndTimers)
 {
 
     pthread_t serverThread;
@@ -320,6 +325,7 @@ TEST(CAmSocketHandlerTest, stressTestUnixSocketAndTimers)
     int socket_;
 
     CAmSocketHandler myHandler;
+    ASSERT_EQ(myHandler.setBackend(GetParam()), E_OK);
     ASSERT_FALSE(myHandler.fatalErrorOccurred());
     CAmSamplePluginStressTest::sockType_e type = CAmSamplePlugin::UNIX;
     CAmSamplePluginStressTest myplugin(&myHandler, type);
@@ -350,9 +356,10 @@ TEST(CAmSocketHandlerTest, stressTestUnixSocketAndTimers)
 }
 
 
-TEST(CAmSocketHandlerTest, fdTest)
+TEST_P(CAmSocketHandlerTest, fdTest)
 {
     CAmSocketHandler myHandler;
+    ASSERT_EQ(myHandler.setBackend(GetParam()), E_OK);
     ASSERT_FALSE(myHandler.fatalErrorOccurred());
 
     // for some simple fd tests
@@ -387,9 +394,408 @@ TEST(CAmSocketHandlerTest, fdTest)
     ASSERT_FALSE(myHandler.fatalErrorOccurred());
 }
 
-TEST(CAmSocketHandlerTest, timersOneshot)
+TEST_P(CAmSocketHandlerTest, noAllocationOnWakeup)
+{
+    CAmSocketHandler myHandler;
+    ASSERT_EQ(myHandler.setBackend(GetParam()), E_OK);
+    ASSERT_FALSE(myHandler.fatalErrorOccurred());
+
+    const uint32_t warmupWakeups = 10;
+    const uint32_t countedWakeups = 100;
+    uint32_t wakeups = 0;
+    uint64_t allocationsStart = 0;
+    uint64_t allocationsEnd = 0;
+    bool pendingDispatch = false;
+
+    // the fd triggers itself again, so every loop iteration is one wakeup
+    int fd = eventfd(1, EFD_NONBLOCK);
+    ASSERT_GT(fd, -1);
+
+    auto fired = [&](const pollfd pfd, const sh_pollHandle_t, void *) {
+        uint64_t value;
+        if (read(pfd.fd, &value, sizeof(value)) != sizeof(value))
+        {
+            return;
+        }
+
+        ++wakeups;
+        if (wakeups == warmupWakeups)
+        {
+            allocationsStart = gAllocationCount;
+        }
+        else if (wakeups == warmupWakeups + countedWakeups)
+        {
+            allocationsEnd = gAllocationCount;
+            myHandler.stop_listening();
+            return;
+        }
+
+        value = 1;
+        ASSERT_EQ(write(pfd.fd, &value, sizeof(value)), (ssize_t)sizeof(value));
+    };
+    auto check = [&](const sh_pollHandle_t, void *) -> bool {
+        pendingDispatch = true;
+        return true;
+    };
+    auto dispatch = [&](const sh_pollHandle_t, void *) -> bool {
+        // dispatch twice to pass the dispatch stage more than once
+        pendingDispatch = !pendingDispatch;
+        return !pendingDispatch;
+    };
+
+    sh_pollHandle_t handle;
+    ASSERT_EQ(myHandler.addFDPoll(fd, POLLIN, NULL, fired, check, dispatch, NULL, handle), E_OK);
+
+    myHandler.start_listenting();
+
+    ASSERT_FALSE(myHandler.fatalErrorOccurred());
+    ASSERT_EQ(wakeups, warmupWakeups + countedWakeups);
+    EXPECT_EQ(allocationsEnd - allocationsStart, 0u);
+
+    myHandler.removeFDPoll(handle);
+}
+
+void* postFromThread(void* data)
+{
+    std::function<void(uint32_t)> *postTask = static_cast<std::function<void(uint32_t)> *>(data);
+    for (uint32_t i = 0; i < SOCKET_TEST_LOOPS_COUNT * 20; i++)
+    {
+        (*postTask)(i);
+    }
+
+    return (NULL);
+}
+
+TEST_P(CAmSocketHandlerTest, postFromThreads)
+{
+    CAmSocketHandler myHandler;
+    ASSERT_EQ(myHandler.setBackend(GetParam()), E_OK);
+    ASSERT_FALSE(myHandler.fatalErrorOccurred());
+
+    const uint32_t numThreads = 4;
+    const uint32_t numPosts = numThreads * SOCKET_TEST_LOOPS_COUNT * 20;
+    uint32_t numCalls = 0;
+    std::map<pthread_t, uint32_t> lastSequence;
+    bool inOrder = true;
+    std::chrono::time_point<std::chrono::high_resolution_clock> delayedStart, delayedEnd;
+
+    std::function<void(uint32_t)> postTask = [&](uint32_t sequence) {
+        pthread_t producer = pthread_self();
+        ASSERT_EQ(myHandler.post([&, producer, sequence]() {
+            // called in mainloop context only, no locking needed
+            auto last = lastSequence.find(producer);
+            if (last != lastSequence.end() && last->second + 1 != sequence)
+            {
+                inOrder = false;
+            }
+
+            lastSequence[producer] = sequence;
+            if (++numCalls == numPosts)
+            {
+                delayedStart = std::chrono::high_resolution_clock::now();
+                myHandler.postDelayed(timespec{0, 50000000}, [&]() {
+                    delayedEnd = std::chrono::high_resolution_clock::now();
+                    myHandler.stop_listening();
+                });
+            }
+        }), E_OK);
+    };
+
+    ASSERT_EQ(myHandler.post(std::function<void()>()), E_NOT_POSSIBLE);
+
+    pthread_t threads[numThreads];
+    for (uint32_t i = 0; i < numThreads; i++)
+    {
+        pthread_create(&threads[i], NULL, postFromThread, &postTask);
+    }
+
+    myHandler.start_listenting();
+
+    for (uint32_t i = 0; i < numThreads; i++)
+    {
+        pthread_join(threads[i], NULL);
+    }
+
+    ASSERT_FALSE(myHandler.fatalErrorOccurred());
+    EXPECT_EQ(numCalls, numPosts);
+    EXPECT_TRUE(inOrder);
+    EXPECT_GE(std::chrono::duration_cast<std::chrono::milliseconds>(delayedEnd - delayedStart).count(), 50);
+}
+
+TEST_P(CAmSocketHandlerTest, pollPriorities)
+{
+    CAmSocketHandler myHandler;
+    ASSERT_EQ(myHandler.setBackend(GetParam()), E_OK);
+    ASSERT_FALSE(myHandler.fatalErrorOccurred());
+
+    std::vector<int> fds;
+    std::vector<sh_pollHandle_t> handles;
+    std::vector<int> fireOrder, dispatchOrder;
+    for (int i = 0; i < 3; i++)
+    {
+        int fd = eventfd(1, EFD_NONBLOCK | EFD_CLOEXEC);
+        ASSERT_GT(fd, 0);
+        sh_pollHandle_t handle;
+        ASSERT_EQ(myHandler.addFDPoll(fd, POLLIN, NULL,
+            [&, i](const pollfd pollfd, const sh_pollHandle_t, void *) {
+                uint64_t value;
+                read(pollfd.fd, &value, sizeof(value));
+                fireOrder.push_back(i);
+            },
+            [](const sh_pollHandle_t, void *) {
+                return (true);
+            },
+            [&, i](const sh_pollHandle_t, void *) {
+                dispatchOrder.push_back(i);
+                if (dispatchOrder.size() == 3)
+                {
+                    myHandler.stop_listening();
+                }
+
+                return (false);
+            }, NULL, handle), E_OK);
+        fds.push_back(fd);
+        handles.push_back(handle);
+    }
+
+    // the fds are polled in ascending order, the priorities in reverse
+    ASSERT_EQ(myHandler.setPollPriority(handles[0], CAmSocketHandler::PRIORITY_LOW), E_OK);
+    ASSERT_EQ(myHandler.setPollPriority(handles[2], CAmSocketHandler::PRIORITY_HIGH), E_OK);
+    ASSERT_EQ(myHandler.setPollPriority(handles[1], CAmSocketHandler::PRIORITY_MAX), E_NOT_POSSIBLE);
+    ASSERT_EQ(myHandler.setPollPriority(0, CAmSocketHandler::PRIORITY_HIGH), E_UNKNOWN);
+
+    myHandler.start_listenting();
+
+    std::vector<int> expected = { 2, 1, 0 };
+    EXPECT_EQ(fireOrder, expected);
+    EXPECT_EQ(dispatchOrder, expected);
+
+    for (auto fd : fds)
+    {
+        close(fd);
+    }
+}
+
+TEST_P(CAmSocketHandlerTest, timerFairnessUnderDispatchFlood)
+{
+    CAmSocketHandler myHandler;
+    ASSERT_EQ(myHandler.setBackend(GetParam()), E_OK);
+    ASSERT_FALSE(myHandler.fatalErrorOccurred());
+
+    // a chatty source which always has more to dispatch, without a budget the timers would starve
+    int fd = eventfd(1, EFD_NONBLOCK | EFD_CLOEXEC);
+    ASSERT_GT(fd, 0);
+    uint32_t        numDispatches = 0;
+    sh_pollHandle_t pollHandle;
+    ASSERT_EQ(myHandler.addFDPoll(fd, POLLIN, NULL,
+        [](const pollfd pollfd, const sh_pollHandle_t, void *) {
+            uint64_t value;
+            read(pollfd.fd, &value, sizeof(value));
+        },
+        [](const sh_pollHandle_t, void *) {
+            return (true);
+        },
+        [&](const sh_pollHandle_t, void *) {
+            numDispatches++;
+            usleep(10);
+            return (true);
+        }, NULL, pollHandle), E_OK);
+    ASSERT_EQ(myHandler.setPollPriority(pollHandle, CAmSocketHandler::PRIORITY_LOW), E_OK);
+
+    myHandler.setDispatchBudget(timespec{0, 1000000}, 50);
+
+    const uint32_t numTimerCalls = 10;
+    uint32_t       timerCalls    = 0;
+    long           maxLatency    = 0;
+    auto           expected      = std::chrono::steady_clock::now() + std::chrono::milliseconds(20);
+    sh_timerHandle_t timerHandle;
+    ASSERT_EQ(myHandler.addTimer(timespec{0, 20000000}, [&](const sh_timerHandle_t handle, void *) {
+            auto now = std::chrono::steady_clock::now();
+            maxLatency = std::max(maxLatency, static_cast<long>(std::chrono::duration_cast<std::chrono::microseconds>(now - expected).count()));
+            expected = now + std::chrono::milliseconds(20);
+            if (++timerCalls == numTimerCalls)
+            {
+                myHandler.stop_listening();
+            }
+            else
+            {
+                myHandler.restartTimer(handle);
+            }
+        }, timerHandle, NULL), E_OK);
+
+    myHandler.start_listenting();
+
+    EXPECT_EQ(timerCalls, numTimerCalls);
+    EXPECT_GT(numDispatches, numTimerCalls);
+    EXPECT_LT(maxLatency, 15000);
+    close(fd);
+}
+
+TEST(CAmSocketHandlerBackendTest, ioUringBackend)
+{
+    CAmSocketHandler myHandler;
+    ASSERT_FALSE(myHandler.fatalErrorOccurred());
+    EXPECT_EQ(myHandler.getBackend(), CAmSocketHandler::BACKEND_PPOLL);
+
+    if (myHandler.setBackend(CAmSocketHandler::BACKEND_IO_URING) != E_OK)
+    {
+        // not built with io_uring or not supported by the kernel, the fallback has to work
+        EXPECT_EQ(myHandler.getBackend(), CAmSocketHandler::BACKEND_PPOLL);
+    }
+    else
+    {
+        EXPECT_EQ(myHandler.getBackend(), CAmSocketHandler::BACKEND_IO_URING);
+    }
+
+    int fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    ASSERT_GT(fd, 0);
+
+    // a fd that stays readable has to be reported again until it is read, like with ppoll
+    uint32_t        numFired = 0;
+    sh_pollHandle_t pollHandle;
+    ASSERT_EQ(myHandler.addFDPoll(fd, POLLIN, NULL,
+        [&](const pollfd pollfd, const sh_pollHandle_t, void *) {
+            if (++numFired == 3)
+            {
+                uint64_t value;
+                read(pollfd.fd, &value, sizeof(value));
+            }
+        }, NULL, NULL, NULL, pollHandle), E_OK);
+
+    uint32_t         numTimer = 0;
+    sh_timerHandle_t timerHandle;
+    ASSERT_EQ(myHandler.addTimer(timespec{0, 50000000}, [&](const sh_timerHandle_t handle, void *) {
+            numTimer++;
+            if (numTimer == 1)
+            {
+                uint64_t value = 1;
+                write(fd, &value, sizeof(value));
+                myHandler.restartTimer(handle);
+            }
+            else
+            {
+                myHandler.stop_listening();
+            }
+        }, timerHandle, NULL), E_OK);
+
+    myHandler.start_listenting();
+    EXPECT_EQ(numFired, 3u);
+    EXPECT_EQ(numTimer, 2u);
+
+    // changing the events and exchanging the fd behind the same number
+    ASSERT_EQ(myHandler.updateEventFlags(pollHandle, POLLIN | POLLOUT), E_OK);
+    ASSERT_EQ(myHandler.removeFDPoll(pollHandle), E_OK);
+    close(fd);
+    fd = eventfd(1, EFD_NONBLOCK | EFD_CLOEXEC);
+    ASSERT_GT(fd, 0);
+    ASSERT_EQ(myHandler.addFDPoll(fd, POLLIN, NULL,
+        [&](const pollfd pollfd, const sh_pollHandle_t, void *) {
+            uint64_t value;
+            read(pollfd.fd, &value, sizeof(value));
+            myHandler.stop_listening();
+        }, NULL, NULL, NULL, pollHandle), E_OK);
+
+    myHandler.start_listenting();
+    EXPECT_EQ(myHandler.setBackend(CAmSocketHandler::BACKEND_PPOLL), E_OK);
+    EXPECT_EQ(myHandler.getBackend(), CAmSocketHandler::BACKEND_PPOLL);
+    close(fd);
+}
+
+TEST_P(CAmSocketHandlerTest, statistics)
+{
+    CAmSocketHandler myHandler;
+    ASSERT_EQ(myHandler.setBackend(GetParam()), E_OK);
+    ASSERT_FALSE(myHandler.fatalErrorOccurred());
+
+    CAmSocketHandler::sh_statistic_s statistic;
+    for (uint64_t value = 1; value <= 100; value++)
+    {
+        statistic.add(value * 1000);
+    }
+
+    EXPECT_EQ(statistic.count, 100u);
+    EXPECT_EQ(statistic.min, 1000u);
+    EXPECT_EQ(statistic.max, 100000u);
+    EXPECT_EQ(statistic.average(), 50500u);
+    EXPECT_GE(statistic.percentile(99), 99000u);
+    EXPECT_LE(statistic.percentile(99), statistic.max);
+    EXPECT_LE(statistic.percentile(50), 65535u);
+
+    int fd = eventfd(1, EFD_NONBLOCK | EFD_CLOEXEC);
+    ASSERT_GT(fd, 0);
+
+    const uint32_t  numWakeups = 20;
+    uint32_t        numFired   = 0;
+    sh_pollHandle_t pollHandle;
+    ASSERT_EQ(myHandler.addFDPoll(fd, POLLIN, NULL,
+        [&](const pollfd pollfd, const sh_pollHandle_t, void *) {
+            uint64_t value;
+            read(pollfd.fd, &value, sizeof(value));
+            usleep(100);
+            if (++numFired < numWakeups)
+            {
+                value = 1;
+                write(pollfd.fd, &value, sizeof(value));
+            }
+        },
+        [](const sh_pollHandle_t, void *) {
+            return (true);
+        },
+        [](const sh_pollHandle_t, void *) {
+            return (false);
+        }, NULL, pollHandle), E_OK);
+
+    sh_timerHandle_t timerHandle;
+    ASSERT_EQ(myHandler.addTimer(timespec{0, 100000000}, [&](const sh_timerHandle_t, void *) {
+            myHandler.stop_listening();
+        }, timerHandle, NULL), E_OK);
+
+    CAmSocketHandler::sh_poll_statistic_s pollStatistic;
+    EXPECT_EQ(myHandler.getPollStatistics(pollHandle, pollStatistic), E_NON_EXISTENT);
+
+    myHandler.enableStatistics(true, timespec{0, 20000000});
+    myHandler.start_listenting();
+    myHandler.enableStatistics(false);
+    myHandler.dumpStatistics();
+
+    ASSERT_EQ(myHandler.getPollStatistics(pollHandle, pollStatistic), E_OK);
+    EXPECT_EQ(pollStatistic.stage[CAmSocketHandler::STAT_FIRE].count, numWakeups);
+    EXPECT_EQ(pollStatistic.stage[CAmSocketHandler::STAT_CHECK].count, numWakeups);
+    EXPECT_EQ(pollStatistic.stage[CAmSocketHandler::STAT_DISPATCH].count, numWakeups);
+    EXPECT_EQ(pollStatistic.stage[CAmSocketHandler::STAT_PREPARE].count, 0u);
+    EXPECT_GE(pollStatistic.stage[CAmSocketHandler::STAT_FIRE].min, 100000u);
+
+    ASSERT_EQ(myHandler.getTimerStatistics(timerHandle, statistic), E_OK);
+    EXPECT_EQ(statistic.count, 1u);
+
+    CAmSocketHandler::sh_loop_statistic_s loopStatistic;
+    myHandler.getLoopStatistics(loopStatistic);
+    EXPECT_GE(loopStatistic.wait.count, 1u);
+    EXPECT_GE(loopStatistic.timerDrift.count, 1u);
+    EXPECT_GE(loopStatistic.wait.sum, 50000000u);
+
+    myHandler.resetStatistics();
+    EXPECT_EQ(myHandler.getPollStatistics(pollHandle, pollStatistic), E_NON_EXISTENT);
+    myHandler.getLoopStatistics(loopStatistic);
+    EXPECT_EQ(loopStatistic.wait.count, 0u);
+
+    // the statistics exist while measuring is enabled and go away with their poll or timer
+    myHandler.enableStatistics(true);
+    ASSERT_EQ(myHandler.getPollStatistics(pollHandle, pollStatistic), E_OK);
+    EXPECT_EQ(pollStatistic.stage[CAmSocketHandler::STAT_FIRE].count, 0u);
+    ASSERT_EQ(myHandler.getTimerStatistics(timerHandle, statistic), E_OK);
+    ASSERT_EQ(myHandler.removeFDPoll(pollHandle), E_OK);
+    ASSERT_EQ(myHandler.removeTimer(timerHandle), E_OK);
+    EXPECT_EQ(myHandler.getPollStatistics(pollHandle, pollStatistic), E_NON_EXISTENT);
+    EXPECT_EQ(myHandler.getTimerStatistics(timerHandle, statistic), E_NON_EXISTENT);
+    myHandler.enableStatistics(false);
+    close(fd);
+}
+
+TEST_P(CAmSocketHandlerTest, timersOneshot)
 {
     CAmSocketHandler myHandler;
+    ASSERT_EQ(myHandler.setBackend(GetParam()), E_OK);
     ASSERT_FALSE(myHandler.fatalErrorOccurred());
     timespec timeoutTime;
     timeoutTime.tv_sec = 1;
@@ -429,9 +835,10 @@ TEST(CAmSocketHandlerTest, timersOneshot)
     myHandler.start_listenting();
 }
 
-TEST(CAmSocketHandlerTest, timersStop)
+TEST_P(CAmSocketHandlerTest, timersStop)
 {
     CAmSocketHandler myHandler;
+    ASSERT_EQ(myHandler.setBackend(GetParam()), E_OK);
     ASSERT_FALSE(myHandler.fatalErrorOccurred());
     timespec timeoutTime;
     timeoutTime.tv_sec = 1;
@@ -471,9 +878,10 @@ TEST(CAmSocketHandlerTest, timersStop)
     myHandler.start_listenting();
 }
 
-TEST(CAmSocketHandlerTest, timersGeneral)
+TEST_P(CAmSocketHandlerTest, timersGeneral)
 {
     CAmSocketHandler myHandler;
+    ASSERT_EQ(myHandler.setBackend(GetParam()), E_OK);
     ASSERT_FALSE(myHandler.fatalErrorOccurred());
 
     timespec timeoutTime;
@@ -514,9 +922,10 @@ TEST(CAmSocketHandlerTest, timersGeneral)
     myHandler.start_listenting();
 }
 
-TEST(CAmSocketHandlerTest, timersStressTest)
+TEST_P(CAmSocketHandlerTest, timersStressTest)
 {
     CAmSocketHandler myHandler;
+    ASSERT_EQ(myHandler.setBackend(GetParam()), E_OK);
     ASSERT_FALSE(myHandler.fatalErrorOccurred());
 
     sh_timerHandle_t handle;
@@ -580,9 +989,10 @@ TEST(CAmSocketHandlerTest, timersStressTest)
 }
 
 
-TEST(CAmSocketHandlerTest,playWithTimers)
+TEST_P(CAmSocketHandlerTest, playWithTimers)
 {
     CAmSocketHandler myHandler;
+    ASSERT_EQ(myHandler.setBackend(GetParam()), E_OK);
     ASSERT_FALSE(myHandler.fatalErrorOccurred());
     timespec timeoutTime, timeout2, timeout3, timeout4;
     timeoutTime.tv_sec = 1;
@@ -639,10 +1049,11 @@ TEST(CAmSocketHandlerTest,playWithTimers)
 
 
 
-TEST(CAmSocketHandlerTest, signalHandlerPrimaryPlusSecondary)
+TEST_P(CAmSocketHandlerTest, signalHandlerPrimaryPlusSecondary)
 {
     pMockSignalHandler = new MockIAmSignalHandler;
     CAmSocketHandler myHandler;
+    ASSERT_EQ(myHandler.setBackend(GetParam()), E_OK);
     ASSERT_FALSE(myHandler.fatalErrorOccurred());
     ASSERT_EQ(myHandler.listenToSignals({SIGHUP}), E_OK);
     ASSERT_EQ(myHandler.listenToSignals({SIGHUP, SIGTERM, SIGCHLD}), E_OK);
@@ -710,13 +1121,14 @@ TEST(CAmSocketHandlerTest, signalHandlerPrimaryPlusSecondary)
    delete pMockSignalHandler;
 }
 
-TEST(CAmSocketHandlerTest,playWithUNIXSockets)
+TEST_P(CAmSocketHandlerTest, playWithUNIXSockets)
 {
     pthread_t serverThread;
     struct sockaddr_un servAddr;
     int socket_;
 
     CAmSocketHandler myHandler;
+    ASSERT_EQ(myHandler.setBackend(GetParam()), E_OK);
     ASSERT_FALSE(myHandler.fatalErrorOccurred());
     CAmSamplePlugin::sockType_e type = CAmSamplePlugin::UNIX;
     CAmSamplePlugin myplugin(&myHandler, type);
@@ -740,12 +1152,13 @@ TEST(CAmSocketHandlerTest,playWithUNIXSockets)
     shutdown(socket_, SHUT_RDWR);
 }
 
-TEST(CAmSocketHandlerTest,playWithSockets)
+TEST_P(CAmSocketHandlerTest, playWithSockets)
 {
     pthread_t serverThread;
     int socket_;
 
     CAmSocketHandler myHandler;
+    ASSERT_EQ(myHandler.setBackend(GetParam()), E_OK);
     ASSERT_FALSE(myHandler.fatalErrorOccurred());
     CAmSamplePlugin::sockType_e type = CAmSamplePlugin::INET;
     CAmSamplePlugin myplugin(&myHandler, type);
@@ -768,6 +1181,11 @@ TEST(CAmSocketHandlerTest,playWithSockets)
     shutdown(socket_, SHUT_RDWR);
 }
 
+INSTANTIATE_TEST_SUITE_P(Backends, CAmSocketHandlerTest, ::testing::Values(CAmSocketHandler::BACKEND_PPOLL, CAmSocketHandler::BACKEND_IO_URING),
+    [](const ::testing::TestParamInfo<CAmSocketHandler::sh_backend_e> &info) {
+        return ((info.param == CAmSocketHandler::BACKEND_PPOLL) ? std::string("ppoll") : std::string("io_uring"));
+    });
+
 int main(int argc, char **argv)
 {
     ::testing::InitGoogleTest(&argc, argv);
@@ -218,7 +218,10 @@ namespace am
         TAmShTimerCallBack<CAmTimerMeasurment> pTimerCallback;
     };
 
-    class CAmSocketHandlerTest: public ::testing::Test
+    /**
+     * runs each test with every backend of the mainloop, the ones that are not available are skipped
+     */
+    class CAmSocketHandlerTest: public ::testing::TestWithParam<CAmSocketHandler::sh_backend_e>
     {
     public:
         CAmSocketHandlerTest();
@@ -0,0 +1,237 @@
+/**
+ * SPDX license identifier: MPL-2.0
+ *
+ * Copyright (C) 2012, BMW AG
+ *
+ * This file is part of GENIVI Project AudioManager.
+ *
+ * Contributions are licensed to the GENIVI Alliance under one or more
+ * Contribution License Agreements.
+ *
+ * \copyright
+ * This Source Code Form is subject to the terms of the
+ * Mozilla Public License, v. 2.0. If a  copy of the MPL was not distributed with
+ * this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ *
+ * For further information see http://www.genivi.org/.
+ *
+ */
+
+#include "CAmStartupProfilerTest.h"
+#include <stdlib.h>
+#include <unistd.h>
+#include <fstream>
+#include <sstream>
+
+using namespace am;
+using namespace testing;
+
+CAmStartupProfilerTest::CAmStartupProfilerTest() :
+        mProfiler(), mTraceFile()
+{
+}
+
+CAmStartupProfilerTest::~CAmStartupProfilerTest()
+{
+}
+
+void CAmStartupProfilerTest::SetUp()
+{
+    char filename[] = "/tmp/amStartupTraceXXXXXX";
+    int fd = mkstemp(filename);
+    ASSERT_NE(fd, -1);
+    close(fd);
+    mTraceFile = filename;
+    mProfiler.setTraceFile(mTraceFile);
+}
+
+void CAmStartupProfilerTest::TearDown()
+{
+    unlink(mTraceFile.c_str());
+}
+
+size_t CAmStartupProfilerTest::getNumPhases() const
+{
+    return (mProfiler.mPhases.size());
+}
+
+std::string CAmStartupProfilerTest::getName(const uint32_t phase) const
+{
+    return (mProfiler.mPhases.at(phase).name);
+}
+
+uint64_t CAmStartupProfilerTest::getStart(const uint32_t phase) const
+{
+    return (mProfiler.mPhases.at(phase).start);
+}
+
+uint64_t CAmStartupProfilerTest::getEnd(const uint32_t phase) const
+{
+    return (mProfiler.mPhases.at(phase).end);
+}
+
+bool CAmStartupProfilerTest::isStep(const uint32_t phase) const
+{
+    return (mProfiler.mPhases.at(phase).step);
+}
+
+uint32_t CAmStartupProfilerTest::getRunningPhases() const
+{
+    return (mProfiler.mRunningPhases);
+}
+
+bool CAmStartupProfilerTest::isReported() const
+{
+    return (mProfiler.mReported);
+}
+
+bool CAmStartupProfilerTest::hasDeadline() const
+{
+    return (mProfiler.mDeadlineTimer != 0);
+}
+
+std::string CAmStartupProfilerTest::readTrace() const
+{
+    std::ifstream file(mTraceFile.c_str());
+    std::ostringstream text;
+    text << file.rdbuf();
+    return (text.str());
+}
+
+static size_t countOf(const std::string &text, const std::string &pattern)
+{
+    size_t count = 0;
+    for (size_t pos = text.find(pattern); pos != std::string::npos; pos = text.find(pattern, pos + 1))
+    {
+        count++;
+    }
+    return (count);
+}
+
+TEST_F(CAmStartupProfilerTest, phaseBookkeeping)
+{
+    mProfiler.step("first");
+    mProfiler.step("second");
+    uint32_t phase = mProfiler.begin("plugin");
+    EXPECT_EQ(phase, 2u);
+    EXPECT_EQ(getRunningPhases(), 1u);
+    usleep(1000);
+
+    // steps, unknown phases and phases that already ended can not be ended
+    mProfiler.end(0);
+    mProfiler.end(42);
+    mProfiler.end(phase);
+    const uint64_t end = getEnd(phase);
+    mProfiler.end(phase);
+    EXPECT_EQ(getEnd(phase), end);
+    EXPECT_EQ(getRunningPhases(), 0u);
+    EXPECT_GE(getEnd(phase) - getStart(phase), 1000u);
+
+    // a step ends when the next one starts, the last one with ready
+    EXPECT_EQ(getEnd(0), getStart(1));
+    EXPECT_EQ(getEnd(1), 0u);
+    EXPECT_FALSE(isReported());
+    mProfiler.ready();
+    EXPECT_NE(getEnd(1), 0u);
+    EXPECT_TRUE(isReported());
+
+    ASSERT_EQ(getNumPhases(), 3u);
+    EXPECT_EQ(getName(0), "first");
+    EXPECT_EQ(getName(2), "plugin");
+    EXPECT_TRUE(isStep(0));
+    EXPECT_TRUE(isStep(1));
+    EXPECT_FALSE(isStep(2));
+}
+
+TEST_F(CAmStartupProfilerTest, reportWaitsForPhases)
+{
+    mProfiler.step("startup");
+    uint32_t first = mProfiler.begin("first plugin");
+    uint32_t second = mProfiler.begin("second plugin");
+    mProfiler.ready();
+    EXPECT_FALSE(isReported());
+    mProfiler.end(second);
+    EXPECT_FALSE(isReported());
+    mProfiler.end(first);
+    EXPECT_TRUE(isReported());
+}
+
+TEST_F(CAmStartupProfilerTest, traceJson)
+{
+    mProfiler.step("step \"quoted\"\\");
+    uint32_t phase = mProfiler.begin("plugin\tready");
+    mProfiler.end(phase);
+    mProfiler.ready();
+
+    std::ostringstream pid;
+    pid << getpid();
+    std::ostringstream step;
+    step << "{\"name\":\"step \\\"quoted\\\"\\\\\",\"ph\":\"X\",\"ts\":" << getStart(0) << ",\"dur\":" << getEnd(0) - getStart(0)
+         << ",\"pid\":" << pid.str() << ",\"tid\":1}";
+    std::ostringstream plugin;
+    plugin << "{\"name\":\"plugin ready\",\"ph\":\"X\",\"ts\":" << getStart(1) << ",\"dur\":" << getEnd(1) - getStart(1)
+           << ",\"pid\":" << pid.str() << ",\"tid\":2}";
+    EXPECT_EQ(readTrace(), "{\"traceEvents\":[\n" + step.str() + ",\n" + plugin.str() + "\n],\"displayTimeUnit\":\"ms\"}\n");
+}
+
+TEST_F(CAmStartupProfilerTest, deadlineReportsOpenPhases)
+{
+    CAmSocketHandler socketHandler;
+    mProfiler.step("startup");
+    uint32_t ready = mProfiler.begin("ready plugin");
+    uint32_t open = mProfiler.begin("open plugin");
+    mProfiler.end(ready);
+    mProfiler.ready(&socketHandler, 20);
+    EXPECT_FALSE(isReported());
+
+    sh_timerHandle_t handle;
+    socketHandler.addTimer(timespec{0, 200000000}, [&](const sh_timerHandle_t, void *) {
+        socketHandler.stop_listening();
+    }, handle, NULL);
+    socketHandler.start_listenting();
+    EXPECT_TRUE(isReported());
+    EXPECT_FALSE(hasDeadline());
+
+    // only the open phase is marked, it lasts until the report
+    const std::string trace(readTrace());
+    EXPECT_EQ(countOf(trace, "\"ph\":\"X\""), 3u);
+    EXPECT_EQ(countOf(trace, ",\"args\":{\"open\":true}}"), 1u);
+    EXPECT_NE(trace.find("{\"name\":\"open plugin\",\"ph\":\"X\",\"ts\":" + std::to_string(getStart(open))), std::string::npos);
+    EXPECT_NE(trace.find(",\"tid\":2,\"args\":{\"open\":true}}\n]"), std::string::npos);
+    EXPECT_EQ(getEnd(open), 0u);
+
+    // a phase that ends after the report is still booked
+    mProfiler.end(open);
+    EXPECT_NE(getEnd(open), 0u);
+    EXPECT_EQ(getRunningPhases(), 0u);
+}
+
+TEST_F(CAmStartupProfilerTest, deadlineNotNeeded)
+{
+    CAmSocketHandler socketHandler;
+    mProfiler.step("startup");
+    uint32_t phase = mProfiler.begin("plugin");
+    mProfiler.ready(&socketHandler, 100);
+    EXPECT_TRUE(hasDeadline());
+
+    sh_timerHandle_t handle;
+    socketHandler.addTimer(timespec{0, 10000000}, [&](const sh_timerHandle_t, void *) {
+        mProfiler.end(phase);
+        EXPECT_FALSE(hasDeadline());
+    }, handle, NULL);
+    sh_timerHandle_t stopHandle;
+    socketHandler.addTimer(timespec{0, 300000000}, [&](const sh_timerHandle_t, void *) {
+        socketHandler.stop_listening();
+    }, stopHandle, NULL);
+    socketHandler.start_listenting();
+
+    EXPECT_TRUE(isReported());
+    EXPECT_EQ(readTrace().find("open"), std::string::npos);
+}
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,58 @@
+/**
+ * SPDX license identifier: MPL-2.0
+ *
+ * Copyright (C) 2012, BMW AG
+ *
+ * This file is part of GENIVI Project AudioManager.
+ *
+ * Contributions are licensed to the GENIVI Alliance under one or more
+ * Contribution License Agreements.
+ *
+ * \copyright
+ * This Source Code Form is subject to the terms of the
+ * Mozilla Public License, v. 2.0. If a  copy of the MPL was not distributed with
+ * this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ *
+ * For further information see http://www.genivi.org/.
+ *
+ */
+
+#ifndef STARTUPPROFILERTEST_H_
+#define STARTUPPROFILERTEST_H_
+
+#include "gtest/gtest.h"
+#include <string>
+#include "CAmStartupProfiler.h"
+
+namespace am
+{
+
+    /**
+     * owns a profiler of its own, the instance of the daemon keeps its phases. It is a friend of the profiler and
+     * gives the tests access to the bookkeeping.
+     */
+    class CAmStartupProfilerTest: public ::testing::Test
+    {
+    public:
+        CAmStartupProfilerTest();
+        ~CAmStartupProfilerTest();
+        CAmStartupProfiler mProfiler;
+        std::string mTraceFile;
+        void SetUp();
+        void TearDown();
+
+        size_t getNumPhases() const;
+        std::string getName(const uint32_t phase) const;
+        uint64_t getStart(const uint32_t phase) const;
+        uint64_t getEnd(const uint32_t phase) const;
+        bool isStep(const uint32_t phase) const;
+        uint32_t getRunningPhases() const;
+        bool isReported() const;
+        bool hasDeadline() const;
+        std::string readTrace() const;
+    };
+
+}
+
+#endif /* STARTUPPROFILERTEST_H_ */
@@ -0,0 +1,49 @@
+/**
+ * SPDX license identifier: MPL-2.0
+ *
+ * Copyright (C) 2026, BMW AG
+ *
+ * This file is part of GENIVI Project AudioManager.
+ *
+ * Contributions are licensed to the GENIVI Alliance under one or more
+ * Contribution License Agreements.
+ *
+ * \copyright
+ * This Source Code Form is subject to the terms of the
+ * Mozilla Public License, v. 2.0. If a  copy of the MPL was not distributed with
+ * this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ *
+ * \file CAmAllocationCounter.cpp
+ *
+ * For further information see http://www.genivi.org/.
+ *
+ */
+
+#include "CAmAllocationCounter.h"
+#include <cstdlib>
+#include <new>
+
+std::atomic<uint64_t> am::gAllocationCount(0);
+
+void *operator new(std::size_t size)
+{
+    ++am::gAllocationCount;
+    void *p = malloc(size ? size : 1);
+    if (!p)
+    {
+        throw std::bad_alloc();
+    }
+
+    return p;
+}
+
+void operator delete(void *p) noexcept
+{
+    free(p);
+}
+
+void operator delete(void *p, std::size_t) noexcept
+{
+    free(p);
+}
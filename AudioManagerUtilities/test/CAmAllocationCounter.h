@@ -0,0 +1,40 @@
+/**
+ * SPDX license identifier: MPL-2.0
+ *
+ * Copyright (C) 2026, BMW AG
+ *
+ * This file is part of GENIVI Project AudioManager.
+ *
+ * Contributions are licensed to the GENIVI Alliance under one or more
+ * Contribution License Agreements.
+ *
+ * \copyright
+ * This Source Code Form is subject to the terms of the
+ * Mozilla Public License, v. 2.0. If a  copy of the MPL was not distributed with
+ * this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ *
+ * \file CAmAllocationCounter.h
+ *
+ * For further information see http://www.genivi.org/.
+ *
+ */
+
+#ifndef CAMALLOCATIONCOUNTER_H_
+#define CAMALLOCATIONCOUNTER_H_
+
+#include <atomic>
+#include <stdint.h>
+
+namespace am
+{
+
+/**
+ * counts all global allocations of a test binary that links CAmAllocationCounter.cpp, which replaces the
+ * global operator new. Used to check that a code path does not need the heap.
+ */
+extern std::atomic<uint64_t> gAllocationCount;
+
+}
+
+#endif /* CAMALLOCATIONCOUNTER_H_ */
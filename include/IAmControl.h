@@ -32,7 +32,7 @@ class CAmSocketHandler;
 
 #include "audiomanagertypes.h"
 
-#define ControlVersion "5.1"
+#define ControlVersion "5.2"
 namespace am {
 
 /**
@@ -971,6 +971,15 @@ public:
 	 * This hook is fired whenever the timing information of a connection has changed.
 	 */
 	virtual void hookSystemSingleTimingInformationChanged(const am_connectionID_t connectionID, const am_timeSync_t time) =0;
+	/**
+	 * The routing plugin did not acknowledge the action of the handle within the handle timeout. The action was aborted
+	 * and the handle was removed. An acknowledge that the plugin sends later is dropped.
+	 * Not pure, so controllers that do not care keep compiling.
+	 */
+	virtual void cbHandleTimeout(const am_Handle_s handle)
+	{
+		(void)handle;
+	}
 
 
 };